@@ -101,7 +101,19 @@ cbuffer BufferObject : register(b3)
     matrix g_object_transform;
     matrix g_object_wvp_current;
     matrix g_object_wvp_previous;
+
+    uint g_object_instance_offset;
+    float3 g_object_padding;
+};
+
+// High frequency - Updates per instanced draw, indexed by g_object_instance_offset + SV_InstanceID
+struct Instance
+{
+    matrix transform;
+    matrix wvp_current;
+    matrix wvp_previous;
 };
+StructuredBuffer<Instance> g_instances : register(t34);
 
 // High frequency - Updates per light
 cbuffer LightBuffer : register(b4)
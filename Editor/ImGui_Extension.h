@@ -33,6 +33,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Threading/Threading.h"
 #include "Input/Input.h"
 #include "World/World.h"
+#include "World/WorldPartition.h"
 #include "World/Components/Camera.h"
 #include <chrono>
 #include "Window.h"
@@ -64,7 +65,7 @@ public:
         auto resource_cache = g_resource_cache;
 
         // Load the model asynchronously
-        g_threading->AddTask([resource_cache, file_path]()
+        g_threading->AddTaskIo([resource_cache, file_path]()
         {
             resource_cache->Load<Spartan::Model>(file_path);
         });
@@ -72,27 +73,23 @@ public:
 
     void LoadWorld(const std::string& file_path) const
     {
-        auto world = g_world;
-
         // Loading a world resets everything so it's important to ensure that no tasks are running
         g_threading->Flush(true);
 
-        // Load the scene asynchronously
-        g_threading->AddTask([world, file_path]()
-        {
-            world->LoadFromFile(file_path);
-        });
+        // Load the scene asynchronously, it completes in the background
+        g_world->LoadFromFileAsync(file_path);
     }
 
     void SaveWorld(const std::string& file_path) const
     {
-        auto world = g_world;
+        // The world takes a snapshot and writes it asynchronously
+        g_world->SaveToFile(file_path);
+    }
 
-        // Save the scene asynchronously
-        g_threading->AddTask([world, file_path]()
-        {
-            world->SaveToFile(file_path);
-        });
+    void SaveWorldPartitioned(const std::string& file_path) const
+    {
+        // The roots are moved into cells next to the world file, and streamed around the camera from then on
+        g_world->SaveToFilePartitioned(file_path, g_world->GetPartition()->GetCellSize());
     }
 
     void PickEntity()
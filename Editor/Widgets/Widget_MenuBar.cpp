@@ -35,6 +35,7 @@ namespace _Widget_MenuBar
 {
     static bool g_showAboutWindow    = false;
     static bool g_fileDialogVisible    = false;
+    static bool g_save_partitioned      = false;
     static bool imgui_metrics        = false;
     static bool imgui_style            = false;
     static bool imgui_demo            = false;
@@ -75,12 +76,22 @@ void Widget_MenuBar::Tick()
             {
                 m_fileDialog->SetOperation(FileDialog_Op_Save);
                 _Widget_MenuBar::g_fileDialogVisible = true;
+                _Widget_MenuBar::g_save_partitioned  = false;
             }
 
             if (ImGui::MenuItem("Save As..."))
             {
                 m_fileDialog->SetOperation(FileDialog_Op_Save);
                 _Widget_MenuBar::g_fileDialogVisible = true;
+                _Widget_MenuBar::g_save_partitioned  = false;
+            }
+
+            // Moves the roots into cells which are streamed around the camera, a partitioned world can't be partitioned again
+            if (ImGui::MenuItem("Save Partitioned...", nullptr, false, !_Widget_MenuBar::world->GetPartition()->IsEnabled()))
+            {
+                m_fileDialog->SetOperation(FileDialog_Op_Save);
+                _Widget_MenuBar::g_fileDialogVisible = true;
+                _Widget_MenuBar::g_save_partitioned  = true;
             }
 
             ImGui::EndMenu();
@@ -136,7 +147,14 @@ void Widget_MenuBar::ShowFileDialog() const
             // Scene
             if (m_fileDialog->GetFilter() == FileDialog_Filter_Scene)
             {
-                EditorHelper::Get().SaveWorld(_Widget_MenuBar::g_fileDialogSelection);
+                if (_Widget_MenuBar::g_save_partitioned)
+                {
+                    EditorHelper::Get().SaveWorldPartitioned(_Widget_MenuBar::g_fileDialogSelection);
+                }
+                else
+                {
+                    EditorHelper::Get().SaveWorld(_Widget_MenuBar::g_fileDialogSelection);
+                }
                 _Widget_MenuBar::g_fileDialogVisible = false;
             }
         }
@@ -89,10 +89,7 @@ namespace ComponentProperty
 
             if (ImGui::MenuItem("Paste Attributes"))
             {
-                if (g_copied && g_copied->GetType() == component->GetType())
-                {
-                    component->SetAttributes(g_copied->GetAttributes());
-                }
+                component->CopyAttributes(g_copied);
             }
 
             ImGui::EndPopup();
@@ -808,6 +805,10 @@ void Widget_Properties::ShowMaterial(Material* material) const
                         {
                             ImGui::PushID(static_cast<int>(ImGui::GetCursorPosX() + ImGui::GetCursorPosY()));
                             ImGuiEx::DragFloatWrap("", &material->GetProperty(type), 0.004f, 0.0f, 1.0f);
+                            if (ImGui::IsItemEdited())
+                            {
+                                material->MakeDirty();
+                            }
                             ImGui::PopID();
                         }
                     }
@@ -172,10 +172,10 @@ const Thumbnail& IconProvider::Thumbnail_Load(const string& file_path, Icon_Type
         texture->SetHeight(size);
 
         // Load it asynchronously
-        m_context->GetSubsystem<Threading>()->AddTask([texture, file_path]()
+        m_context->GetSubsystem<Threading>()->AddTaskIo([texture, file_path]()
         {
             texture->LoadFromFile(file_path);
-        });
+        }, TaskPriority::Background);
 
         m_thumbnails.emplace_back(type, texture, file_path);
         return m_thumbnails.back();
@@ -43,7 +43,7 @@ namespace Spartan
     Audio::~Audio()
     {
         // Unsubscribe from events
-        UNSUBSCRIBE_FROM_EVENT(EventType::WorldUnload, [this](Variant) { m_listener = nullptr; });
+        UNSUBSCRIBE_FROM_EVENT(m_event_world_unload);
 
         if (!m_system_fmod)
             return;
@@ -128,7 +128,7 @@ namespace Spartan
         m_profiler = m_context->GetSubsystem<Profiler>();
 
         // Subscribe to events
-        SUBSCRIBE_TO_EVENT(EventType::WorldUnload, [this](Variant) { m_listener = nullptr; });
+        m_event_world_unload = SUBSCRIBE_TO_EVENT(EventType::WorldUnload, [this](const EventData&) { m_listener = false; });
    
         return true;
     }
@@ -154,10 +154,10 @@ namespace Spartan
 
         if (m_listener)
         {
-            auto position = m_listener->GetPosition();
+            auto position = m_listener_position;
             auto velocity = Math::Vector3::Zero;
-            auto forward = m_listener->GetForward();
-            auto up = m_listener->GetUp();
+            auto forward = m_listener_forward;
+            auto up = m_listener_up;
 
             // Set 3D attributes
             m_result_fmod = m_system_fmod->set3DListenerAttributes(
@@ -175,9 +175,15 @@ namespace Spartan
         }
     }
 
-    void Audio::SetListenerTransform(Transform* transform)
+    void Audio::SetListenerTransform(const Transform* transform)
     {
-        m_listener = transform;
+        m_listener = transform != nullptr;
+        if (!m_listener)
+            return;
+
+        m_listener_position = transform->GetPosition();
+        m_listener_forward  = transform->GetForward();
+        m_listener_up       = transform->GetUp();
     }
 
     void Audio::LogErrorFmod(int error) const
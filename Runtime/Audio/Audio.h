@@ -21,9 +21,11 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #pragma once
 
-//= INCLUDES ==================
+//= INCLUDES ===================
 #include "../Core/ISubsystem.h"
-//=============================
+#include "../Core/EventSystem.h"
+#include "../Math/Vector3.h"
+//==============================
 
 //= FORWARD DECLARATIONS =
 namespace FMOD
@@ -49,7 +51,9 @@ namespace Spartan
         //===================================
 
         auto GetSystemFMOD() const { return m_system_fmod; }
-        void SetListenerTransform(Transform* transform);
+
+        // Copies the listener's pose, so that ticking doesn't read the transform while physics moves it
+        void SetListenerTransform(const Transform* transform);
 
     private:
         void LogErrorFmod(int error) const;
@@ -58,8 +62,12 @@ namespace Spartan
         uint32_t m_max_channels        = 32;
         float m_distance_entity        = 1.0f;
         bool m_initialized            = false;
-        Transform* m_listener        = nullptr;
+        bool m_listener                = false;
+        Math::Vector3 m_listener_position;
+        Math::Vector3 m_listener_forward;
+        Math::Vector3 m_listener_up;
         Profiler* m_profiler        = nullptr;
         FMOD::System* m_system_fmod = nullptr;
+        EventHandle m_event_world_unload;
     };
 }
@@ -102,6 +102,15 @@ namespace Spartan
         return true;
     }
 
+    bool AudioClip::SaveToMemory(string* data)
+    {
+        FileStream file("", FileStream_Memory | FileStream_Write);
+        file.Write(GetResourceFilePath());
+        *data = file.GetMemory();
+
+        return true;
+    }
+
     bool AudioClip::Play()
     {
         // Check if the sound is playing
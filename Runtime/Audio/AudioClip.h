@@ -60,6 +60,7 @@ namespace Spartan
         //= IResource ===========================================
         bool LoadFromFile(const std::string& file_path) override;
         bool SaveToFile(const std::string& file_path) override;
+        bool SaveToMemory(std::string* data) override;
         //=======================================================
 
         bool Play();
@@ -0,0 +1,199 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ====================
+#include "Spartan.h"
+#include "../Threading/Threading.h"
+//===============================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Spartan
+{
+    bool Context::Initialize()
+    {
+        auto result = true;
+        for (const auto& subsystem : m_subsystems)
+        {
+            if (!subsystem.ptr->Initialize())
+            {
+                LOG_ERROR("Failed to initialize %s", subsystem.name.c_str());
+                result = false;
+            }
+        }
+
+        m_threading = GetSubsystem<Threading>();
+        BuildTickGraph();
+
+        return result;
+    }
+
+    void Context::Tick(const float delta_time, const float delta_time_smoothed)
+    {
+        if (m_tick_graph_dirty)
+        {
+            BuildTickGraph();
+        }
+
+        TickGraph& graph = m_tick_graph;
+        const uint32_t node_count = static_cast<uint32_t>(graph.nodes.size());
+        if (node_count == 0)
+            return;
+
+        // Reset
+        graph.delta_time[static_cast<uint32_t>(TickType::Variable)] = delta_time;
+        graph.delta_time[static_cast<uint32_t>(TickType::Smoothed)] = delta_time_smoothed;
+        graph.nodes_pending.store(node_count, memory_order_relaxed);
+        for (uint32_t i = 0; i < node_count; i++)
+        {
+            graph.dependencies_pending[i].store(graph.nodes[i].dependency_count, memory_order_relaxed);
+        }
+
+        // Kick off the subsystems which don't depend on anything
+        for (uint32_t i = 0; i < node_count; i++)
+        {
+            if (graph.nodes[i].dependency_count == 0)
+            {
+                TickNodeReady(graph, i);
+            }
+        }
+
+        // Tick main thread subsystems as they become ready, until the whole graph is done
+        while (true)
+        {
+            unique_lock<mutex> lock(m_tick_mutex);
+            m_tick_condition_var.wait(lock, [&graph] { return !graph.ready_main_thread.empty() || graph.nodes_pending.load(memory_order_acquire) == 0; });
+
+            if (graph.ready_main_thread.empty())
+                break;
+
+            // Pick the earliest registered one, so that the order is deterministic
+            auto it = min_element(graph.ready_main_thread.begin(), graph.ready_main_thread.end());
+            const uint32_t node_index = *it;
+            graph.ready_main_thread.erase(it);
+            lock.unlock();
+
+            TickNodeExecute(graph, node_index);
+        }
+
+        // Publish timings
+        for (const TickNode& node : graph.nodes)
+        {
+            m_tick_times[node.subsystem_index].time_ms = node.time_ms;
+        }
+    }
+
+    void Context::BuildTickGraph()
+    {
+        const uint32_t subsystem_count  = static_cast<uint32_t>(m_subsystems.size());
+        const bool can_run_concurrently = m_threading && m_threading->GetThreadCount() != 0;
+
+        m_tick_times.resize(subsystem_count);
+        for (uint32_t i = 0; i < subsystem_count; i++)
+        {
+            m_tick_times[i].name = m_subsystems[i].name.c_str();
+        }
+
+        TickGraph& graph = m_tick_graph;
+        graph.nodes.clear();
+        graph.ready_main_thread.clear();
+
+        for (uint32_t i = 0; i < subsystem_count; i++)
+        {
+            const _subystem& subsystem = m_subsystems[i];
+
+            TickNode node;
+            node.subsystem_index    = i;
+            node.tick_group         = subsystem.tick_group;
+            node.main_thread        = subsystem.tick_access.main_thread || !can_run_concurrently;
+            const uint32_t node_index = static_cast<uint32_t>(graph.nodes.size());
+
+            // Depend on any earlier subsystem which writes what we read, or reads/writes what we write
+            for (uint32_t j = 0; j < node_index; j++)
+            {
+                const TickAccess& access_previous = m_subsystems[graph.nodes[j].subsystem_index].tick_access;
+                const TickAccess& access_current  = subsystem.tick_access;
+
+                const bool conflict =
+                    (access_current.reads  & access_previous.writes) ||
+                    (access_current.writes & access_previous.writes) ||
+                    (access_current.writes & access_previous.reads);
+
+                if (conflict)
+                {
+                    graph.nodes[j].dependents.emplace_back(node_index);
+                    node.dependency_count++;
+                }
+            }
+
+            graph.nodes.emplace_back(node);
+        }
+
+        graph.dependencies_pending = vector<atomic<uint32_t>>(graph.nodes.size());
+        graph.ready_main_thread.reserve(graph.nodes.size());
+
+        m_tick_graph_dirty = false;
+    }
+
+    void Context::TickNodeReady(TickGraph& graph, const uint32_t node_index)
+    {
+        if (graph.nodes[node_index].main_thread)
+        {
+            {
+                lock_guard<mutex> lock(m_tick_mutex);
+                graph.ready_main_thread.emplace_back(node_index);
+            }
+            m_tick_condition_var.notify_one();
+        }
+        else
+        {
+            // The frame waits on these, so they go ahead of any resource loads queued on the compute pool
+            m_threading->AddTask([this, &graph, node_index]() { TickNodeExecute(graph, node_index); }, TaskPriority::Critical);
+        }
+    }
+
+    void Context::TickNodeExecute(TickGraph& graph, const uint32_t node_index)
+    {
+        TickNode& node = graph.nodes[node_index];
+
+        const Stopwatch timer;
+        m_subsystems[node.subsystem_index].ptr->Tick(graph.delta_time[static_cast<uint32_t>(node.tick_group)]);
+        node.time_ms = timer.GetElapsedTimeMs();
+
+        // Release any dependents
+        for (const uint32_t dependent : node.dependents)
+        {
+            if (graph.dependencies_pending[dependent].fetch_sub(1, memory_order_acq_rel) == 1)
+            {
+                TickNodeReady(graph, dependent);
+            }
+        }
+
+        // Wake up the main thread if this was the last one
+        if (graph.nodes_pending.fetch_sub(1, memory_order_acq_rel) == 1)
+        {
+            lock_guard<mutex> lock(m_tick_mutex);
+            m_tick_condition_var.notify_one();
+        }
+    }
+}
@@ -22,6 +22,11 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #pragma once
 
 //= INCLUDES ===================
+#include <vector>
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
 #include "ISubsystem.h"
 #include "../Logging/Log.h"
 #include "Spartan_Definitions.h"
@@ -30,6 +35,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 namespace Spartan
 {
     class Engine;
+    class Threading;
 
     enum class TickType
     {
@@ -37,16 +43,54 @@ namespace Spartan
         Smoothed
     };
 
+    // The data that subsystems touch while ticking
+    enum Tick_Resource : uint32_t
+    {
+        Tick_None       = 0,
+        Tick_Time       = 1UL << 0,
+        Tick_Resources  = 1UL << 1,
+        Tick_Audio      = 1UL << 2,
+        Tick_Physics    = 1UL << 3,
+        Tick_Input      = 1UL << 4,
+        Tick_Scripting  = 1UL << 5,
+        Tick_World      = 1UL << 6,    // Entities, components and transforms
+        Tick_Renderer   = 1UL << 7,
+        Tick_DebugDraw  = 1UL << 8,    // Debug lines that get submitted to the renderer
+        Tick_Gpu        = 1UL << 9,    // The rhi device and it's immediate context
+        Tick_Profiler   = 1UL << 10,
+        Tick_Settings   = 1UL << 11,
+        Tick_All        = 0xFFFFFFFF
+    };
+
+    // What a subsystem reads and writes while ticking. Subsystems which don't conflict can tick
+    // concurrently, if they do conflict they tick in registration order.
+    struct TickAccess
+    {
+        uint32_t reads      = Tick_All;
+        uint32_t writes     = Tick_All;
+        bool main_thread    = true; // thread affinity, e.g. window messages, mono or the gpu's immediate context
+    };
+
     struct _subystem
     {
-        _subystem(const std::shared_ptr<ISubsystem>& subsystem, TickType tick_group)
+        _subystem(const std::shared_ptr<ISubsystem>& subsystem, TickType tick_group, const TickAccess& tick_access, const std::string& name)
         {
-            ptr = subsystem;
-            this->tick_group = tick_group;
+            ptr                 = subsystem;
+            this->tick_group    = tick_group;
+            this->tick_access   = tick_access;
+            this->name          = name;
         }
 
         std::shared_ptr<ISubsystem> ptr;
         TickType tick_group;
+        TickAccess tick_access;
+        std::string name;
+    };
+
+    struct SubsystemTickTime
+    {
+        const char* name    = nullptr;
+        float time_ms       = 0.0f;
     };
 
     class SPARTAN_CLASS Context
@@ -65,42 +109,22 @@ namespace Spartan
             m_subsystems.clear();
         }
 
-        // Register a subsystem
+        // Register a subsystem, the name is what errors and the profiler refer to it as
         template <class T>
-        void RegisterSubsystem(TickType tick_group = TickType::Variable)
+        void RegisterSubsystem(const char* name, TickType tick_group = TickType::Variable, const TickAccess& tick_access = TickAccess())
         {
             validate_subsystem_type<T>();
 
-            m_subsystems.emplace_back(std::make_shared<T>(this), tick_group);
+            m_subsystems.emplace_back(std::make_shared<T>(this), tick_group, tick_access, name);
+            m_tick_graph_dirty = true;
         }
 
         // Initialize subsystems
-        bool Initialize()
-        {
-            auto result = true;
-            for (const auto& subsystem : m_subsystems)
-            {
-                if (!subsystem.ptr->Initialize())
-                {
-                    LOG_ERROR("Failed to initialize %s", typeid(*subsystem.ptr).name());
-                    result = false;
-                }
-            }
+        bool Initialize();
 
-            return result;
-        }
-
-        // Tick
-        void Tick(TickType tick_group, float delta_time = 0.0f)
-        {
-            for (const auto& subsystem : m_subsystems)
-            {
-                if (subsystem.tick_group != tick_group)
-                    continue;
-
-                subsystem.ptr->Tick(delta_time);
-            }
-        }
+        // Ticks all the subsystems, the ones which don't depend on each other tick concurrently.
+        // Each subsystem gets the delta time of it's tick group.
+        void Tick(float delta_time, float delta_time_smoothed);
 
         // Get a subsystem
         template <class T> 
@@ -120,9 +144,44 @@ namespace Spartan
             return nullptr;
         }
 
+        // How long each subsystem took to tick during the last frame (main thread only)
+        const auto& GetSubsystemTickTimes() const { return m_tick_times; }
+
         Engine* m_engine = nullptr;
 
     private:
+        // A subsystem's node in the tick graph
+        struct TickNode
+        {
+            uint32_t subsystem_index    = 0;
+            uint32_t dependency_count   = 0;
+            TickType tick_group         = TickType::Variable;
+            bool main_thread            = true;
+            float time_ms               = 0.0f;
+            std::vector<uint32_t> dependents;
+        };
+
+        struct TickGraph
+        {
+            std::vector<TickNode> nodes;
+            std::vector<std::atomic<uint32_t>> dependencies_pending;
+            std::vector<uint32_t> ready_main_thread;
+            std::atomic<uint32_t> nodes_pending = 0;
+            float delta_time[2]                 = { 0.0f, 0.0f };
+        };
+
+        void BuildTickGraph();
+        void TickNodeReady(TickGraph& graph, uint32_t node_index);
+        void TickNodeExecute(TickGraph& graph, uint32_t node_index);
+
         std::vector<_subystem> m_subsystems;
+
+        // Tick graph, both tick groups go in the same one so that they can overlap
+        TickGraph m_tick_graph;
+        bool m_tick_graph_dirty = true;
+        std::mutex m_tick_mutex;
+        std::condition_variable m_tick_condition_var;
+        std::vector<SubsystemTickTime> m_tick_times;
+        Threading* m_threading = nullptr;
     };
 }
@@ -52,18 +52,18 @@ namespace Spartan
         m_context = make_shared<Context>();
         m_context->m_engine = this;
 
-        // Register subsystems
-        m_context->RegisterSubsystem<Timer>(TickType::Variable);         // must be first so it ticks first
-        m_context->RegisterSubsystem<Threading>(TickType::Variable);
-        m_context->RegisterSubsystem<ResourceCache>(TickType::Variable);
-        m_context->RegisterSubsystem<Audio>(TickType::Variable);
-        m_context->RegisterSubsystem<Physics>(TickType::Variable);       // integrates internally
-        m_context->RegisterSubsystem<Input>(TickType::Smoothed);
-        m_context->RegisterSubsystem<Scripting>(TickType::Smoothed);
-        m_context->RegisterSubsystem<World>(TickType::Smoothed);
-        m_context->RegisterSubsystem<Profiler>(TickType::Variable);
-        m_context->RegisterSubsystem<Renderer>(TickType::Smoothed);
-        m_context->RegisterSubsystem<Settings>(TickType::Variable);
+        // Register subsystems, along with what they read and write while ticking (so that independent ones can tick concurrently)
+        m_context->RegisterSubsystem<Timer>("Timer",                 TickType::Variable, { Tick_None, Tick_Time });                                                                   // must be first so it ticks first
+        m_context->RegisterSubsystem<Threading>("Threading",         TickType::Variable, { Tick_None, Tick_None });
+        m_context->RegisterSubsystem<ResourceCache>("ResourceCache", TickType::Variable, { Tick_None, Tick_Resources });
+        m_context->RegisterSubsystem<Audio>("Audio",                 TickType::Variable, { Tick_None, Tick_Audio, false });                                                          // uses the listener pose which the world hands it, not the transform
+        m_context->RegisterSubsystem<Physics>("Physics",             TickType::Variable, { Tick_Renderer, Tick_Physics | Tick_World | Tick_DebugDraw, false });                      // integrates internally
+        m_context->RegisterSubsystem<Input>("Input",                 TickType::Smoothed, { Tick_None, Tick_Input });
+        m_context->RegisterSubsystem<Scripting>("Scripting",         TickType::Smoothed, { Tick_Input, Tick_Scripting | Tick_World });
+        m_context->RegisterSubsystem<World>("World",                 TickType::Smoothed, { Tick_Input | Tick_Resources, Tick_World | Tick_Audio | Tick_Physics | Tick_Renderer });
+        m_context->RegisterSubsystem<Profiler>("Profiler",           TickType::Variable, { Tick_Time | Tick_Renderer | Tick_Gpu | Tick_Resources, Tick_Profiler });
+        m_context->RegisterSubsystem<Renderer>("Renderer",           TickType::Smoothed, { Tick_Time | Tick_World | Tick_DebugDraw, Tick_Renderer | Tick_Gpu | Tick_Profiler });
+        m_context->RegisterSubsystem<Settings>("Settings",           TickType::Variable, { Tick_None, Tick_Settings });
                  
         // Initialize above subsystems
         m_context->Initialize();
@@ -78,8 +78,10 @@ namespace Spartan
 
     void Engine::Tick() const
     {
-        m_context->Tick(TickType::Variable, static_cast<float>(m_timer->GetDeltaTimeSec()));
-        m_context->Tick(TickType::Smoothed, static_cast<float>(m_timer->GetDeltaTimeSmoothedSec()));
+        // Sync point for events which were queued during the previous frame (from any thread)
+        EventSystem::Get().DispatchQueued();
+
+        m_context->Tick(static_cast<float>(m_timer->GetDeltaTimeSec()), static_cast<float>(m_timer->GetDeltaTimeSmoothedSec()));
     }
 
     void Engine::SetWindowData(WindowData& window_data)
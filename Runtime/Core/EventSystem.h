@@ -21,22 +21,35 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #pragma once
 
-//= INCLUDES ===============
+//= INCLUDES ===================
 #include <unordered_map>
 #include <vector>
+#include <deque>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
 #include <functional>
-#include "../Core/Variant.h"
-//==========================
+#include <typeinfo>
+#include <type_traits>
+#include "Spartan_Definitions.h"
+//==============================
 
 /*
 HOW TO USE
 =================================================================================
-To subscribe a function to an event        -> SUBSCRIBE_TO_EVENT(EVENT_ID, Handler);
-To unsubscribe a function from an event    -> SUBSCRIBE_TO_EVENT(EVENT_ID, Handler);
-To fire an event                        -> FIRE_EVENT(EVENT_ID);
-To fire an event with data                -> FIRE_EVENT_DATA(EVENT_ID, Variant);
+To subscribe a function to an event            -> handle = SUBSCRIBE_TO_EVENT(EVENT_ID, Handler);
+To unsubscribe a function from an event        -> UNSUBSCRIBE_FROM_EVENT(handle);
+To fire an event                            -> FIRE_EVENT(EVENT_ID);
+To fire an event with data                    -> FIRE_EVENT_DATA(EVENT_ID, data);
+To queue an event                            -> QUEUE_EVENT(EVENT_ID);
+To queue an event with data                    -> QUEUE_EVENT_DATA(EVENT_ID, data);
 
-Note: Currently, this is a blocking event system
+Note: Fired events are dispatched immediately, on the calling thread, and their data is passed by reference.
+Queued events are dispatched on the main thread, before the engine ticks, and their data (an rvalue) is moved into the queue.
+Both are thread safe, subscribers are called without any lock held so they can fire, subscribe and unsubscribe.
+Once unsubscribing returns, the function is not running on any other thread and it won't be called again.
 =================================================================================
 */
 
@@ -44,8 +57,8 @@ enum class EventType
 {
     FrameEnd,                // A frame ends
     WindowData,             // The window has a message for processing
-    WorldSave,                // The world must be saved to file
-    WorldSaved,                // The world finished saving to file
+    WorldSave,                // The world is being saved, the data is the WorldSnapshot* to add files to
+    WorldSaved,                // The world finished saving to file, the data is true if it was written
     WorldLoad,                // The world must be loaded from file
     WorldLoaded,            // The world finished loading from file
     WorldUnload,            // The world should clear everything
@@ -57,25 +70,82 @@ enum class EventType
 };
 
 //= MACROS ====================================================================================================
-#define EVENT_HANDLER_EXPRESSION(expression)        [this](const Spartan::Variant& var)    { ##expression }
-#define EVENT_HANDLER_EXPRESSION_STATIC(expression)    [](const Spartan::Variant& var)        { ##expression }
+#define EVENT_HANDLER_EXPRESSION(expression)        [this](const Spartan::EventData& data)    { ##expression }
+#define EVENT_HANDLER_EXPRESSION_STATIC(expression)    [](const Spartan::EventData& data)        { ##expression }
 
-#define EVENT_HANDLER(function)                        [this](const Spartan::Variant& var)    { function(); }
-#define EVENT_HANDLER_STATIC(function)                [](const Spartan::Variant& var)        { function(); }
+#define EVENT_HANDLER(function)                        [this](const Spartan::EventData& data)    { function(); }
+#define EVENT_HANDLER_STATIC(function)                [](const Spartan::EventData& data)        { function(); }
 
-#define EVENT_HANDLER_VARIANT(function)                [this](const Spartan::Variant& var)    { function(var); }
-#define EVENT_HANDLER_VARIANT_STATIC(function)        [](const Spartan::Variant& var)        { function(var); }
+#define EVENT_HANDLER_DATA(function)                [this](const Spartan::EventData& data)    { function(data); }
+#define EVENT_HANDLER_DATA_STATIC(function)            [](const Spartan::EventData& data)        { function(data); }
 
 #define FIRE_EVENT(eventID)                            Spartan::EventSystem::Get().Fire(eventID)
 #define FIRE_EVENT_DATA(eventID, data)                Spartan::EventSystem::Get().Fire(eventID, data)
 
-#define SUBSCRIBE_TO_EVENT(eventID, function)        Spartan::EventSystem::Get().Subscribe(eventID, function);
-#define UNSUBSCRIBE_FROM_EVENT(eventID, function)    Spartan::EventSystem::Get().Unsubscribe(eventID, function);
+#define QUEUE_EVENT(eventID)                        Spartan::EventSystem::Get().Queue(eventID)
+#define QUEUE_EVENT_DATA(eventID, data)                Spartan::EventSystem::Get().Queue(eventID, data)
+
+#define SUBSCRIBE_TO_EVENT(eventID, function)        Spartan::EventSystem::Get().Subscribe(eventID, function)
+#define UNSUBSCRIBE_FROM_EVENT(handle)                Spartan::EventSystem::Get().Unsubscribe(handle)
 //=============================================================================================================
 
 namespace Spartan
 {
-    using subscriber = std::function<void(const Variant&)>;
+    // The payload of an event, it either references the fired data or owns the queued data, it never copies it
+    class EventData
+    {
+    public:
+        EventData() = default;
+
+        template <typename T>
+        static EventData Reference(const T& value)
+        {
+            EventData data;
+            data.m_data = &value;
+            data.m_type = &typeid(T);
+            return data;
+        }
+
+        template <typename T>
+        static EventData Own(T&& value)
+        {
+            using value_type = std::decay_t<T>;
+
+            EventData data;
+            data.m_owned    = std::make_shared<value_type>(std::forward<T>(value));
+            data.m_data     = data.m_owned.get();
+            data.m_type     = &typeid(value_type);
+            return data;
+        }
+
+        template <typename T>
+        const T& Get() const
+        {
+            if (!m_type || *m_type != typeid(T))
+                throw std::bad_cast();
+
+            return *static_cast<const T*>(m_data);
+        }
+
+        bool IsEmpty() const { return m_data == nullptr; }
+
+    private:
+        const void* m_data              = nullptr;
+        const std::type_info* m_type    = nullptr;
+        std::shared_ptr<void> m_owned;
+    };
+
+    // Identifies a subscription, so that it can be removed in constant time
+    struct EventHandle
+    {
+        EventType type  = EventType::FrameEnd;
+        uint32_t index  = 0;
+        uint64_t id     = 0; // unique per subscription, 0 means invalid
+
+        bool IsValid() const { return id != 0; }
+    };
+
+    using subscriber = std::function<void(const EventData&)>;
 
     class SPARTAN_CLASS EventSystem
     {
@@ -86,44 +156,198 @@ namespace Spartan
             return instance;
         }
 
-        void Subscribe(const EventType event_id, subscriber&& function)
+        EventHandle Subscribe(const EventType event_id, subscriber&& function)
         {
-            m_subscribers[event_id].push_back(std::forward<subscriber>(function));
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            Subscribers& subscribers = m_subscribers[event_id];
+
+            // Re-use a free slot, slots live in a deque so they never move
+            uint32_t index = static_cast<uint32_t>(subscribers.slots.size());
+            if (!subscribers.slots_free.empty())
+            {
+                index = subscribers.slots_free.back();
+                subscribers.slots_free.pop_back();
+            }
+            else
+            {
+                subscribers.slots.emplace_back();
+            }
+
+            Slot& slot          = subscribers.slots[index];
+            slot.id             = ++m_id;
+            slot.subscription   = std::make_shared<Subscription>(std::forward<subscriber>(function));
+
+            return { event_id, index, slot.id };
         }
 
-        void Unsubscribe(const EventType event_id, subscriber&& function)
+        void Unsubscribe(EventHandle& handle)
         {
-            const size_t function_adress    = *reinterpret_cast<long*>(reinterpret_cast<char*>(&function));
-            auto& subscribers                = m_subscribers[event_id];
+            if (!handle.IsValid())
+                return;
+
+            std::unique_lock<std::mutex> lock(m_mutex);
 
-            for (auto it = subscribers.begin(); it != subscribers.end();)
+            std::shared_ptr<Subscription> subscription;
+            auto it = m_subscribers.find(handle.type);
+            if (it != m_subscribers.end() && handle.index < it->second.slots.size())
             {
-                const size_t subscriber_adress = *reinterpret_cast<long*>(reinterpret_cast<char*>(&(*it)));
-                if (subscriber_adress == function_adress)
+                Slot& slot = it->second.slots[handle.index];
+                if (slot.id == handle.id)
                 {
-                    it = subscribers.erase(it);
-                    return;
+                    subscription = std::move(slot.subscription);
+                    slot.id      = 0;
+                    it->second.slots_free.emplace_back(handle.index);
                 }
             }
+
+            handle = EventHandle();
+
+            if (!subscription)
+                return;
+
+            // Dispatches which are in flight skip it from now on, wait for the ones which are already calling it.
+            // Calls made by this thread are excluded, a subscriber can unsubscribe itself (or another one) while being called.
+            subscription->unsubscribed = true;
+            const uint32_t calls_this_thread = static_cast<uint32_t>(std::count(GetDispatchBuffer().begin(), GetDispatchBuffer().end(), subscription));
+            m_condition_var.wait(lock, [&subscription, calls_this_thread] { return subscription->calls == calls_this_thread; });
         }
 
-        void Fire(const EventType event_id, const Variant& data = 0)
+        void Fire(const EventType event_id)
         {
-            if (m_subscribers.find(event_id) == m_subscribers.end())
-                return;
+            Dispatch(event_id, EventData());
+        }
 
-            for (const auto& subscriber : m_subscribers[event_id])
+        template <typename T>
+        void Fire(const EventType event_id, const T& data)
+        {
+            Dispatch(event_id, EventData::Reference(data));
+        }
+
+        void Queue(const EventType event_id)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex_queue);
+            m_queue.emplace_back(event_id, EventData());
+        }
+
+        template <typename T>
+        void Queue(const EventType event_id, T&& data)
+        {
+            static_assert(!std::is_lvalue_reference_v<T>, "Queued data is moved into the queue, pass an rvalue");
+
+            std::lock_guard<std::mutex> lock(m_mutex_queue);
+            m_queue.emplace_back(event_id, EventData::Own(std::forward<T>(data)));
+        }
+
+        // Dispatches the queued events, the engine calls it once per frame, on the main thread
+        void DispatchQueued()
+        {
+            // Events which get queued while dispatching will be dispatched next frame
             {
-                subscriber(data);
+                std::lock_guard<std::mutex> lock(m_mutex_queue);
+                m_queue.swap(m_queue_dispatching);
             }
+
+            for (const auto& event : m_queue_dispatching)
+            {
+                Dispatch(event.first, event.second);
+            }
+
+            m_queue_dispatching.clear();
         }
 
         void Clear() 
         {
-            m_subscribers.clear(); 
+            std::lock_guard<std::mutex> lock(m_mutex);
+            std::lock_guard<std::mutex> lock_queue(m_mutex_queue);
+
+            m_subscribers.clear();
+            m_queue.clear();
         }
 
     private:
-        std::unordered_map<EventType, std::vector<subscriber>> m_subscribers;
+        struct Subscription
+        {
+            Subscription(subscriber&& function) : function(std::move(function)) {}
+
+            subscriber function;
+            std::atomic<uint32_t> calls = 0;    // dispatches which are about to call it, or are calling it
+            std::atomic<bool> unsubscribed = false;
+        };
+
+        struct Slot
+        {
+            uint64_t id = 0;
+            std::shared_ptr<Subscription> subscription;
+        };
+
+        struct Subscribers
+        {
+            std::deque<Slot> slots;
+            std::vector<uint32_t> slots_free;
+        };
+
+        void Dispatch(const EventType event_id, const EventData& data)
+        {
+            // Grab the subscriptions and call them without the lock held. The buffer is per thread and dispatches can
+            // nest (a subscriber can fire), so each dispatch works on its own range at the end of it.
+            std::vector<std::shared_ptr<Subscription>>& buffer = GetDispatchBuffer();
+            const size_t start = buffer.size();
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+
+                auto it = m_subscribers.find(event_id);
+                if (it == m_subscribers.end())
+                    return;
+
+                for (const Slot& slot : it->second.slots)
+                {
+                    if (slot.subscription)
+                    {
+                        slot.subscription->calls++;
+                        buffer.emplace_back(slot.subscription);
+                    }
+                }
+            }
+
+            const size_t end = buffer.size();
+            for (size_t i = start; i < end; i++)
+            {
+                // Copied, as a nested dispatch can reallocate the buffer. The entry stays until the call returns,
+                // so that the subscriber can unsubscribe itself without waiting for itself.
+                const std::shared_ptr<Subscription> subscription = buffer[i];
+
+                if (!subscription->unsubscribed)
+                {
+                    subscription->function(data);
+                }
+                buffer[i] = nullptr;
+
+                // Wake up whoever is unsubscribing it
+                if (--subscription->calls == 0 && subscription->unsubscribed)
+                {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_condition_var.notify_all();
+                }
+            }
+
+            buffer.resize(start);
+        }
+
+        // The subscriptions which the dispatches of the calling thread are about to call, or are calling
+        static std::vector<std::shared_ptr<Subscription>>& GetDispatchBuffer()
+        {
+            thread_local std::vector<std::shared_ptr<Subscription>> buffer;
+            return buffer;
+        }
+
+        std::unordered_map<EventType, Subscribers> m_subscribers;
+        uint64_t m_id = 0;
+        std::mutex m_mutex;
+        std::condition_variable m_condition_var;
+
+        std::vector<std::pair<EventType, EventData>> m_queue;
+        std::vector<std::pair<EventType, EventData>> m_queue_dispatching;
+        std::mutex m_mutex_queue;
     };
 }
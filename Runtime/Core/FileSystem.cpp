@@ -320,6 +320,22 @@ namespace Spartan
         }
     }
 
+    // Replaces the destination (if it exists) in one step, so it's never seen partially written
+    bool FileSystem::Rename(const string& source, const string& destination)
+    {
+        try
+        {
+            filesystem::rename(source, destination);
+            return true;
+        }
+        catch (filesystem::filesystem_error& e)
+        {
+            LOG_WARNING("%s", e.what());
+        }
+
+        return false;
+    }
+
     string FileSystem::GetFileNameFromFilePath(const string& path)
     {
         return filesystem::path(path).filename().generic_string();
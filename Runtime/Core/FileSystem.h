@@ -55,6 +55,7 @@ namespace Spartan
         static bool IsDirectory(const std::string& path);
         static bool IsFile(const std::string& path);
         static bool CopyFileFromTo(const std::string& source, const std::string& destination);
+        static bool Rename(const std::string& source, const std::string& destination);
         static std::string GetFileNameFromFilePath(const std::string& path);
         static std::string GetFileNameNoExtensionFromFilePath(const std::string& path);
         static std::string GetDirectoryFromFilePath(const std::string& path);
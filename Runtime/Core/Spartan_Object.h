@@ -32,9 +32,6 @@ namespace Spartan
     class Context;
     //========================
 
-    // Globals
-    static uint32_t g_id = 0;
-
     class SPARTAN_CLASS Spartan_Object
     {
     public:
@@ -43,14 +40,16 @@ namespace Spartan
             m_context   = context;
             m_id        = GenerateId();
         }
+        virtual ~Spartan_Object() = default;
 
         // Name
         const std::string& GetName()    const { return m_name; }
 
         // Id
         const uint32_t GetId()          const { return m_id; }
-        void SetId(const uint32_t id)          { m_id = id; }
-        static uint32_t GenerateId()          { return ++g_id; }
+        virtual void SetId(const uint32_t id);
+        // Thread safe and unique engine-wide (ids which are set, e.g. when loading, are never generated again)
+        static uint32_t GenerateId();
 
         // CPU & GPU sizes
         const uint64_t GetSizeCpu()     const { return m_size_cpu; }
@@ -41,10 +41,15 @@ namespace Spartan
         ios_flags        |= (flags & FileStream_Write)    ? ios::out    : 0;
         ios_flags        |= (flags & FileStream_Append)    ? ios::app    : 0;
 
-        if (m_flags & FileStream_Write)
+        if (m_flags & FileStream_Memory)
+        {
+            out = &m_out_memory;
+            in  = &m_in_memory;
+        }
+        else if (m_flags & FileStream_Write)
         {
-            out.open(path, ios_flags);
-            if (out.fail())
+            m_out_file.open(path, ios_flags);
+            if (m_out_file.fail())
             {
                 LOG_ERROR("Failed to open \"%s\" for writing", path.c_str());
                 return;
@@ -52,8 +57,8 @@ namespace Spartan
         }
         else if (m_flags & FileStream_Read)
         {
-            in.open(path, ios_flags);
-            if(in.fail())
+            m_in_file.open(path, ios_flags);
+            if(m_in_file.fail())
             {
                 LOG_ERROR("Failed to open \"%s\" for reading", path.c_str());
                 return;
@@ -70,15 +75,18 @@ namespace Spartan
 
     void FileStream::Close()
     {
+        if (m_flags & FileStream_Memory)
+            return;
+
         if (m_flags & FileStream_Write)
         {
-            out.flush();
-            out.close();
+            m_out_file.flush();
+            m_out_file.close();
         }
         else if (m_flags & FileStream_Read)
         {
-            in.clear();
-            in.close();
+            m_in_file.clear();
+            m_in_file.close();
         }
     }
 
@@ -87,7 +95,7 @@ namespace Spartan
         const auto length = static_cast<uint32_t>(value.length());
         Write(length);
 
-        out.write(const_cast<char*>(value.c_str()), length);
+        out->write(const_cast<char*>(value.c_str()), length);
     }
 
     void FileStream::Write(const vector<string>& value)
@@ -105,40 +113,76 @@ namespace Spartan
     {
         const auto length = static_cast<uint32_t>(value.size());
         Write(length);
-        out.write(reinterpret_cast<const char*>(&value[0]), sizeof(RHI_Vertex_PosTexNorTan) * length);
+        out->write(reinterpret_cast<const char*>(&value[0]), sizeof(RHI_Vertex_PosTexNorTan) * length);
     }
 
     void FileStream::Write(const vector<uint32_t>& value)
     {
         const auto length = static_cast<uint32_t>(value.size());
         Write(length);
-        out.write(reinterpret_cast<const char*>(&value[0]), sizeof(uint32_t) * length);
+        out->write(reinterpret_cast<const char*>(&value[0]), sizeof(uint32_t) * length);
     }
 
     void FileStream::Write(const vector<unsigned char>& value)
     {
         const auto size = static_cast<uint32_t>(value.size());
         Write(size);
-        out.write(reinterpret_cast<const char*>(&value[0]), sizeof(unsigned char) * size);
+        out->write(reinterpret_cast<const char*>(&value[0]), sizeof(unsigned char) * size);
     }
 
     void FileStream::Write(const vector<std::byte>& value)
     {
         const auto size = static_cast<uint32_t>(value.size());
         Write(size);
-        out.write(reinterpret_cast<const char*>(&value[0]), sizeof(std::byte) * size);
+        out->write(reinterpret_cast<const char*>(&value[0]), sizeof(std::byte) * size);
     }
 
     void FileStream::Skip(uint32_t n)
     {
         // Set the seek cursor to offset n from the current position
-        if (m_flags & FileStream_Write)
+        if (m_flags & FileStream_Read)
         {
-            out.seekp(n, ios::cur);
+            in->ignore(n, ios::cur);
         }
-        else if (m_flags & FileStream_Read)
+        else
+        {
+            out->seekp(n, ios::cur);
+        }
+    }
+
+    void FileStream::ReadRaw(void* data, const uint64_t size)
+    {
+        in->read(reinterpret_cast<char*>(data), static_cast<streamsize>(size));
+    }
+
+    void FileStream::SetMemory(string data)
+    {
+        m_in_memory.str(move(data));
+        m_in_memory.clear();
+    }
+
+    void FileStream::WriteRaw(const void* data, const uint64_t size)
+    {
+        out->write(reinterpret_cast<const char*>(data), static_cast<streamsize>(size));
+    }
+
+    uint64_t FileStream::GetPosition()
+    {
+        if (m_flags & FileStream_Read)
+            return static_cast<uint64_t>(in->tellg());
+
+        return static_cast<uint64_t>(out->tellp());
+    }
+
+    void FileStream::SetPosition(const uint64_t position)
+    {
+        if (m_flags & FileStream_Read)
+        {
+            in->seekg(static_cast<streamoff>(position), ios::beg);
+        }
+        else
         {
-            in.ignore(n, ios::cur);
+            out->seekp(static_cast<streamoff>(position), ios::beg);
         }
     }
 
@@ -148,7 +192,7 @@ namespace Spartan
         Read(&length);
 
         value->resize(length);
-        in.read(const_cast<char*>(value->c_str()), length);
+        in->read(const_cast<char*>(value->c_str()), length);
     }
 
     void FileStream::Read(vector<string>* vec)
@@ -183,7 +227,7 @@ namespace Spartan
         vec->reserve(length);
         vec->resize(length);
 
-        in.read(reinterpret_cast<char*>(vec->data()), sizeof(RHI_Vertex_PosTexNorTan) * length);
+        in->read(reinterpret_cast<char*>(vec->data()), sizeof(RHI_Vertex_PosTexNorTan) * length);
     }
 
     void FileStream::Read(vector<uint32_t>* vec)
@@ -199,7 +243,7 @@ namespace Spartan
         vec->reserve(length);
         vec->resize(length);
 
-        in.read(reinterpret_cast<char*>(vec->data()), sizeof(uint32_t) * length);
+        in->read(reinterpret_cast<char*>(vec->data()), sizeof(uint32_t) * length);
     }
 
     void FileStream::Read(vector<unsigned char>* vec)
@@ -215,7 +259,7 @@ namespace Spartan
         vec->reserve(length);
         vec->resize(length);
 
-        in.read(reinterpret_cast<char*>(vec->data()), sizeof(unsigned char) * length);
+        in->read(reinterpret_cast<char*>(vec->data()), sizeof(unsigned char) * length);
     }
 
     void FileStream::Read(vector<std::byte>* vec)
@@ -231,6 +275,6 @@ namespace Spartan
         vec->reserve(length);
         vec->resize(length);
 
-        in.read(reinterpret_cast<char*>(vec->data()), sizeof(std::byte) * length);
+        in->read(reinterpret_cast<char*>(vec->data()), sizeof(std::byte) * length);
     }
 }
@@ -24,6 +24,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES ===================
 #include <vector>
 #include <fstream>
+#include <sstream>
 #include "../Math/Vector2.h"
 #include "../Math/Vector3.h"
 #include "../Math/Vector4.h"
@@ -40,6 +41,7 @@ namespace Spartan
         FileStream_Read     = 1 << 0,
         FileStream_Write    = 1 << 1,
         FileStream_Append   = 1 << 2,
+        FileStream_Memory   = 1 << 3, // reads from or writes to memory instead of a file (the path is ignored), see SetMemory() and GetMemory()
     };
 
     class SPARTAN_CLASS FileStream
@@ -76,7 +78,7 @@ namespace Spartan
         >::type>
         void Write(T value)
         {
-            out.write(reinterpret_cast<char*>(&value), sizeof(value));
+            out->write(reinterpret_cast<char*>(&value), sizeof(value));
         }
 
         void Write(const std::string& value);
@@ -86,6 +88,10 @@ namespace Spartan
         void Write(const std::vector<unsigned char>& value);
         void Write(const std::vector<std::byte>& value);
         void Skip(uint32_t n);
+        void WriteRaw(const void* data, uint64_t size);
+        uint64_t GetPosition();
+        void SetPosition(uint64_t position);
+        std::string GetMemory() const { return m_out_memory.str(); }
         //===========================================================
         
         //= READING ===========================================
@@ -114,7 +120,7 @@ namespace Spartan
         >::type>
         void Read(T* value)
         {
-            in.read(reinterpret_cast<char*>(value), sizeof(T));
+            in->read(reinterpret_cast<char*>(value), sizeof(T));
         }
         void Read(std::string* value);
         void Read(std::vector<std::string>* vec);
@@ -122,6 +128,8 @@ namespace Spartan
         void Read(std::vector<uint32_t>* vec);
         void Read(std::vector<unsigned char>* vec);
         void Read(std::vector<std::byte>* vec);
+        void ReadRaw(void* data, uint64_t size);
+        void SetMemory(std::string data);
 
         // Reading with explicit type definition
         template <class T, class = typename std::enable_if
@@ -152,8 +160,12 @@ namespace Spartan
         //=====================================================
 
     private:
-        std::ofstream out;
-        std::ifstream in;
+        std::ofstream m_out_file;
+        std::ostringstream m_out_memory;
+        std::ostream* out = &m_out_file;
+        std::ifstream m_in_file;
+        std::istringstream m_in_memory;
+        std::istream* in = &m_in_file;
         uint32_t m_flags;
         bool m_is_open;
     };
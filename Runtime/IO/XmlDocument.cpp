@@ -287,6 +287,18 @@ namespace Spartan
         return m_document->save_file(path.c_str());
     }
 
+    bool XmlDocument::Save(string* data) const
+    {
+        if (!m_document || !data)
+            return false;
+
+        ostringstream stream;
+        m_document->save(stream);
+        *data = stream.str();
+
+        return true;
+    }
+
     //= PRIVATE =======================================================
     xml_attribute XmlDocument::GetAttribute(const string& nodeName, const string& attributeName)
     {
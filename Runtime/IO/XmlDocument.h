@@ -94,6 +94,7 @@ namespace Spartan
         //= IO ================================
         bool Load(const std::string& filePath);
         bool Save(const std::string& filePath) const;
+        bool Save(std::string* data) const;
         //=====================================
 
     private:
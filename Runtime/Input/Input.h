@@ -21,11 +21,12 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #pragma once
 
-//= INCLUDES ==================
+//= INCLUDES ===================
 #include <array>
 #include "../Math/Vector2.h"
 #include "../Core/ISubsystem.h"
-//=============================
+#include "../Core/EventSystem.h"
+//==============================
 
 namespace Spartan
 {
@@ -80,7 +81,7 @@ namespace Spartan
     {
     public:
         Input(Context* context);
-        ~Input() = default;
+        ~Input();
 
         void OnWindowData();
         //= ISubsystem ======================
@@ -131,5 +132,8 @@ namespace Spartan
         // Misc
         bool m_is_new_frame         = false;
         bool m_check_for_new_device = false;
+
+        // Events
+        EventHandle m_event_window_data;
     };
 }
@@ -66,7 +66,13 @@ namespace Spartan
             RegisterRawInputDevices(Rid, 1, sizeof(Rid[0]));
         }
 
-        SUBSCRIBE_TO_EVENT(EventType::WindowData, EVENT_HANDLER(OnWindowData));
+        m_event_window_data = SUBSCRIBE_TO_EVENT(EventType::WindowData, EVENT_HANDLER(OnWindowData));
+    }
+
+    Input::~Input()
+    {
+        // Unsubscribe from events
+        UNSUBSCRIBE_FROM_EVENT(m_event_window_data);
     }
 
     void Input::OnWindowData()
@@ -0,0 +1,309 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ========
+#include "Spartan.h"
+#include "AabbTree.h"
+//===================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Spartan::Math
+{
+    namespace
+    {
+        float SurfaceArea(const BoundingBox& box)
+        {
+            const Vector3 size = box.GetSize();
+            return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+        }
+
+        BoundingBox Union(const BoundingBox& a, const BoundingBox& b)
+        {
+            BoundingBox box = a;
+            box.Merge(b);
+            return box;
+        }
+
+        bool Contains(const BoundingBox& outer, const BoundingBox& inner)
+        {
+            return
+                inner.GetMin().x >= outer.GetMin().x && inner.GetMin().y >= outer.GetMin().y && inner.GetMin().z >= outer.GetMin().z &&
+                inner.GetMax().x <= outer.GetMax().x && inner.GetMax().y <= outer.GetMax().y && inner.GetMax().z <= outer.GetMax().z;
+        }
+    }
+
+    uint32_t AabbTree::Insert(const BoundingBox& box, void* user_data)
+    {
+        const uint32_t leaf = NodeAllocate();
+        Node& node          = m_nodes[leaf];
+        node.box            = BoundingBox(box.GetMin() - m_margin, box.GetMax() + m_margin);
+        node.box_leaf       = box;
+        node.user_data      = user_data;
+        node.height         = 0;
+
+        LeafInsert(leaf);
+        m_leaf_count++;
+
+        return leaf;
+    }
+
+    void AabbTree::Remove(const uint32_t proxy)
+    {
+        SPARTAN_ASSERT(proxy < m_nodes.size() && m_nodes[proxy].IsLeaf());
+
+        LeafRemove(proxy);
+        NodeFree(proxy);
+        m_leaf_count--;
+    }
+
+    bool AabbTree::Update(const uint32_t proxy, const BoundingBox& box)
+    {
+        SPARTAN_ASSERT(proxy < m_nodes.size() && m_nodes[proxy].IsLeaf());
+
+        Node& node      = m_nodes[proxy];
+        node.box_leaf   = box;
+
+        if (Contains(node.box, box))
+            return false;
+
+        LeafRemove(proxy);
+        m_nodes[proxy].box = BoundingBox(box.GetMin() - m_margin, box.GetMax() + m_margin);
+        LeafInsert(proxy);
+
+        return true;
+    }
+
+    void AabbTree::Clear()
+    {
+        m_nodes.clear();
+        m_root          = null_node;
+        m_free          = null_node;
+        m_leaf_count    = 0;
+    }
+
+    uint32_t AabbTree::NodeAllocate()
+    {
+        if (m_free == null_node)
+        {
+            m_nodes.emplace_back();
+            return static_cast<uint32_t>(m_nodes.size() - 1);
+        }
+
+        const uint32_t index    = m_free;
+        m_free                  = m_nodes[index].parent;
+        m_nodes[index]          = Node();
+
+        return index;
+    }
+
+    void AabbTree::NodeFree(const uint32_t index)
+    {
+        Node& node      = m_nodes[index];
+        node.parent     = m_free;
+        node.child_a    = null_node;
+        node.child_b    = null_node;
+        node.user_data  = nullptr;
+        node.height     = -1;
+        m_free          = index;
+    }
+
+    void AabbTree::LeafInsert(const uint32_t leaf)
+    {
+        if (m_root == null_node)
+        {
+            m_root                  = leaf;
+            m_nodes[leaf].parent    = null_node;
+            return;
+        }
+
+        // Descend towards the cheapest sibling, a node costs it's surface area, and every ancestor grows by the leaf
+        const BoundingBox box_leaf = m_nodes[leaf].box;
+        uint32_t index = m_root;
+        while (!m_nodes[index].IsLeaf())
+        {
+            const Node& node = m_nodes[index];
+
+            const float area            = SurfaceArea(node.box);
+            const float area_combined   = SurfaceArea(Union(node.box, box_leaf));
+
+            // Creating a new parent for this node and the leaf
+            const float cost = 2.0f * area_combined;
+
+            // Pushing the leaf further down
+            const float cost_inheritance = 2.0f * (area_combined - area);
+
+            auto cost_descend = [this, &box_leaf, cost_inheritance](const uint32_t child)
+            {
+                const Node& node_child  = m_nodes[child];
+                const float area_union  = SurfaceArea(Union(box_leaf, node_child.box));
+                return (node_child.IsLeaf() ? area_union : area_union - SurfaceArea(node_child.box)) + cost_inheritance;
+            };
+
+            const float cost_a = cost_descend(node.child_a);
+            const float cost_b = cost_descend(node.child_b);
+
+            if (cost < cost_a && cost < cost_b)
+                break;
+
+            index = cost_a < cost_b ? node.child_a : node.child_b;
+        }
+
+        // Create a new parent for the sibling and the leaf
+        const uint32_t sibling      = index;
+        const uint32_t parent_old   = m_nodes[sibling].parent;
+        const uint32_t parent_new   = NodeAllocate();
+        {
+            Node& node      = m_nodes[parent_new];
+            node.parent     = parent_old;
+            node.box        = Union(box_leaf, m_nodes[sibling].box);
+            node.height     = m_nodes[sibling].height + 1;
+            node.child_a    = sibling;
+            node.child_b    = leaf;
+        }
+
+        if (parent_old != null_node)
+        {
+            Node& node = m_nodes[parent_old];
+            (node.child_a == sibling ? node.child_a : node.child_b) = parent_new;
+        }
+        else
+        {
+            m_root = parent_new;
+        }
+
+        m_nodes[sibling].parent = parent_new;
+        m_nodes[leaf].parent    = parent_new;
+
+        Refit(m_nodes[leaf].parent);
+    }
+
+    void AabbTree::LeafRemove(const uint32_t leaf)
+    {
+        if (leaf == m_root)
+        {
+            m_root = null_node;
+            return;
+        }
+
+        // The sibling takes the place of the parent
+        const uint32_t parent       = m_nodes[leaf].parent;
+        const uint32_t grandparent  = m_nodes[parent].parent;
+        const uint32_t sibling      = m_nodes[parent].child_a == leaf ? m_nodes[parent].child_b : m_nodes[parent].child_a;
+
+        if (grandparent != null_node)
+        {
+            Node& node = m_nodes[grandparent];
+            (node.child_a == parent ? node.child_a : node.child_b) = sibling;
+            m_nodes[sibling].parent = grandparent;
+            NodeFree(parent);
+
+            Refit(grandparent);
+        }
+        else
+        {
+            m_root                  = sibling;
+            m_nodes[sibling].parent = null_node;
+            NodeFree(parent);
+        }
+    }
+
+    void AabbTree::Refit(uint32_t index)
+    {
+        // Walk back up, balancing and fixing the heights and the boxes
+        while (index != null_node)
+        {
+            index = Balance(index);
+
+            Node& node      = m_nodes[index];
+            const Node& a   = m_nodes[node.child_a];
+            const Node& b   = m_nodes[node.child_b];
+            node.height     = 1 + Helper::Max(a.height, b.height);
+            node.box        = Union(a.box, b.box);
+
+            index = node.parent;
+        }
+    }
+
+    // If one child of a is more than one level taller than the other, it's promoted to a's place, returns the new subtree root
+    uint32_t AabbTree::Balance(const uint32_t index_a)
+    {
+        Node& a = m_nodes[index_a];
+        if (a.IsLeaf() || a.height < 2)
+            return index_a;
+
+        const uint32_t index_b  = a.child_a;
+        const uint32_t index_c  = a.child_b;
+        Node& b                 = m_nodes[index_b];
+        Node& c                 = m_nodes[index_c];
+        const int32_t balance   = c.height - b.height;
+
+        // Rotate the taller child up, the taller of it's children stays under it and the shorter one goes to a
+        auto rotate = [this, index_a, &a](const uint32_t index_up, const uint32_t index_other)
+        {
+            Node& up            = m_nodes[index_up];
+            const uint32_t f    = up.child_a;
+            const uint32_t g    = up.child_b;
+            Node& node_f        = m_nodes[f];
+            Node& node_g        = m_nodes[g];
+
+            // Swap a and up
+            up.child_a  = index_a;
+            up.parent   = a.parent;
+            a.parent    = index_up;
+
+            if (up.parent != null_node)
+            {
+                Node& parent = m_nodes[up.parent];
+                (parent.child_a == index_a ? parent.child_a : parent.child_b) = index_up;
+            }
+            else
+            {
+                m_root = index_up;
+            }
+
+            const Node& other = m_nodes[index_other];
+            const uint32_t keep = node_f.height > node_g.height ? f : g;
+            const uint32_t move = node_f.height > node_g.height ? g : f;
+
+            up.child_b                  = keep;
+            (a.child_a == index_up ? a.child_a : a.child_b) = move;
+            m_nodes[move].parent        = index_a;
+
+            a.box       = Union(other.box, m_nodes[move].box);
+            up.box      = Union(a.box, m_nodes[keep].box);
+            a.height    = 1 + Helper::Max(other.height, m_nodes[move].height);
+            up.height   = 1 + Helper::Max(a.height, m_nodes[keep].height);
+
+            return index_up;
+        };
+
+        if (balance > 1)
+            return rotate(index_c, index_b);
+
+        if (balance < -1)
+            return rotate(index_b, index_c);
+
+        return index_a;
+    }
+}
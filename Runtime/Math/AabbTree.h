@@ -0,0 +1,199 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ===========================
+#include <vector>
+#include "BoundingBox.h"
+#include "Frustum.h"
+#include "Ray.h"
+#include "MathHelper.h"
+#include "../Core/Spartan_Definitions.h"
+//======================================
+
+namespace Spartan::Math
+{
+    // A dynamic bounding volume hierarchy (after Box2D's b2DynamicTree). Leaves are stored with a box that's slightly
+    // larger than the object, so that it can move a bit without the tree changing, once it moves out of it it's re-inserted.
+    // Insertion descends towards the sibling with the least surface area cost, and rotations keep the tree balanced.
+    // The queries call function(user_data) for every object which overlaps the shape (tested against it's actual box).
+    class SPARTAN_CLASS AabbTree
+    {
+    public:
+        static constexpr uint32_t null_node = static_cast<uint32_t>(-1);
+
+        AabbTree(float margin = 0.1f) : m_margin(margin) {}
+        ~AabbTree() = default;
+
+        // Returns the proxy that identifies the object from now on
+        uint32_t Insert(const BoundingBox& box, void* user_data);
+        void Remove(uint32_t proxy);
+        // Returns true if the object left it's enlarged box, and it had to be re-inserted
+        bool Update(uint32_t proxy, const BoundingBox& box);
+        void Clear();
+
+        void* GetUserData(const uint32_t proxy) const   { return m_nodes[proxy].user_data; }
+        uint32_t GetCount() const                       { return m_leaf_count; }
+        uint32_t GetHeight() const                      { return m_root != null_node ? static_cast<uint32_t>(m_nodes[m_root].height) : 0; }
+
+        template <typename Function>
+        void Query(const BoundingBox& box, Function&& function) const
+        {
+            auto test = [&box](const BoundingBox& node) { return box.IsInside(node); };
+            Traverse(test, test, function);
+        }
+
+        template <typename Function>
+        void Query(const Vector3& center, const float radius, Function&& function) const
+        {
+            auto test = [&center, radius](const BoundingBox& node)
+            {
+                // The distance from the center to the closest point of the box
+                const Vector3 closest = Vector3
+                (
+                    Helper::Clamp(center.x, node.GetMin().x, node.GetMax().x),
+                    Helper::Clamp(center.y, node.GetMin().y, node.GetMax().y),
+                    Helper::Clamp(center.z, node.GetMin().z, node.GetMax().z)
+                );
+                const float distance_sq = (closest - center).LengthSquared();
+                return distance_sq <= radius * radius ? Intersects : Outside;
+            };
+            Traverse(test, test, function);
+        }
+
+        // Subtrees which are completely inside the frustum are accepted without testing their leaves
+        template <typename Function>
+        void Query(const Frustum& frustum, const bool ignore_near_plane, Function&& function) const
+        {
+            auto test_node = [&frustum, ignore_near_plane](const BoundingBox& node)
+            {
+                return frustum.CheckCube(node.GetCenter(), node.GetExtents(), ignore_near_plane);
+            };
+
+            auto test_leaf = [&frustum, ignore_near_plane](const BoundingBox& leaf)
+            {
+                return frustum.IsVisible(leaf.GetCenter(), leaf.GetExtents(), ignore_near_plane) ? Intersects : Outside;
+            };
+
+            Traverse(test_node, test_leaf, function);
+        }
+
+        template <typename Function>
+        void Query(const Ray& ray, Function&& function) const
+        {
+            auto test = [&ray](const BoundingBox& node) { return ray.HitDistance(node) != Helper::INFINITY_ ? Intersects : Outside; };
+            Traverse(test, test, function);
+        }
+
+    private:
+        struct Node
+        {
+            BoundingBox box;                    // enlarged for leaves, the union of the children for the rest
+            BoundingBox box_leaf;               // the object's actual box
+            void* user_data     = nullptr;
+            uint32_t parent     = null_node;    // the next free node, while it's free
+            uint32_t child_a    = null_node;
+            uint32_t child_b    = null_node;
+            int32_t height      = -1;           // 0 for leaves, -1 while free
+
+            bool IsLeaf() const { return child_a == null_node; }
+        };
+
+        // Depth first, the stack never gets deeper than the tree (which is balanced)
+        template <typename TestNode, typename TestLeaf, typename Function>
+        void Traverse(TestNode&& test_node, TestLeaf&& test_leaf, Function&& function) const
+        {
+            if (m_root == null_node)
+                return;
+
+            uint32_t stack[stack_size];
+            uint32_t stack_count    = 0;
+            stack[stack_count++]    = m_root;
+
+            while (stack_count != 0)
+            {
+                const Node& node = m_nodes[stack[--stack_count]];
+
+                if (node.IsLeaf())
+                {
+                    if (test_leaf(node.box_leaf) != Outside)
+                    {
+                        function(node.user_data);
+                    }
+                    continue;
+                }
+
+                const Intersection intersection = test_node(node.box);
+                if (intersection == Outside)
+                    continue;
+
+                if (intersection == Inside)
+                {
+                    ForEachLeaf(node, function);
+                    continue;
+                }
+
+                stack[stack_count++] = node.child_a;
+                stack[stack_count++] = node.child_b;
+            }
+        }
+
+        template <typename Function>
+        void ForEachLeaf(const Node& subtree, Function&& function) const
+        {
+            uint32_t stack[stack_size];
+            uint32_t stack_count    = 0;
+            stack[stack_count++]    = subtree.child_a;
+            stack[stack_count++]    = subtree.child_b;
+
+            while (stack_count != 0)
+            {
+                const Node& node = m_nodes[stack[--stack_count]];
+
+                if (node.IsLeaf())
+                {
+                    function(node.user_data);
+                    continue;
+                }
+
+                stack[stack_count++] = node.child_a;
+                stack[stack_count++] = node.child_b;
+            }
+        }
+
+        uint32_t NodeAllocate();
+        void NodeFree(uint32_t index);
+        void LeafInsert(uint32_t leaf);
+        void LeafRemove(uint32_t leaf);
+        void Refit(uint32_t index);
+        uint32_t Balance(uint32_t index);
+
+        // Enough for any balanced tree that fits in 32 bit indices
+        static constexpr uint32_t stack_size = 128;
+
+        std::vector<Node> m_nodes;
+        uint32_t m_root         = null_node;
+        uint32_t m_free         = null_node;
+        uint32_t m_leaf_count   = 0;
+        float m_margin;
+    };
+}
@@ -111,6 +111,31 @@ namespace Spartan::Math
 
     BoundingBox BoundingBox::Transform(const Matrix& transform) const
     {
+    #if defined(SPARTAN_MATH_SSE)
+        // Transpose the columns into rows, the rows of the 3x3 part are the weights of the extents
+        __m128 row0 = _mm_loadu_ps(&transform.m00);
+        __m128 row1 = _mm_loadu_ps(&transform.m01);
+        __m128 row2 = _mm_loadu_ps(&transform.m02);
+        __m128 row3 = _mm_loadu_ps(&transform.m03);
+        _MM_TRANSPOSE4_PS(row0, row1, row2, row3);
+
+        const __m128 min    = Simd::Load3(&m_min.x);
+        const __m128 max    = Simd::Load3(&m_max.x);
+        const __m128 half   = _mm_set1_ps(0.5f);
+        const __m128 center = _mm_mul_ps(_mm_add_ps(max, min), half);
+        const __m128 extent = _mm_mul_ps(_mm_sub_ps(max, min), half);
+
+        // Same as Matrix * Vector3, including the divide by w
+        __m128 center_new = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(Simd::Splat<0>(center), row0), _mm_mul_ps(Simd::Splat<1>(center), row1)), _mm_mul_ps(Simd::Splat<2>(center), row2)), row3);
+        center_new        = _mm_div_ps(center_new, Simd::Splat<3>(center_new));
+
+        const __m128 extent_new = _mm_add_ps(_mm_add_ps(_mm_mul_ps(Simd::Abs(row0), Simd::Splat<0>(extent)), _mm_mul_ps(Simd::Abs(row1), Simd::Splat<1>(extent))), _mm_mul_ps(Simd::Abs(row2), Simd::Splat<2>(extent)));
+
+        BoundingBox result;
+        Simd::Store3(&result.m_min.x, _mm_sub_ps(center_new, extent_new));
+        Simd::Store3(&result.m_max.x, _mm_add_ps(center_new, extent_new));
+        return result;
+    #else
         const Vector3 center_new = transform * GetCenter();
         const Vector3 extent_old = GetExtents();
         const Vector3 extend_new = Vector3
@@ -121,6 +146,7 @@ namespace Spartan::Math
         );
 
         return BoundingBox(center_new - extend_new, center_new + extend_new);
+    #endif
     }
 
     void BoundingBox::Merge(const BoundingBox& box)
@@ -129,7 +155,7 @@ namespace Spartan::Math
         m_min.y = Helper::Min(m_min.y, box.m_min.y);
         m_min.z = Helper::Min(m_min.z, box.m_min.z);
         m_max.x = Helper::Max(m_max.x, box.m_max.x);
-        m_max.y = Helper::Max(m_max.x, box.m_max.x);
-        m_max.z = Helper::Max(m_max.x, box.m_max.x);
+        m_max.y = Helper::Max(m_max.y, box.m_max.y);
+        m_max.z = Helper::Max(m_max.z, box.m_max.z);
     }
 }
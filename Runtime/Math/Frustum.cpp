@@ -82,41 +82,123 @@ namespace Spartan::Math
         m_planes[5].normal.z = view_projection.m23 + view_projection.m21;
         m_planes[5].d = view_projection.m33 + view_projection.m31;
         m_planes[5].Normalize();
+
+    #if defined(SPARTAN_MATH_SSE)
+        float planes[4][8] = {};
+        for (uint32_t i = 0; i < 8; i++)
+        {
+            planes[0][i] = i < 6 ? m_planes[i].normal.x : 0.0f;
+            planes[1][i] = i < 6 ? m_planes[i].normal.y : 0.0f;
+            planes[2][i] = i < 6 ? m_planes[i].normal.z : 0.0f;
+            planes[3][i] = i < 6 ? m_planes[i].d : numeric_limits<float>::max();
+        }
+
+        for (uint32_t i = 0; i < 2; i++)
+        {
+            m_planes_x[i] = _mm_loadu_ps(&planes[0][i * 4]);
+            m_planes_y[i] = _mm_loadu_ps(&planes[1][i * 4]);
+            m_planes_z[i] = _mm_loadu_ps(&planes[2][i * 4]);
+            m_planes_d[i] = _mm_loadu_ps(&planes[3][i * 4]);
+        }
+    #endif
     }
 
     bool Frustum::IsVisible(const Vector3& center, const Vector3& extent, bool ignore_near_plane /*= false*/) const
     {
-        float radius = 0.0f;
+        // The box is outside if it's entirely behind any plane, which is the case if even it's corner which is the furthest
+        // along the plane's normal is behind it. That corner's distance is the center's plus the extents projected on the normal.
+        // The near plane can be skipped, so that shadow casters behind it are not rejected.
+        for (uint32_t i = ignore_near_plane ? 1 : 0; i < 6; i++)
+        {
+            const Plane& plane  = m_planes[i];
+            const float d       = center.x * plane.normal.x + center.y * plane.normal.y + center.z * plane.normal.z + plane.d;
+            const float r       = extent.x * Helper::Abs(plane.normal.x) + extent.y * Helper::Abs(plane.normal.y) + extent.z * Helper::Abs(plane.normal.z);
+
+            if (d + r < 0.0f)
+                return false;
+        }
+
+        return true;
+    }
+
+    uint64_t Frustum::IsVisible(const float* const center[3], const float* const extent[3], const uint32_t count, const bool ignore_near_plane /*= false*/) const
+    {
+        SPARTAN_ASSERT(count <= 64);
+
+        // Same test as the single box version
+        const uint32_t plane_first  = ignore_near_plane ? 1 : 0;
+        uint64_t visible            = 0;
 
-        if (!ignore_near_plane)
+    #if defined(SPARTAN_MATH_SSE)
+        for (uint32_t i = 0; i < count; i += 4)
         {
-            radius = Helper::Max3(extent.x, extent.y, extent.z);
+            const __m128 center_x   = _mm_loadu_ps(center[0] + i);
+            const __m128 center_y   = _mm_loadu_ps(center[1] + i);
+            const __m128 center_z   = _mm_loadu_ps(center[2] + i);
+            const __m128 extent_x   = _mm_loadu_ps(extent[0] + i);
+            const __m128 extent_y   = _mm_loadu_ps(extent[1] + i);
+            const __m128 extent_z   = _mm_loadu_ps(extent[2] + i);
+
+            // Four boxes against one plane at a time, until all four are outside or the planes run out
+            int outside = 0;
+            for (uint32_t p = plane_first; p < 6 && outside != 0xF; p++)
+            {
+                const Plane& plane  = m_planes[p];
+                const __m128 d      = _mm_add_ps(_mm_add_ps(_mm_mul_ps(center_x, _mm_set1_ps(plane.normal.x)), _mm_mul_ps(center_y, _mm_set1_ps(plane.normal.y))), _mm_add_ps(_mm_mul_ps(center_z, _mm_set1_ps(plane.normal.z)), _mm_set1_ps(plane.d)));
+                const __m128 r      = _mm_add_ps(_mm_add_ps(_mm_mul_ps(extent_x, _mm_set1_ps(Helper::Abs(plane.normal.x))), _mm_mul_ps(extent_y, _mm_set1_ps(Helper::Abs(plane.normal.y)))), _mm_mul_ps(extent_z, _mm_set1_ps(Helper::Abs(plane.normal.z))));
+                outside            |= _mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(d, r), _mm_setzero_ps()));
+            }
+
+            visible |= static_cast<uint64_t>(~outside & 0xF) << i;
         }
-        else
+    #else
+        for (uint32_t i = 0; i < count; i++)
         {
-            constexpr float z = numeric_limits<float>::infinity(); // reverse-z only (but I must read form Renderer)
-            radius = Helper::Max3(extent.x, extent.y, z);
+            const Vector3 center_i = Vector3(center[0][i], center[1][i], center[2][i]);
+            const Vector3 extent_i = Vector3(extent[0][i], extent[1][i], extent[2][i]);
+            visible |= static_cast<uint64_t>(IsVisible(center_i, extent_i, ignore_near_plane)) << i;
         }
+    #endif
 
-        // Check sphere first as it's cheaper
-        if (CheckSphere(center, radius) != Outside)
-            return true;
-
-        if (CheckCube(center, radius) != Outside)
-            return true;
-
-        return false;
+        // Drop the lanes past the end
+        return count == 64 ? visible : visible & ((uint64_t(1) << count) - 1);
     }
 
-    Intersection Frustum::CheckCube(const Vector3& center, const Vector3& extent) const
+    Intersection Frustum::CheckCube(const Vector3& center, const Vector3& extent, const bool ignore_near_plane /*= false*/) const
     {
+    #if defined(SPARTAN_MATH_SSE)
+        // Four planes at a time, outside if it's behind any plane, intersecting if it straddles any
+        const __m128 center_x = _mm_set1_ps(center.x);
+        const __m128 center_y = _mm_set1_ps(center.y);
+        const __m128 center_z = _mm_set1_ps(center.z);
+        const __m128 extent_x = _mm_set1_ps(extent.x);
+        const __m128 extent_y = _mm_set1_ps(extent.y);
+        const __m128 extent_z = _mm_set1_ps(extent.z);
+
+        // The near plane is the first lane of the first four
+        int outside     = 0;
+        int intersects  = 0;
+        for (uint32_t i = 0; i < 2; i++)
+        {
+            const int lanes     = i == 0 && ignore_near_plane ? 0xE : 0xF;
+            const __m128 d      = _mm_add_ps(_mm_add_ps(_mm_mul_ps(center_x, m_planes_x[i]), _mm_mul_ps(center_y, m_planes_y[i])), _mm_mul_ps(center_z, m_planes_z[i]));
+            const __m128 r      = _mm_add_ps(_mm_add_ps(_mm_mul_ps(extent_x, Simd::Abs(m_planes_x[i])), _mm_mul_ps(extent_y, Simd::Abs(m_planes_y[i]))), _mm_mul_ps(extent_z, Simd::Abs(m_planes_z[i])));
+            const __m128 d_neg  = _mm_sub_ps(_mm_setzero_ps(), m_planes_d[i]);
+
+            outside     |= _mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(d, r), d_neg)) & lanes;
+            intersects  |= _mm_movemask_ps(_mm_cmplt_ps(_mm_sub_ps(d, r), d_neg)) & lanes;
+        }
+
+        return outside ? Outside : (intersects ? Intersects : Inside);
+    #else
         Intersection result = Inside;
         Plane plane_abs;
 
         // Check if any one point of the cube is in the view frustum.
         
-        for (const Plane& plane : m_planes)
+        for (uint32_t i = ignore_near_plane ? 1 : 0; i < 6; i++)
         {
+            const Plane& plane  = m_planes[i];
             plane_abs.normal    = plane.normal.Abs();
             plane_abs.d         = plane.d;
 
@@ -139,26 +221,6 @@ namespace Spartan::Math
         }
 
         return result;
-    }
-
-    Intersection Frustum::CheckSphere(const Vector3& center, float radius) const
-    {
-        // calculate our distances to each of the planes
-        for (const auto& plane : m_planes)
-        {
-            // find the distance to this plane
-            const float distance = Vector3::Dot(plane.normal, center) + plane.d;
-
-            // if this distance is < -sphere.radius, we are outside
-            if (distance < -radius)
-                return Outside;
-
-            // else if the distance is between +- radius, then we intersect
-            if (static_cast<float>(Helper::Abs(distance)) < radius)
-                return Intersects;
-        }
-
-        // otherwise we are fully in view
-        return Inside;
+    #endif
     }
 }
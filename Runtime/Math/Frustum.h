@@ -37,11 +37,20 @@ namespace Spartan::Math
         ~Frustum() = default;
 
         bool IsVisible(const Vector3& center, const Vector3& extent, bool ignore_near_plane = false) const;
+        // Tests up to 64 boxes which are given in structure of arrays form (x, y and z of the centers, then of the extents),
+        // four at a time, so the arrays have to be readable up to a multiple of four. Bit i is set if box i is visible.
+        uint64_t IsVisible(const float* const center[3], const float* const extent[3], uint32_t count, bool ignore_near_plane = false) const;
+        Intersection CheckCube(const Vector3& center, const Vector3& extent, bool ignore_near_plane = false) const;
 
     private:
-        Intersection CheckCube(const Vector3& center, const Vector3& extent) const;
-        Intersection CheckSphere(const Vector3& center, float radius) const;
-
         Plane m_planes[6];
+
+    #if defined(SPARTAN_MATH_SSE)
+        // The planes in structure of arrays form, padded to 8 with planes that never reject anything
+        __m128 m_planes_x[2] = {};
+        __m128 m_planes_y[2] = {};
+        __m128 m_planes_z[2] = {};
+        __m128 m_planes_d[2] = {};
+    #endif
     };
 }
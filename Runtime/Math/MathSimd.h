@@ -0,0 +1,76 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+// Defining SPARTAN_MATH_SIMD (premake5 --math-simd) switches the hot paths of the math types to SSE.
+// The public API and the memory layout of the types stay the same, only the implementation of some functions changes.
+// Results can differ from the scalar code by float rounding, as operations are grouped differently.
+#if defined(SPARTAN_MATH_SIMD) && (defined(_M_X64) || defined(__x86_64__))
+#define SPARTAN_MATH_SSE
+#endif
+
+#if defined(SPARTAN_MATH_SSE)
+
+//= INCLUDES =========
+#include <xmmintrin.h>
+#include <emmintrin.h>
+//====================
+
+namespace Spartan::Math::Simd
+{
+    // Loads three floats without reading past them, w is 0
+    inline __m128 Load3(const float* data)
+    {
+        const __m128 xy = _mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(data)));
+        const __m128 z  = _mm_load_ss(data + 2);
+        return _mm_movelh_ps(xy, z);
+    }
+
+    // Stores x, y and z without writing past them
+    inline void Store3(float* data, const __m128 v)
+    {
+        _mm_store_sd(reinterpret_cast<double*>(data), _mm_castps_pd(v));
+        _mm_store_ss(data + 2, _mm_movehl_ps(v, v));
+    }
+
+    inline __m128 Abs(const __m128 v)
+    {
+        return _mm_andnot_ps(_mm_set1_ps(-0.0f), v);
+    }
+
+    // The cross product of the xyz parts, w is 0 (if both w are finite)
+    inline __m128 Cross(const __m128 a, const __m128 b)
+    {
+        const __m128 a_yzx = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+        const __m128 b_yzx = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+        const __m128 c     = _mm_sub_ps(_mm_mul_ps(a, b_yzx), _mm_mul_ps(a_yzx, b));
+        return _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 0, 2, 1));
+    }
+
+    template <int i>
+    inline __m128 Splat(const __m128 v)
+    {
+        return _mm_shuffle_ps(v, v, _MM_SHUFFLE(i, i, i, i));
+    }
+}
+
+#endif
@@ -19,9 +19,18 @@ IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
 CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 */
 
-//= INCLUDES =======
+//= INCLUDES ========================================================
 #include "Spartan.h"
-//==================
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define SPARTAN_MATH_X86
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+//===================================================================
 
 //= NAMESPACES =====
 using namespace std;
@@ -37,6 +46,322 @@ namespace Spartan::Math
         0, 0, 0, 1
     );
 
+    namespace
+    {
+        enum class SimdLevel
+        {
+            Scalar,
+            Sse,
+            Avx
+        };
+
+#if defined(SPARTAN_MATH_X86)
+    // MSVC can emit AVX from intrinsics in any function, other compilers have to be told per function
+    #if defined(_MSC_VER)
+        #define SPARTAN_TARGET_AVX
+    #else
+        #define SPARTAN_TARGET_AVX __attribute__((target("avx")))
+    #endif
+
+        SimdLevel DetectSimdLevel()
+        {
+            int info[4] = {};
+        #if defined(_MSC_VER)
+            __cpuid(info, 1);
+        #else
+            __cpuid(1, info[0], info[1], info[2], info[3]);
+        #endif
+
+            // AVX also needs the OS to save the YMM registers on context switches
+            const bool has_avx      = (info[2] & (1 << 28)) != 0;
+            const bool has_osxsave  = (info[2] & (1 << 27)) != 0;
+            if (has_avx && has_osxsave)
+            {
+            #if defined(_MSC_VER)
+                const uint64_t xcr0 = _xgetbv(0);
+            #else
+                uint32_t eax, edx;
+                __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+                const uint64_t xcr0 = (static_cast<uint64_t>(edx) << 32) | eax;
+            #endif
+                if ((xcr0 & 0x6) == 0x6)
+                    return SimdLevel::Avx;
+            }
+
+            // SSE2 is part of x64
+            return SimdLevel::Sse;
+        }
+
+        // The loads and stores below treat a quaternion as four packed floats and a matrix as sixteen
+        static_assert(is_standard_layout_v<Quaternion> && sizeof(Quaternion) == 4 * sizeof(float), "Quaternion must be four packed floats");
+        static_assert(offsetof(Quaternion, x) == 0 && offsetof(Quaternion, y) == 4 && offsetof(Quaternion, z) == 8 && offsetof(Quaternion, w) == 12, "Quaternion must be laid out as x, y, z, w");
+        static_assert(is_standard_layout_v<Matrix> && sizeof(Matrix) == 16 * sizeof(float) && offsetof(Matrix, m00) == 0, "Matrix must be sixteen packed floats");
+
+        // Four matrices at a time, one per lane, so the math is the same as the scalar version.
+        // Each column of the output (rotation times scale, plus translation) is a 4x4 transpose away from the lanes.
+        void ComposeSse(const Vector3* translations, const Quaternion* rotations, const Vector3* scales, Matrix* out, const uint32_t count)
+        {
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 two = _mm_set1_ps(2.0f);
+
+            uint32_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                // Quaternions are x, y, z, w in memory, transpose them into one register per component
+                __m128 x = _mm_loadu_ps(&rotations[i + 0].x);
+                __m128 y = _mm_loadu_ps(&rotations[i + 1].x);
+                __m128 z = _mm_loadu_ps(&rotations[i + 2].x);
+                __m128 w = _mm_loadu_ps(&rotations[i + 3].x);
+                _MM_TRANSPOSE4_PS(x, y, z, w);
+
+                const __m128 xx = _mm_mul_ps(x, x);
+                const __m128 yy = _mm_mul_ps(y, y);
+                const __m128 zz = _mm_mul_ps(z, z);
+                const __m128 xy = _mm_mul_ps(x, y);
+                const __m128 zw = _mm_mul_ps(z, w);
+                const __m128 zx = _mm_mul_ps(z, x);
+                const __m128 yw = _mm_mul_ps(y, w);
+                const __m128 yz = _mm_mul_ps(y, z);
+                const __m128 xw = _mm_mul_ps(x, w);
+
+                const __m128 sx = _mm_setr_ps(scales[i].x, scales[i + 1].x, scales[i + 2].x, scales[i + 3].x);
+                const __m128 sy = _mm_setr_ps(scales[i].y, scales[i + 1].y, scales[i + 2].y, scales[i + 3].y);
+                const __m128 sz = _mm_setr_ps(scales[i].z, scales[i + 1].z, scales[i + 2].z, scales[i + 3].z);
+
+                // Same terms as CreateRotation(), each row scaled by it's scale component
+                __m128 m00 = _mm_mul_ps(sx, _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))));
+                __m128 m01 = _mm_mul_ps(sx, _mm_mul_ps(two, _mm_add_ps(xy, zw)));
+                __m128 m02 = _mm_mul_ps(sx, _mm_mul_ps(two, _mm_sub_ps(zx, yw)));
+                __m128 m10 = _mm_mul_ps(sy, _mm_mul_ps(two, _mm_sub_ps(xy, zw)));
+                __m128 m11 = _mm_mul_ps(sy, _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(zz, xx))));
+                __m128 m12 = _mm_mul_ps(sy, _mm_mul_ps(two, _mm_add_ps(yz, xw)));
+                __m128 m20 = _mm_mul_ps(sz, _mm_mul_ps(two, _mm_add_ps(zx, yw)));
+                __m128 m21 = _mm_mul_ps(sz, _mm_mul_ps(two, _mm_sub_ps(yz, xw)));
+                __m128 m22 = _mm_mul_ps(sz, _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, xx))));
+                __m128 m30 = _mm_setr_ps(translations[i].x, translations[i + 1].x, translations[i + 2].x, translations[i + 3].x);
+                __m128 m31 = _mm_setr_ps(translations[i].y, translations[i + 1].y, translations[i + 2].y, translations[i + 3].y);
+                __m128 m32 = _mm_setr_ps(translations[i].z, translations[i + 1].z, translations[i + 2].z, translations[i + 3].z);
+
+                _MM_TRANSPOSE4_PS(m00, m10, m20, m30);
+                _MM_TRANSPOSE4_PS(m01, m11, m21, m31);
+                _MM_TRANSPOSE4_PS(m02, m12, m22, m32);
+
+                // After the transposes, register j holds a column of matrix i + j
+                const __m128 columns[3][4] = { { m00, m10, m20, m30 }, { m01, m11, m21, m31 }, { m02, m12, m22, m32 } };
+                const __m128 column_last   = _mm_setr_ps(0.0f, 0.0f, 0.0f, 1.0f);
+                for (uint32_t j = 0; j < 4; j++)
+                {
+                    float* data = &out[i + j].m00;
+                    _mm_storeu_ps(data + 0,  columns[0][j]);
+                    _mm_storeu_ps(data + 4,  columns[1][j]);
+                    _mm_storeu_ps(data + 8,  columns[2][j]);
+                    _mm_storeu_ps(data + 12, column_last);
+                }
+            }
+
+            for (; i < count; i++)
+            {
+                out[i] = Matrix(translations[i], rotations[i], scales[i]);
+            }
+        }
+
+        // In column-major storage, column c of the result is the sum of the columns of the left side, weighted by row c of the right side
+        void MultiplySse(const Matrix* matrices, const Matrix& rhs, Matrix* out, const uint32_t count)
+        {
+            __m128 weights[4][4];
+            for (uint32_t c = 0; c < 4; c++)
+            {
+                for (uint32_t k = 0; k < 4; k++)
+                {
+                    weights[c][k] = _mm_set1_ps(rhs.Data()[c * 4 + k]);
+                }
+            }
+
+            for (uint32_t i = 0; i < count; i++)
+            {
+                const float* in = matrices[i].Data();
+                const __m128 col0 = _mm_loadu_ps(in + 0);
+                const __m128 col1 = _mm_loadu_ps(in + 4);
+                const __m128 col2 = _mm_loadu_ps(in + 8);
+                const __m128 col3 = _mm_loadu_ps(in + 12);
+
+                float* result = &out[i].m00;
+                for (uint32_t c = 0; c < 4; c++)
+                {
+                    const __m128 sum = _mm_add_ps
+                    (
+                        _mm_add_ps(_mm_mul_ps(col0, weights[c][0]), _mm_mul_ps(col1, weights[c][1])),
+                        _mm_add_ps(_mm_mul_ps(col2, weights[c][2]), _mm_mul_ps(col3, weights[c][3]))
+                    );
+                    _mm_storeu_ps(result + c * 4, sum);
+                }
+            }
+        }
+
+        // Same as the SSE version, two result columns at a time
+        SPARTAN_TARGET_AVX void MultiplyAvx(const Matrix* matrices, const Matrix& rhs, Matrix* out, const uint32_t count)
+        {
+            const float* r = rhs.Data();
+            __m256 weights[2][4];
+            for (uint32_t pair = 0; pair < 2; pair++)
+            {
+                for (uint32_t k = 0; k < 4; k++)
+                {
+                    weights[pair][k] = _mm256_setr_m128(_mm_set1_ps(r[(pair * 2) * 4 + k]), _mm_set1_ps(r[(pair * 2 + 1) * 4 + k]));
+                }
+            }
+
+            for (uint32_t i = 0; i < count; i++)
+            {
+                const float* in = matrices[i].Data();
+                const __m256 col0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(in + 0));
+                const __m256 col1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(in + 4));
+                const __m256 col2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(in + 8));
+                const __m256 col3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(in + 12));
+
+                float* result = &out[i].m00;
+                for (uint32_t pair = 0; pair < 2; pair++)
+                {
+                    const __m256 sum = _mm256_add_ps
+                    (
+                        _mm256_add_ps(_mm256_mul_ps(col0, weights[pair][0]), _mm256_mul_ps(col1, weights[pair][1])),
+                        _mm256_add_ps(_mm256_mul_ps(col2, weights[pair][2]), _mm256_mul_ps(col3, weights[pair][3]))
+                    );
+                    _mm256_storeu_ps(result + pair * 8, sum);
+                }
+            }
+        }
+#else
+        SimdLevel DetectSimdLevel() { return SimdLevel::Scalar; }
+#endif
+
+        SimdLevel GetSimdLevel()
+        {
+            static const SimdLevel level = DetectSimdLevel();
+            return level;
+        }
+    }
+
+    void Matrix::ComposeBatch(const Vector3* translations, const Quaternion* rotations, const Vector3* scales, Matrix* out, const uint32_t count)
+    {
+    #if defined(SPARTAN_MATH_X86)
+        // Four lanes already need three transposes per group, so AVX uses the SSE path here
+        if (GetSimdLevel() != SimdLevel::Scalar)
+        {
+            ComposeSse(translations, rotations, scales, out, count);
+            return;
+        }
+    #endif
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            out[i] = Matrix(translations[i], rotations[i], scales[i]);
+        }
+    }
+
+    void Matrix::MultiplyBatch(const Matrix* matrices, const Matrix& rhs, Matrix* out, const uint32_t count)
+    {
+    #if defined(SPARTAN_MATH_X86)
+        if (GetSimdLevel() == SimdLevel::Avx)
+        {
+            MultiplyAvx(matrices, rhs, out, count);
+            return;
+        }
+
+        if (GetSimdLevel() == SimdLevel::Sse)
+        {
+            MultiplySse(matrices, rhs, out, count);
+            return;
+        }
+    #endif
+
+        for (uint32_t i = 0; i < count; i++)
+        {
+            out[i] = matrices[i] * rhs;
+        }
+    }
+
+#if defined(SPARTAN_MATH_SSE)
+    namespace
+    {
+        // 2x2 matrices packed in a register as (m00, m01, m10, m11)
+        inline __m128 Mat2Mul(const __m128 a, const __m128 b)
+        {
+            return _mm_add_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 3, 0))), _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+        }
+
+        // adjugate(a) * b
+        inline __m128 Mat2AdjMul(const __m128 a, const __m128 b)
+        {
+            return _mm_sub_ps(_mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(0, 0, 3, 3)), b), _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 2, 1, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 0, 3, 2))));
+        }
+
+        // a * adjugate(b)
+        inline __m128 Mat2MulAdj(const __m128 a, const __m128 b)
+        {
+            return _mm_sub_ps(_mm_mul_ps(a, _mm_shuffle_ps(b, b, _MM_SHUFFLE(0, 3, 0, 3))), _mm_mul_ps(_mm_shuffle_ps(a, a, _MM_SHUFFLE(2, 3, 0, 1)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(1, 2, 1, 2))));
+        }
+    }
+
+    // Block-wise inversion on 2x2 sub-matrices. It inverts the memory as if it was row-major, which is fine,
+    // as the inverse of the transpose is the transpose of the inverse.
+    Matrix Matrix::InvertSimd(const Matrix& matrix)
+    {
+        const float* data = matrix.Data();
+        const __m128 r0 = _mm_loadu_ps(data + 0);
+        const __m128 r1 = _mm_loadu_ps(data + 4);
+        const __m128 r2 = _mm_loadu_ps(data + 8);
+        const __m128 r3 = _mm_loadu_ps(data + 12);
+
+        // Sub-matrices
+        const __m128 a = _mm_movelh_ps(r0, r1);
+        const __m128 b = _mm_movehl_ps(r1, r0);
+        const __m128 c = _mm_movelh_ps(r2, r3);
+        const __m128 d = _mm_movehl_ps(r3, r2);
+
+        // Their determinants, as (|A|, |B|, |C|, |D|)
+        const __m128 det_sub = _mm_sub_ps
+        (
+            _mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(2, 0, 2, 0)), _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(3, 1, 3, 1))),
+            _mm_mul_ps(_mm_shuffle_ps(r0, r2, _MM_SHUFFLE(3, 1, 3, 1)), _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(2, 0, 2, 0)))
+        );
+        const __m128 det_a = Simd::Splat<0>(det_sub);
+        const __m128 det_b = Simd::Splat<1>(det_sub);
+        const __m128 det_c = Simd::Splat<2>(det_sub);
+        const __m128 det_d = Simd::Splat<3>(det_sub);
+
+        const __m128 d_c = Mat2AdjMul(d, c);
+        const __m128 a_b = Mat2AdjMul(a, b);
+
+        __m128 x = _mm_sub_ps(_mm_mul_ps(det_d, a), Mat2Mul(b, d_c));
+        __m128 w = _mm_sub_ps(_mm_mul_ps(det_a, d), Mat2Mul(c, a_b));
+        __m128 y = _mm_sub_ps(_mm_mul_ps(det_b, c), Mat2MulAdj(d, a_b));
+        __m128 z = _mm_sub_ps(_mm_mul_ps(det_c, b), Mat2MulAdj(a, d_c));
+
+        // |M| = |A||D| + |B||C| - trace((A#B)(D#C))
+        __m128 trace = _mm_mul_ps(a_b, _mm_shuffle_ps(d_c, d_c, _MM_SHUFFLE(3, 1, 2, 0)));
+        trace        = _mm_add_ps(trace, _mm_shuffle_ps(trace, trace, _MM_SHUFFLE(2, 3, 0, 1)));
+        trace        = _mm_add_ps(trace, _mm_shuffle_ps(trace, trace, _MM_SHUFFLE(1, 0, 3, 2)));
+        const __m128 det = _mm_sub_ps(_mm_add_ps(_mm_mul_ps(det_a, det_d), _mm_mul_ps(det_b, det_c)), trace);
+
+        const __m128 det_inv = _mm_div_ps(_mm_setr_ps(1.0f, -1.0f, -1.0f, 1.0f), det);
+        x = _mm_mul_ps(x, det_inv);
+        y = _mm_mul_ps(y, det_inv);
+        z = _mm_mul_ps(z, det_inv);
+        w = _mm_mul_ps(w, det_inv);
+
+        // Apply the adjugate while storing
+        Matrix result;
+        float* out = &result.m00;
+        _mm_storeu_ps(out + 0,  _mm_shuffle_ps(x, y, _MM_SHUFFLE(1, 3, 1, 3)));
+        _mm_storeu_ps(out + 4,  _mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 2, 0, 2)));
+        _mm_storeu_ps(out + 8,  _mm_shuffle_ps(z, w, _MM_SHUFFLE(1, 3, 1, 3)));
+        _mm_storeu_ps(out + 12, _mm_shuffle_ps(z, w, _MM_SHUFFLE(0, 2, 0, 2)));
+
+        return result;
+    }
+#endif
+
     string Matrix::ToString() const
     {
         char tempBuffer[200];
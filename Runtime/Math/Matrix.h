@@ -25,6 +25,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Quaternion.h"
 #include "Vector3.h"
 #include "Vector4.h"
+#include "MathSimd.h"
 //=====================
 
 namespace Spartan::Math
@@ -286,6 +287,9 @@ namespace Spartan::Math
         [[nodiscard]] Matrix Inverted() const { return Invert(*this); }
         static inline Matrix Invert(const Matrix& matrix)
         {
+        #if defined(SPARTAN_MATH_SSE)
+            return InvertSimd(matrix);
+        #else
             float v0 = matrix.m20 * matrix.m31 - matrix.m21 * matrix.m30;
             float v1 = matrix.m20 * matrix.m32 - matrix.m22 * matrix.m30;
             float v2 = matrix.m20 * matrix.m33 - matrix.m23 *matrix.m30;
@@ -339,9 +343,56 @@ namespace Spartan::Math
                 i10, i11, i12, i13,
                 i20, i21, i22, i23,
                 i30, i31, i32, i33);
+        #endif
+        }
+    #if defined(SPARTAN_MATH_SSE)
+        static Matrix InvertSimd(const Matrix& matrix);
+    #endif
+
+        // Only valid for matrices without projection (the last column is 0, 0, 0, 1), like the ones built from a
+        // translation, rotation and scale. It only has to invert the upper 3x3 part, so it's a lot cheaper.
+        [[nodiscard]] Matrix InvertedAffine() const { return InvertAffine(*this); }
+        static inline Matrix InvertAffine(const Matrix& matrix)
+        {
+            const float c00 = matrix.m11 * matrix.m22 - matrix.m12 * matrix.m21;
+            const float c01 = matrix.m12 * matrix.m20 - matrix.m10 * matrix.m22;
+            const float c02 = matrix.m10 * matrix.m21 - matrix.m11 * matrix.m20;
+
+            const float invDet = 1.0f / (matrix.m00 * c00 + matrix.m01 * c01 + matrix.m02 * c02);
+
+            const float i00 = c00 * invDet;
+            const float i01 = (matrix.m02 * matrix.m21 - matrix.m01 * matrix.m22) * invDet;
+            const float i02 = (matrix.m01 * matrix.m12 - matrix.m02 * matrix.m11) * invDet;
+            const float i10 = c01 * invDet;
+            const float i11 = (matrix.m00 * matrix.m22 - matrix.m02 * matrix.m20) * invDet;
+            const float i12 = (matrix.m02 * matrix.m10 - matrix.m00 * matrix.m12) * invDet;
+            const float i20 = c02 * invDet;
+            const float i21 = (matrix.m01 * matrix.m20 - matrix.m00 * matrix.m21) * invDet;
+            const float i22 = (matrix.m00 * matrix.m11 - matrix.m01 * matrix.m10) * invDet;
+
+            // The inverse translation, is the translation taken through the inverse 3x3
+            const float i30 = -(matrix.m30 * i00 + matrix.m31 * i10 + matrix.m32 * i20);
+            const float i31 = -(matrix.m30 * i01 + matrix.m31 * i11 + matrix.m32 * i21);
+            const float i32 = -(matrix.m30 * i02 + matrix.m31 * i12 + matrix.m32 * i22);
+
+            return Matrix(
+                i00, i01, i02, 0.0f,
+                i10, i11, i12, 0.0f,
+                i20, i21, i22, 0.0f,
+                i30, i31, i32, 1.0f);
         }
         //================================================================================================
 
+        //= BATCH ====================================================================================================================
+        // These process arrays of matrices using the widest instruction set the CPU supports (AVX, SSE or scalar), picked at runtime.
+        // The input and output arrays can't overlap.
+
+        // Equivalent to out[i] = Matrix(translations[i], rotations[i], scales[i])
+        static void ComposeBatch(const Vector3* translations, const Quaternion* rotations, const Vector3* scales, Matrix* out, uint32_t count);
+        // Equivalent to out[i] = matrices[i] * rhs, e.g. world matrices times the view projection
+        static void MultiplyBatch(const Matrix* matrices, const Matrix& rhs, Matrix* out, uint32_t count);
+        //============================================================================================================================
+
         void Decompose(Vector3& scale, Quaternion& rotation, Vector3& translation) const
         {
             translation = GetTranslation();
@@ -360,6 +411,26 @@ namespace Spartan::Math
         //= MULTIPLICATION ================================================================================================================
         Matrix operator*(const Matrix& rhs) const
         {
+        #if defined(SPARTAN_MATH_SSE)
+            // In column-major storage, column c of the result is the sum of the columns of the left side,
+            // weighted by column c of the right side. Summed in the same order as the scalar version.
+            const __m128 col0 = _mm_loadu_ps(&m00);
+            const __m128 col1 = _mm_loadu_ps(&m01);
+            const __m128 col2 = _mm_loadu_ps(&m02);
+            const __m128 col3 = _mm_loadu_ps(&m03);
+
+            Matrix result;
+            for (uint32_t c = 0; c < 4; c++)
+            {
+                const __m128 weights = _mm_loadu_ps(rhs.Data() + c * 4);
+                __m128 sum = _mm_mul_ps(col0, Simd::Splat<0>(weights));
+                sum        = _mm_add_ps(sum, _mm_mul_ps(col1, Simd::Splat<1>(weights)));
+                sum        = _mm_add_ps(sum, _mm_mul_ps(col2, Simd::Splat<2>(weights)));
+                sum        = _mm_add_ps(sum, _mm_mul_ps(col3, Simd::Splat<3>(weights)));
+                _mm_storeu_ps(&result.m00 + c * 4, sum);
+            }
+            return result;
+        #else
             return Matrix(
                 m00 * rhs.m00 + m01 * rhs.m10 + m02 * rhs.m20 + m03 * rhs.m30,
                 m00 * rhs.m01 + m01 * rhs.m11 + m02 * rhs.m21 + m03 * rhs.m31,
@@ -378,6 +449,7 @@ namespace Spartan::Math
                 m30 * rhs.m02 + m31 * rhs.m12 + m32 * rhs.m22 + m33 * rhs.m32,
                 m30 * rhs.m03 + m31 * rhs.m13 + m32 * rhs.m23 + m33 * rhs.m33
             );
+        #endif
         }
 
         void operator*=(const Matrix& rhs) { (*this) = (*this) * rhs; }
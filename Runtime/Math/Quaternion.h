@@ -21,9 +21,10 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #pragma once
 
-//= INCLUDES =======
+//= INCLUDES ========
 #include "Vector3.h"
-//==================
+#include "MathSimd.h"
+//===================
 
 namespace Spartan::Math
 {
@@ -265,11 +266,21 @@ namespace Spartan::Math
 
         Vector3 operator*(const Vector3& rhs) const
         {
+        #if defined(SPARTAN_MATH_SSE)
+            const __m128 q      = _mm_loadu_ps(&x);
+            const __m128 v      = _mm_setr_ps(rhs.x, rhs.y, rhs.z, 0.0f);
+            const __m128 cross1 = Simd::Cross(q, v);
+            const __m128 cross2 = Simd::Cross(q, cross1);
+            const __m128 result = _mm_add_ps(v, _mm_mul_ps(_mm_set1_ps(2.0f), _mm_add_ps(_mm_mul_ps(cross1, Simd::Splat<3>(q)), cross2)));
+
+            return Vector3(_mm_cvtss_f32(result), _mm_cvtss_f32(Simd::Splat<1>(result)), _mm_cvtss_f32(Simd::Splat<2>(result)));
+        #else
             const Vector3 qVec(x, y, z);
             const Vector3 cross1(qVec.Cross(rhs));
             const Vector3 cross2(qVec.Cross(cross1));
 
             return rhs + 2.0f * (cross1 * w + cross2);
+        #endif
         }
 
         Quaternion& operator *=(float rhs)
@@ -24,6 +24,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Profiler.h"
 #include "../Rendering/Renderer.h"
 #include "../Resource/ResourceCache.h"
+#include "../Threading/Threading.h"
 #include "../RHI/RHI_Device.h"
 #include "../RHI/RHI_CommandList.h"
 #include "../RHI/RHI_Implementation.h"
@@ -37,6 +38,7 @@ namespace Spartan
 {
     Profiler::Profiler(Context* context) : ISubsystem(context)
     {
+        m_thread_id = this_thread::get_id();
         m_time_blocks_read.reserve(m_time_block_capacity);
         m_time_blocks_read.resize(m_time_block_capacity);
         m_time_blocks_write.reserve(m_time_block_capacity);
@@ -56,6 +58,7 @@ namespace Spartan
         m_resource_manager    = m_context->GetSubsystem<ResourceCache>();
         m_renderer            = m_context->GetSubsystem<Renderer>();
         m_timer             = m_context->GetSubsystem<Timer>();
+        m_threading         = m_context->GetSubsystem<Threading>();
 
         return true;
     }
@@ -202,7 +205,7 @@ namespace Spartan
 
     void Profiler::TimeBlockStart(const char* func_name, TimeBlock_Type type, RHI_CommandList* cmd_list /*= nullptr*/)
     {
-        if (!m_profile)
+        if (!m_profile || this_thread::get_id() != m_thread_id)
             return;
 
         const bool can_profile_cpu = (type == TimeBlock_Cpu) && m_profile_cpu_enabled;
@@ -223,7 +226,7 @@ namespace Spartan
     void Profiler::TimeBlockEnd()
     {
         // If the capacity 
-        if (m_increase_capacity)
+        if (m_increase_capacity || this_thread::get_id() != m_thread_id)
             return;
 
         if (TimeBlock* time_block = GetLastIncompleteTimeBlock())
@@ -329,6 +332,7 @@ namespace Spartan
             // Renderer
             "Resolution:\t\t%dx%d\n"
             "Meshes rendered:\t%d\n"
+            "Meshes culled:\t\t%d\n"
             "Textures:\t\t\t%d\n"
             "Materials:\t\t%d\n"
             "\n"
@@ -341,6 +345,7 @@ namespace Spartan
             "Sampler:\t\t\t%d\n"
             "Texture sampled:\t%d\n"
             "Texture storage:\t%d\n"
+            "Structured buffer:\t%d\n"
             "Shader vertex:\t%d\n"
             "Shader pixel:\t\t%d\n"
             "Shader compute:\t%d\n"
@@ -369,6 +374,7 @@ namespace Spartan
             // Renderer
             static_cast<int>(m_renderer->GetResolution().x), static_cast<int>(m_renderer->GetResolution().y),
             m_renderer_meshes_rendered,
+            m_renderer_meshes_culled,
             texture_count,
             material_count,
 
@@ -381,6 +387,7 @@ namespace Spartan
             m_rhi_bindings_sampler,
             m_rhi_bindings_texture_sampled,
             m_rhi_bindings_texture_storage,
+            m_rhi_bindings_structured_buffer,
             m_rhi_bindings_shader_vertex,
             m_rhi_bindings_shader_pixel,
             m_rhi_bindings_shader_compute,
@@ -391,5 +398,24 @@ namespace Spartan
         );
 
         m_metrics = string(buffer);
+
+        // Thread pools
+        m_metrics += "\n\n";
+        const auto add_pool_metrics = [this](const char* name, const ThreadPoolMetrics& metrics)
+        {
+            static char buffer_pool[256];
+            sprintf_s(buffer_pool, "%s:\t%d threads, %d queued, %d executed, wait %.2f ms (max %.2f ms)\n", name, metrics.thread_count, metrics.tasks_queued, metrics.tasks_executed, metrics.wait_time_avg_ms, metrics.wait_time_max_ms);
+            m_metrics += buffer_pool;
+        };
+        add_pool_metrics("Compute", m_threading->GetMetrics(ThreadPool::Compute));
+        add_pool_metrics("I/O", m_threading->GetMetrics(ThreadPool::Io));
+
+        // Subsystems
+        m_metrics += "\n";
+        for (const SubsystemTickTime& tick_time : m_context->GetSubsystemTickTimes())
+        {
+            sprintf_s(buffer, "%s:\t%.2f ms\n", tick_time.name, tick_time.time_ms);
+            m_metrics += buffer;
+        }
     }
 }
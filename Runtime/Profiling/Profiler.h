@@ -24,6 +24,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES ===========================
 #include <string>
 #include <vector>
+#include <thread>
 #include "TimeBlock.h"
 #include "../Core/ISubsystem.h"
 #include "../Core/Stopwatch.h"
@@ -42,6 +43,7 @@ namespace Spartan
     class Renderer;
     class Variant;
     class Timer;
+    class Threading;
 
     class SPARTAN_CLASS Profiler : public ISubsystem
     {
@@ -89,12 +91,14 @@ namespace Spartan
         uint32_t m_rhi_bindings_shader_compute          = 0;
         uint32_t m_rhi_bindings_render_target            = 0;
         uint32_t m_rhi_bindings_texture_storage         = 0;
+        uint32_t m_rhi_bindings_structured_buffer       = 0;
         uint32_t m_rhi_bindings_descriptor_set          = 0;     
         uint32_t m_rhi_bindings_pipeline                = 0;
         uint32_t m_rhi_pipeline_barriers                = 0;
 
         // Metrics - Renderer
         uint32_t m_renderer_meshes_rendered = 0;
+        uint32_t m_renderer_meshes_culled   = 0; // outside of the camera's view frustum, or with nothing to draw
 
         // Metrics - Time
         float m_time_frame_avg  = 0.0f;
@@ -116,6 +120,7 @@ namespace Spartan
             m_rhi_draw                          = 0;
             m_rhi_dispatch                      = 0;
             m_renderer_meshes_rendered          = 0;
+            m_renderer_meshes_culled            = 0;
             m_rhi_bindings_buffer_index         = 0;
             m_rhi_bindings_buffer_vertex        = 0;
             m_rhi_bindings_buffer_constant      = 0;
@@ -126,6 +131,7 @@ namespace Spartan
             m_rhi_bindings_shader_compute       = 0;
             m_rhi_bindings_render_target        = 0;
             m_rhi_bindings_texture_storage      = 0;
+            m_rhi_bindings_structured_buffer    = 0;
             m_rhi_bindings_descriptor_set       = 0;
             m_rhi_bindings_pipeline             = 0;
             m_rhi_pipeline_barriers             = 0;
@@ -169,6 +175,7 @@ namespace Spartan
 
         // Misc
         std::string m_metrics = "N/A";
+        std::thread::id m_thread_id; // time blocks are only recorded from the thread which created the profiler
         bool m_profile = true;
         bool m_increase_capacity = 0.0f;
         bool m_allow_time_block_end = true;
@@ -177,6 +184,7 @@ namespace Spartan
         ResourceCache* m_resource_manager    = nullptr;
         Renderer* m_renderer                = nullptr;
         Timer* m_timer                      = nullptr;
+        Threading* m_threading              = nullptr;
     };
 
     class ScopedTimeBlock
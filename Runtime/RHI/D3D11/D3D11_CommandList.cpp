@@ -29,6 +29,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../RHI_Texture.h"
 #include "../RHI_Shader.h"
 #include "../RHI_ConstantBuffer.h"
+#include "../RHI_StructuredBuffer.h"
 #include "../RHI_VertexBuffer.h"
 #include "../RHI_IndexBuffer.h"
 #include "../RHI_BlendState.h"
@@ -447,13 +448,15 @@ namespace Spartan
         return true;
     }
 
-    bool RHI_CommandList::DrawIndexed(const uint32_t index_count, const uint32_t index_offset, const uint32_t vertex_offset)
+    bool RHI_CommandList::DrawIndexed(const uint32_t index_count, const uint32_t index_offset, const uint32_t vertex_offset, const uint32_t instance_count)
     {
-        m_rhi_device->GetContextRhi()->device_context->DrawIndexed
+        m_rhi_device->GetContextRhi()->device_context->DrawIndexedInstanced
         (
             static_cast<UINT>(index_count),
+            static_cast<UINT>(instance_count),
             static_cast<UINT>(index_offset),
-            static_cast<INT>(vertex_offset)
+            static_cast<INT>(vertex_offset),
+            0
         );
 
         m_profiler->m_rhi_draw++;
@@ -682,6 +685,35 @@ namespace Spartan
         }
     }
 
+    void RHI_CommandList::SetStructuredBuffer(const uint32_t slot, RHI_StructuredBuffer* structured_buffer) const
+    {
+        const UINT range                    = 1;
+        ID3D11DeviceContext* device_context = m_rhi_device->GetContextRhi()->device_context;
+        const void* srv_array[1]            = { structured_buffer ? structured_buffer->GetResourceView() : nullptr };
+
+        // Structured buffers are read by vertex shaders (instancing) or compute shaders
+        if (m_pipeline_state->IsCompute())
+        {
+            ID3D11ShaderResourceView* set_srv = nullptr;
+            device_context->CSGetShaderResources(slot, range, &set_srv);
+            if (set_srv != srv_array[0])
+            {
+                device_context->CSSetShaderResources(slot, range, reinterpret_cast<ID3D11ShaderResourceView* const*>(&srv_array));
+                m_profiler->m_rhi_bindings_structured_buffer++;
+            }
+        }
+        else
+        {
+            ID3D11ShaderResourceView* set_srv = nullptr;
+            device_context->VSGetShaderResources(slot, range, &set_srv);
+            if (set_srv != srv_array[0])
+            {
+                device_context->VSSetShaderResources(slot, range, reinterpret_cast<ID3D11ShaderResourceView* const*>(&srv_array));
+                m_profiler->m_rhi_bindings_structured_buffer++;
+            }
+        }
+    }
+
     bool RHI_CommandList::Timestamp_Start(void* query_disjoint /*= nullptr*/, void* query_start /*= nullptr*/)
     {
         if (!query_disjoint || !query_start)
@@ -0,0 +1,122 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =======================
+#include "Spartan.h"
+#include "../RHI_Implementation.h"
+#include "../RHI_StructuredBuffer.h"
+#include "../RHI_Device.h"
+//==================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Spartan
+{
+    void RHI_StructuredBuffer::_destroy()
+    {
+        d3d11_utility::release(*reinterpret_cast<ID3D11ShaderResourceView**>(&m_resource_view));
+        d3d11_utility::release(*reinterpret_cast<ID3D11Buffer**>(&m_buffer));
+    }
+
+    RHI_StructuredBuffer::RHI_StructuredBuffer(const std::shared_ptr<RHI_Device>& rhi_device, const string& name)
+    {
+        m_rhi_device    = rhi_device;
+        m_name          = name;
+    }
+
+    void* RHI_StructuredBuffer::Map()
+    {
+        if (!m_rhi_device || !m_rhi_device->GetContextRhi()->device_context || !m_buffer)
+        {
+            LOG_ERROR_INVALID_INTERNALS();
+            return nullptr;
+        }
+
+        // Discarding gives the draws which were already issued their own copy, so every map starts with an undefined buffer
+        D3D11_MAPPED_SUBRESOURCE mapped_resource;
+        const auto result = m_rhi_device->GetContextRhi()->device_context->Map(static_cast<ID3D11Buffer*>(m_buffer), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped_resource);
+        if (FAILED(result))
+        {
+            LOG_ERROR("Failed to map structured buffer.");
+            return nullptr;
+        }
+
+        return mapped_resource.pData;
+    }
+
+    bool RHI_StructuredBuffer::Unmap(const uint64_t offset /*= 0*/, const uint64_t size /*= 0*/)
+    {
+        if (!m_rhi_device || !m_rhi_device->GetContextRhi()->device_context || !m_buffer)
+        {
+            LOG_ERROR_INVALID_INTERNALS();
+            return false;
+        }
+
+        m_rhi_device->GetContextRhi()->device_context->Unmap(static_cast<ID3D11Buffer*>(m_buffer), 0);
+        return true;
+    }
+
+    bool RHI_StructuredBuffer::_create()
+    {
+        if (!m_rhi_device || !m_rhi_device->GetContextRhi()->device)
+        {
+            LOG_ERROR_INVALID_PARAMETER();
+            return false;
+        }
+
+        // Destroy previous buffer
+        _destroy();
+
+        D3D11_BUFFER_DESC buffer_desc;
+        ZeroMemory(&buffer_desc, sizeof(buffer_desc));
+        buffer_desc.ByteWidth           = static_cast<UINT>(m_size_gpu);
+        buffer_desc.Usage               = D3D11_USAGE_DYNAMIC;
+        buffer_desc.BindFlags           = D3D11_BIND_SHADER_RESOURCE;
+        buffer_desc.CPUAccessFlags      = D3D11_CPU_ACCESS_WRITE;
+        buffer_desc.MiscFlags           = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+        buffer_desc.StructureByteStride = m_stride;
+
+        auto result = m_rhi_device->GetContextRhi()->device->CreateBuffer(&buffer_desc, nullptr, reinterpret_cast<ID3D11Buffer**>(&m_buffer));
+        if (FAILED(result))
+        {
+            LOG_ERROR("Failed to create structured buffer");
+            return false;
+        }
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC srv_desc;
+        ZeroMemory(&srv_desc, sizeof(srv_desc));
+        srv_desc.Format                 = DXGI_FORMAT_UNKNOWN;
+        srv_desc.ViewDimension          = D3D11_SRV_DIMENSION_BUFFER;
+        srv_desc.Buffer.FirstElement    = 0;
+        srv_desc.Buffer.NumElements     = m_element_count;
+
+        result = m_rhi_device->GetContextRhi()->device->CreateShaderResourceView(static_cast<ID3D11Buffer*>(m_buffer), &srv_desc, reinterpret_cast<ID3D11ShaderResourceView**>(&m_resource_view));
+        if (FAILED(result))
+        {
+            LOG_ERROR("Failed to create structured buffer view");
+            return false;
+        }
+
+        return true;
+    }
+}
@@ -101,7 +101,7 @@ namespace Spartan
 
         // Draw
         bool Draw(uint32_t vertex_count);
-        bool DrawIndexed(uint32_t index_count, uint32_t index_offset = 0, uint32_t vertex_offset = 0);
+        bool DrawIndexed(uint32_t index_count, uint32_t index_offset = 0, uint32_t vertex_offset = 0, uint32_t instance_count = 1);
         
         // Dispatch
         bool Dispatch(uint32_t x, uint32_t y, uint32_t z, bool async = false);
@@ -133,6 +133,10 @@ namespace Spartan
         inline void SetTexture(const RendererBindingsSrv slot, RHI_Texture* texture)                        { SetTexture(static_cast<uint32_t>(slot), texture, false); }
         inline void SetTexture(const RendererBindingsSrv slot, const std::shared_ptr<RHI_Texture>& texture) { SetTexture(static_cast<uint32_t>(slot), texture.get(), false); }
         
+        // Structured buffer
+        void SetStructuredBuffer(const uint32_t slot, RHI_StructuredBuffer* structured_buffer) const;
+        inline void SetStructuredBuffer(const RendererBindingsSrv slot, const std::shared_ptr<RHI_StructuredBuffer>& structured_buffer) const { SetStructuredBuffer(static_cast<uint32_t>(slot), structured_buffer.get()); }
+
         // Timestamps
         bool Timestamp_Start(void* query_disjoint = nullptr, void* query_start = nullptr);
         bool Timestamp_End(void* query_disjoint = nullptr, void* query_end = nullptr);
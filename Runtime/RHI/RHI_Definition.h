@@ -45,6 +45,7 @@ namespace Spartan
     class RHI_VertexBuffer;
     class RHI_IndexBuffer;
     class RHI_ConstantBuffer;
+    class RHI_StructuredBuffer;
     class RHI_Sampler;
     class RHI_Viewport;
     class RHI_Texture;
@@ -234,6 +235,7 @@ namespace Spartan
         RHI_Descriptor_Sampler,
         RHI_Descriptor_Texture,
         RHI_Descriptor_ConstantBuffer,
+        RHI_Descriptor_StructuredBuffer,
         RHI_Descriptor_Undefined
     };
 
@@ -302,6 +304,7 @@ namespace Spartan
     static const uint8_t rhi_descriptor_max_constant_buffers_dynamic    = 10;
     static const uint8_t rhi_descriptor_max_samplers                    = 10;
     static const uint8_t rhi_descriptor_max_textures                    = 10;
+    static const uint8_t rhi_descriptor_max_storage_buffers             = 10;
     
     static const Math::Vector4  rhi_color_dont_care           = Math::Vector4(-std::numeric_limits<float>::infinity(), 0.0f, 0.0f, 0.0f);
     static const Math::Vector4  rhi_color_load                = Math::Vector4(std::numeric_limits<float>::infinity(), 0.0f, 0.0f, 0.0f);
@@ -114,6 +114,17 @@ namespace Spartan
         m_descriptor_layout_current->SetTexture(slot, texture, storage);
     }
 
+    void RHI_DescriptorCache::SetStructuredBuffer(const uint32_t slot, RHI_StructuredBuffer* structured_buffer)
+    {
+        if (!m_descriptor_layout_current)
+        {
+            LOG_ERROR("Invalid descriptor set layout");
+            return;
+        }
+
+        m_descriptor_layout_current->SetStructuredBuffer(slot, structured_buffer);
+    }
+
     void* RHI_DescriptorCache::GetResource_DescriptorSetLayout() const
     {
         if (!m_descriptor_layout_current)
@@ -45,6 +45,7 @@ namespace Spartan
         bool SetConstantBuffer(const uint32_t slot, RHI_ConstantBuffer* constant_buffer);
         void SetSampler(const uint32_t slot, RHI_Sampler* sampler);
         void SetTexture(const uint32_t slot, RHI_Texture* texture, const bool storage);
+        void SetStructuredBuffer(const uint32_t slot, RHI_StructuredBuffer* structured_buffer);
 
         // Properties
         void* GetResource_DescriptorSetPool() const { return m_descriptor_pool; }
@@ -25,6 +25,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "RHI_ConstantBuffer.h"
 #include "RHI_Sampler.h"
 #include "RHI_Texture.h"
+#include "RHI_StructuredBuffer.h"
 #include "RHI_Implementation.h"
 #include "RHI_DescriptorCache.h"
 #include "../Utilities/Hash.h"
@@ -134,6 +135,29 @@ namespace Spartan
         }
     }
 
+    void RHI_DescriptorSetLayout::SetStructuredBuffer(const uint32_t slot, RHI_StructuredBuffer* structured_buffer)
+    {
+        for (RHI_Descriptor& descriptor : m_descriptors)
+        {
+            // Structured buffers are bound to t registers, same as textures
+            if (descriptor.type == RHI_Descriptor_StructuredBuffer && descriptor.slot == slot + rhi_shader_shift_texture)
+            {
+                const uint64_t range = static_cast<uint64_t>(structured_buffer->GetStride()) * structured_buffer->GetElementCount();
+
+                // Determine if the descriptor set needs to bind
+                m_needs_to_bind = descriptor.resource   != structured_buffer->GetResource() ? true : m_needs_to_bind; // affects vkUpdateDescriptorSets
+                m_needs_to_bind = descriptor.range      != range                            ? true : m_needs_to_bind; // affects vkUpdateDescriptorSets
+
+                // Update
+                descriptor.resource = structured_buffer->GetResource();
+                descriptor.offset   = 0;
+                descriptor.range    = range;
+
+                break;
+            }
+        }
+    }
+
     bool RHI_DescriptorSetLayout::GetResource_DescriptorSet(RHI_DescriptorCache* descriptor_cache, void*& descriptor_set)
     {
         // Integrate resource into the hash
@@ -109,10 +109,11 @@ namespace Spartan
     template <typename T>
     void RHI_Shader::CompileAsync(const RHI_Shader_Type type, const string& shader)
     {
+        // Critical, as the renderer can't use the shader until it compiles
         m_context->GetSubsystem<Threading>()->AddTask([this, type, shader]()
         {
             Compile<T>(type, shader);
-        });
+        }, TaskPriority::Critical);
     }
 
     void RHI_Shader::WaitForCompilation()
@@ -68,7 +68,8 @@ namespace Spartan
 
         // If the existing file has a byte count but we 
         // hold no data, don't overwrite the file's bytes.
-        if (byte_count != 0 && m_data.empty())
+        const bool write_data = byte_count == 0 || !m_data.empty();
+        if (!write_data)
         {
             file->Skip
             (
@@ -77,12 +78,31 @@ namespace Spartan
                 byte_count            // bytes
             );
         }
-        else
-        {
-            byte_count = GetByteCount();
 
+        Serialize(file.get(), write_data);
+
+        return true;
+    }
+
+    bool RHI_Texture::SaveToMemory(string* data)
+    {
+        // The bytes are only in the existing file, which SaveToFile() has to keep
+        if (m_data.empty())
+            return false;
+
+        FileStream file("", FileStream_Memory | FileStream_Write);
+        Serialize(&file, true);
+        *data = file.GetMemory();
+
+        return true;
+    }
+
+    void RHI_Texture::Serialize(FileStream* file, const bool write_data)
+    {
+        if (write_data)
+        {
             // Write byte count
-            file->Write(byte_count);
+            file->Write(GetByteCount());
             // Write mipmap count
             file->Write(static_cast<uint32_t>(m_data.size()));
             // Write bytes
@@ -105,8 +125,6 @@ namespace Spartan
         file->Write(m_flags);
         file->Write(GetId());
         file->Write(GetResourceFilePath());
-
-        return true;
     }
 
     bool RHI_Texture::LoadFromFile(const string& path)
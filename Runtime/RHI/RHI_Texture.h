@@ -31,6 +31,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 namespace Spartan
 {
+    class FileStream;
+
     enum RHI_Texture_Flags : uint16_t
     {
         RHI_Texture_Sampled                    = 1 << 0,
@@ -58,6 +60,7 @@ namespace Spartan
 
         //= IResource ===========================================
         bool SaveToFile(const std::string& file_path) override;
+        bool SaveToMemory(std::string* data) override;
         bool LoadFromFile(const std::string& file_path) override;
         //=======================================================
 
@@ -151,6 +154,8 @@ namespace Spartan
         std::array<void*, rhi_max_render_target_count> m_resource_view_depthStencil           = { nullptr };
         std::array<void*, rhi_max_render_target_count> m_resource_view_depthStencilReadOnly   = { nullptr };
     private:
+        // Writes the mips (unless the file already has them) and the properties, the mips are freed afterwards
+        void Serialize(FileStream* file, bool write_data);
         uint32_t GetByteCount();
     };
 }
@@ -27,6 +27,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../RHI_VertexBuffer.h"
 #include "../RHI_IndexBuffer.h"
 #include "../RHI_ConstantBuffer.h"
+#include "../RHI_StructuredBuffer.h"
 #include "../RHI_Sampler.h"
 #include "../RHI_DescriptorCache.h"
 #include "../RHI_PipelineCache.h"
@@ -463,7 +464,7 @@ namespace Spartan
         return true;
     }
 
-    bool RHI_CommandList::DrawIndexed(const uint32_t index_count, const uint32_t index_offset, const uint32_t vertex_offset)
+    bool RHI_CommandList::DrawIndexed(const uint32_t index_count, const uint32_t index_offset, const uint32_t vertex_offset, const uint32_t instance_count)
     {
         if (m_cmd_state != RHI_CommandListState::Recording)
         {
@@ -478,7 +479,7 @@ namespace Spartan
         vkCmdDrawIndexed(
             static_cast<VkCommandBuffer>(m_cmd_buffer), // commandBuffer
             index_count,                                // indexCount
-            1,                                          // instanceCount
+            instance_count,                             // instanceCount
             index_offset,                               // firstIndex
             vertex_offset,                              // vertexOffset
             0                                           // firstInstance
@@ -748,6 +749,24 @@ namespace Spartan
         return static_cast<uint32_t>(device_memory_budget_properties.heapUsage[0] / 1024 / 1024); // MBs
     }
 
+    void RHI_CommandList::SetStructuredBuffer(const uint32_t slot, RHI_StructuredBuffer* structured_buffer) const
+    {
+        if (m_cmd_state != RHI_CommandListState::Recording)
+        {
+            LOG_ERROR("Command buffer is not recording.");
+            return;
+        }
+
+        if (!m_descriptor_cache->GetCurrentDescriptorSetLayout())
+        {
+            LOG_WARNING("Descriptor layout not set, try setting structured buffer \"%s\" within a render pass", structured_buffer->GetName().c_str());
+            return;
+        }
+
+        // Set (will only happen if it's not already set)
+        m_descriptor_cache->SetStructuredBuffer(slot, structured_buffer);
+    }
+
     bool RHI_CommandList::Timestamp_Start(void* query_disjoint /*= nullptr*/, void* query_start /*= nullptr*/)
     {
         if (m_cmd_state != RHI_CommandListState::Recording)
@@ -46,6 +46,10 @@ namespace Spartan
         {
             return VK_DESCRIPTOR_TYPE_SAMPLER;
         }
+        else if (descriptor.type == RHI_Descriptor_StructuredBuffer)
+        {
+            return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        }
 
         LOG_ERROR("Invalid descriptor type");
         return VK_DESCRIPTOR_TYPE_MAX_ENUM;
@@ -118,8 +122,8 @@ namespace Spartan
                 image_infos[i].imageView    = static_cast<VkImageView>(descriptor.resource);
                 image_infos[i].imageLayout  = descriptor.resource ? vulkan_image_layout[descriptor.layout] : VK_IMAGE_LAYOUT_UNDEFINED;
             }
-            // Constant/Uniform buffer
-            else if (descriptor.type == RHI_Descriptor_ConstantBuffer)
+            // Constant/Uniform buffer and structured/storage buffer
+            else if (descriptor.type == RHI_Descriptor_ConstantBuffer || descriptor.type == RHI_Descriptor_StructuredBuffer)
             {
                 buffer_infos[i].buffer  = static_cast<VkBuffer>(descriptor.resource);
                 buffer_infos[i].offset  = descriptor.offset;
@@ -112,6 +112,21 @@ namespace Spartan
         SetResourceFilePath(file_path);
 
         auto xml = make_unique<XmlDocument>();
+        Serialize(xml.get());
+
+        return xml->Save(GetResourceFilePathNative());
+    }
+
+    bool Material::SaveToMemory(string* data)
+    {
+        auto xml = make_unique<XmlDocument>();
+        Serialize(xml.get());
+
+        return xml->Save(data);
+    }
+
+    void Material::Serialize(XmlDocument* xml)
+    {
         xml->AddNode("Material");
         xml->AddAttribute("Material", "Color",                            m_color_albedo);
         xml->AddAttribute("Material", "Roughness_Multiplier",            GetProperty(Material_Roughness));
@@ -140,12 +155,12 @@ namespace Spartan
             xml->AddAttribute(tex_node, "Texture_Path", texture.second ? texture.second->GetResourceFilePathNative() : "");
             i++;
         }
-
-        return xml->Save(GetResourceFilePathNative());
     }
 
     void Material::SetTextureSlot(const Material_Property type, const shared_ptr<RHI_Texture>& texture, float multiplier /*= 1.0f*/)
     {
+        MakeDirty();
+
         if (texture)
         {
             // In order for the material to guarantee serialization/deserialization we cache the texture
@@ -219,13 +234,16 @@ namespace Spartan
 
     void Material::SetColorAlbedo(const Math::Vector4& color)
     {
-        // If an object switches from opaque to transparent or vice versa, make the world update so that the renderer
-        // goes through the entities and makes the ones that use this material, render in the correct mode.
-        if ((m_color_albedo.w != 1.0f && color.w == 1.0f) || (m_color_albedo.w == 1.0f && color.w != 1.0f))
-        {
-            m_context->GetSubsystem<World>()->MakeDirty();
-        }
+        MakeDirty();
 
+        // If the material switches from opaque to transparent or vice versa, let the world know about the renderables
+        // that use it, so that the renderer moves them to the right list (it uses the same test).
+        const bool transparency_changed = (m_color_albedo.w < 1.0f) != (color.w < 1.0f);
         m_color_albedo = color;
+
+        if (transparency_changed)
+        {
+            m_context->GetSubsystem<World>()->OnMaterialTransparencyChanged(this);
+        }
     }
 }
@@ -32,6 +32,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 namespace Spartan
 {
+    class XmlDocument;
+
     // Should I split these into properties and multipliers ?
     enum Material_Property : uint16_t
     {
@@ -61,6 +63,7 @@ namespace Spartan
         //= IResource ===========================================
         bool LoadFromFile(const std::string& file_path) override;
         bool SaveToFile(const std::string& file_path) override;
+        bool SaveToMemory(std::string* data) override;
         //=======================================================
 
         //= TEXTURES  ===========================================================================================================
@@ -80,21 +83,23 @@ namespace Spartan
         void SetColorAlbedo(const Math::Vector4& color);
 
         const Math::Vector2& GetTiling()                                    const { return m_uv_tiling; }
-        void SetTiling(const Math::Vector2& tiling)                         { m_uv_tiling = tiling; }
+        void SetTiling(const Math::Vector2& tiling)                         { m_uv_tiling = tiling; MakeDirty(); }
 
         const Math::Vector2& GetOffset()                                    const { return m_uv_offset; }
-        void SetOffset(const Math::Vector2& offset)                         { m_uv_offset = offset; }
+        void SetOffset(const Math::Vector2& offset)                         { m_uv_offset = offset; MakeDirty(); }
 
         auto IsEditable()                                                   const { return m_is_editable; }
         void SetIsEditable(const bool is_editable)                          { m_is_editable = is_editable; }
 
         auto& GetProperty(const Material_Property type)                     { return m_properties[type]; }
-        void SetProperty(const Material_Property type, const float value)   { m_properties[type] = value; }
+        void SetProperty(const Material_Property type, const float value)   { m_properties[type] = value; MakeDirty(); }
 
         uint16_t GetFlags()                                                 const { return m_flags; }
         //==================================================================================================
 
     private:
+        void Serialize(XmlDocument* xml);
+
         Math::Vector4 m_color_albedo    = Math::Vector4(1.0f, 1.0f, 1.0f, 1.0f);
         Math::Vector2 m_uv_tiling        = Math::Vector2(1.0f, 1.0f);
         Math::Vector2 m_uv_offset        = Math::Vector2(0.0f, 0.0f);
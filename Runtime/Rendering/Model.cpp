@@ -134,16 +134,30 @@ namespace Spartan
         if (!file->IsOpen())
             return false;
 
-        file->Write(GetResourceFilePath());
-        file->Write(m_normalized_scale);
-        file->Write(m_mesh->Indices_Get());
-        file->Write(m_mesh->Vertices_Get());
+        Serialize(file.get());
 
         file->Close();
 
         return true;
     }
 
+    bool Model::SaveToMemory(string* data)
+    {
+        FileStream file("", FileStream_Memory | FileStream_Write);
+        Serialize(&file);
+        *data = file.GetMemory();
+
+        return true;
+    }
+
+    void Model::Serialize(FileStream* file) const
+    {
+        file->Write(GetResourceFilePath());
+        file->Write(m_normalized_scale);
+        file->Write(m_mesh->Indices_Get());
+        file->Write(m_mesh->Vertices_Get());
+    }
+
     void Model::AppendGeometry(const vector<uint32_t>& indices, const vector<RHI_Vertex_PosTexNorTan>& vertices, uint32_t* index_offset, uint32_t* vertex_offset) const
     {
         if (indices.empty() || vertices.empty())
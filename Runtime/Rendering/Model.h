@@ -35,6 +35,7 @@ namespace Spartan
     class ResourceCache;
     class Entity;
     class Mesh;
+    class FileStream;
     namespace Math{ class BoundingBox; }
 
     class SPARTAN_CLASS Model : public IResource, public std::enable_shared_from_this<Model>
@@ -48,6 +49,7 @@ namespace Spartan
         //= IResource ===========================================
         bool LoadFromFile(const std::string& file_path) override;
         bool SaveToFile(const std::string& file_path) override;
+        bool SaveToMemory(std::string* data) override;
         //=======================================================
 
         // Geometry
@@ -82,6 +84,8 @@ namespace Spartan
         auto GetSharedPtr()                                  { return shared_from_this(); }
 
     private:
+        void Serialize(FileStream* file) const;
+
         // Geometry
         bool GeometryCreateBuffers();
         float GeometryComputeNormalizedScale() const;
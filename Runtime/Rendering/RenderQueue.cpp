@@ -0,0 +1,171 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ======================
+#include "Spartan.h"
+#include "RenderQueue.h"
+#include "../Threading/Threading.h"
+//=================================
+
+//= NAMESPACES ===============
+using namespace std;
+using namespace Spartan::Math;
+//============================
+
+namespace Spartan
+{
+    // Ids are handed out sequentially, so the low bits are the ones that tell them apart
+    static uint64_t fold_16(const uint32_t id)
+    {
+        return static_cast<uint64_t>((id ^ (id >> 16)) & 0xFFFF);
+    }
+
+    uint64_t RenderQueue::GetKey(const Renderer_Object_Type pass, const uint16_t variation, const uint32_t material_id, const uint32_t mesh_id, const float depth)
+    {
+        // A nan or an infinity can't be converted to an integer, such a depth goes last
+        const float depth_clamped = isfinite(depth) ? Helper::Saturate(depth) : 1.0f;
+
+        return
+            (static_cast<uint64_t>(pass & 0x3) << 62)               |
+            (static_cast<uint64_t>(variation & 0x3FFF) << 48)       |
+            (fold_16(material_id) << 32)                            |
+            (fold_16(mesh_id) << 16)                                |
+            static_cast<uint64_t>(depth_clamped * 65535.0f);
+    }
+
+    void RenderQueue::Clear()
+    {
+        m_packets.clear();
+        m_packets_sorted.clear();
+    }
+
+    void RenderQueue::Sort(Threading* threading)
+    {
+        const uint32_t count = GetCount();
+        m_items.resize(count);
+        m_items_scratch.resize(count);
+
+        uint64_t key_and = ~uint64_t(0);
+        uint64_t key_or  = 0;
+        for (uint32_t i = 0; i < count; i++)
+        {
+            m_items[i].key      = m_packets[i].key;
+            m_items[i].index    = i;
+            key_and            &= m_packets[i].key;
+            key_or             |= m_packets[i].key;
+        }
+
+        // Bytes which are the same in every key don't change the order, so they are skipped (the pass and often the variation)
+        const uint64_t key_varying = key_and ^ key_or;
+
+        // Below a few thousand packets, splitting the work costs more than it saves
+        const uint32_t chunk_count  = (threading && count >= 8192) ? Helper::Min<uint32_t>(threading->GetThreadCount() + 1, 16) : 1;
+        const uint32_t chunk_size   = (count + chunk_count - 1) / chunk_count;
+        m_histograms.resize(chunk_count * 256);
+
+        auto run = [threading, chunk_count](auto&& function)
+        {
+            if (chunk_count == 1)
+            {
+                function(0, 1);
+            }
+            else
+            {
+                threading->ParallelFor(chunk_count, function, 1);
+            }
+        };
+
+        // Least significant byte first, every pass is stable so the previous passes decide between equal bytes
+        SortItem* source        = m_items.data();
+        SortItem* destination   = m_items_scratch.data();
+        for (uint32_t shift = 0; shift < 64; shift += 8)
+        {
+            if (((key_varying >> shift) & 0xFF) == 0)
+                continue;
+
+            // Count the bytes of every chunk
+            run([this, source, shift, count, chunk_size](const uint32_t start, const uint32_t end)
+            {
+                for (uint32_t chunk = start; chunk < end; chunk++)
+                {
+                    uint32_t* histogram = &m_histograms[chunk * 256];
+                    fill(histogram, histogram + 256, 0);
+
+                    const uint32_t last = Helper::Min(count, (chunk + 1) * chunk_size);
+                    for (uint32_t i = chunk * chunk_size; i < last; i++)
+                    {
+                        histogram[(source[i].key >> shift) & 0xFF]++;
+                    }
+                }
+            });
+
+            // Turn the counts into where every chunk starts writing each byte value, chunks in order so that the pass is stable
+            uint32_t offset = 0;
+            for (uint32_t value = 0; value < 256; value++)
+            {
+                for (uint32_t chunk = 0; chunk < chunk_count; chunk++)
+                {
+                    uint32_t& histogram = m_histograms[chunk * 256 + value];
+                    const uint32_t value_count = histogram;
+                    histogram = offset;
+                    offset += value_count;
+                }
+            }
+
+            // Scatter
+            run([this, source, destination, shift, count, chunk_size](const uint32_t start, const uint32_t end)
+            {
+                for (uint32_t chunk = start; chunk < end; chunk++)
+                {
+                    uint32_t* histogram = &m_histograms[chunk * 256];
+
+                    const uint32_t last = Helper::Min(count, (chunk + 1) * chunk_size);
+                    for (uint32_t i = chunk * chunk_size; i < last; i++)
+                    {
+                        destination[histogram[(source[i].key >> shift) & 0xFF]++] = source[i];
+                    }
+                }
+            });
+
+            swap(source, destination);
+        }
+
+        // Lay the packets out in order, so that passes walk through memory linearly
+        m_packets_sorted.resize(count);
+        for (uint32_t i = 0; i < count; i++)
+        {
+            m_packets_sorted[i] = m_packets[source[i].index];
+        }
+    }
+
+    RenderPacketRange RenderQueue::GetPackets(const Renderer_Object_Type pass) const
+    {
+        // The pass is in the top bits of the key, so every pass is a contiguous range
+        auto pass_of = [](const RenderPacket& packet) { return static_cast<uint32_t>(packet.key >> 62); };
+        const auto first = partition_point(m_packets_sorted.begin(), m_packets_sorted.end(), [&](const RenderPacket& packet) { return pass_of(packet) < static_cast<uint32_t>(pass); });
+        const auto last  = partition_point(first, m_packets_sorted.end(), [&](const RenderPacket& packet) { return pass_of(packet) == static_cast<uint32_t>(pass); });
+
+        RenderPacketRange range;
+        range.first = m_packets_sorted.data() + (first - m_packets_sorted.begin());
+        range.last  = m_packets_sorted.data() + (last - m_packets_sorted.begin());
+        return range;
+    }
+}
@@ -0,0 +1,104 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ==============
+#include <vector>
+#include "Renderer_Enums.h"
+//=========================
+
+namespace Spartan
+{
+    class Entity;
+    class Renderable;
+    class Material;
+    class Model;
+    class Threading;
+
+    // Everything a pass needs to draw a renderable, gathered once when the queue is built
+    struct RenderPacket
+    {
+        uint64_t key            = 0;
+        Entity* entity          = nullptr;
+        Renderable* renderable  = nullptr;
+        Material* material      = nullptr; // can be null, depth only passes don't need it
+        const Model* model      = nullptr;
+    };
+
+    // A contiguous run of packets, so that passes can iterate them with a range based for loop
+    struct RenderPacketRange
+    {
+        const RenderPacket* first   = nullptr;
+        const RenderPacket* last    = nullptr;
+
+        const RenderPacket* begin()                         const { return first; }
+        const RenderPacket* end()                           const { return last; }
+        const RenderPacket& operator[](const uint32_t i)    const { return first[i]; }
+        uint32_t size()                                     const { return static_cast<uint32_t>(last - first); }
+        bool empty()                                        const { return first == last; }
+    };
+
+    // A run of packets which share the geometry (and the material), prepared ahead of the command list and drawn as one instanced draw
+    struct RenderDraw
+    {
+        uint32_t packet_index   = 0; // the first packet of the run, the instances are laid out in packet order
+        uint32_t instance_count = 0;
+    };
+
+    // The draws of a view, ordered by a 64-bit key so that state changes are grouped together and each group is drawn front to back.
+    // From the most significant bits to the least: pass (2), shader variation (14), material (16), mesh (16), depth (16).
+    // Material and mesh ids are folded to 16 bits, two of them can share a value, which only costs an extra state change.
+    class RenderQueue
+    {
+    public:
+        RenderQueue() = default;
+        ~RenderQueue() = default;
+
+        // The depth goes from the view's position (0) to it's far distance (1)
+        static uint64_t GetKey(Renderer_Object_Type pass, uint16_t variation, uint32_t material_id, uint32_t mesh_id, float depth);
+        static uint16_t GetVariation(const uint64_t key) { return static_cast<uint16_t>((key >> 48) & 0x3FFF); }
+
+        void Clear();
+        void Add(const RenderPacket& packet) { m_packets.emplace_back(packet); }
+
+        // Sorts the packets by their keys, a radix sort which splits the work between the threads when there is enough of it
+        void Sort(Threading* threading);
+
+        // The packets of a pass, in key order (valid after Sort())
+        RenderPacketRange GetPackets(Renderer_Object_Type pass) const;
+        uint32_t GetCount() const { return static_cast<uint32_t>(m_packets.size()); }
+
+    private:
+        // What the radix sort moves around, a key and where its packet is
+        struct SortItem
+        {
+            uint64_t key    = 0;
+            uint32_t index  = 0;
+        };
+
+        std::vector<RenderPacket> m_packets;
+        std::vector<RenderPacket> m_packets_sorted;
+        std::vector<SortItem> m_items;
+        std::vector<SortItem> m_items_scratch;
+        std::vector<uint32_t> m_histograms;
+    };
+}
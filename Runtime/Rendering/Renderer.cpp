@@ -28,7 +28,9 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Gizmos/Transform_Gizmo.h"
 #include "../Utilities/Sampling.h"
 #include "../Profiling/Profiler.h"
+#include "../Threading/Threading.h"
 #include "../Resource/ResourceCache.h"
+#include "../World/World.h"
 #include "../World/Entity.h"
 #include "../World/Components/Transform.h"
 #include "../World/Components/Renderable.h"
@@ -37,6 +39,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../RHI/RHI_Device.h"
 #include "../RHI/RHI_PipelineCache.h"
 #include "../RHI/RHI_ConstantBuffer.h"
+#include "../RHI/RHI_StructuredBuffer.h"
 #include "../RHI/RHI_CommandList.h"
 #include "../RHI/RHI_Texture2D.h"
 #include "../RHI/RHI_SwapChain.h"
@@ -84,14 +87,15 @@ namespace Spartan
         m_option_values[Option_Value_Fog]               = 0.1f;
 
         // Subscribe to events
-        SUBSCRIBE_TO_EVENT(EventType::WorldResolved,    EVENT_HANDLER_VARIANT(RenderablesAcquire));
-        SUBSCRIBE_TO_EVENT(EventType::WorldUnload,      EVENT_HANDLER(ClearEntities));
+        m_event_world_resolved  = SUBSCRIBE_TO_EVENT(EventType::WorldResolved,  EVENT_HANDLER_DATA(RenderablesAcquire));
+        m_event_world_unload    = SUBSCRIBE_TO_EVENT(EventType::WorldUnload,    EVENT_HANDLER(ClearEntities));
     }
 
     Renderer::~Renderer()
     {
         // Unsubscribe from events
-        UNSUBSCRIBE_FROM_EVENT(EventType::WorldResolved, EVENT_HANDLER_VARIANT(RenderablesAcquire));
+        UNSUBSCRIBE_FROM_EVENT(m_event_world_resolved);
+        UNSUBSCRIBE_FROM_EVENT(m_event_world_unload);
 
         m_entities.clear();
         m_camera = nullptr;
@@ -105,6 +109,7 @@ namespace Spartan
         // Get required systems        
         m_resource_cache    = m_context->GetSubsystem<ResourceCache>();
         m_profiler          = m_context->GetSubsystem<Profiler>();
+        m_threading         = m_context->GetSubsystem<Threading>();
 
         // Resolution, viewport and swapchain default to whatever the window size is
         const WindowData& window_data = m_context->m_engine->GetWindowData();
@@ -163,6 +168,7 @@ namespace Spartan
         m_gizmo_transform = make_unique<Transform_Gizmo>(m_context);
 
         CreateConstantBuffers();
+        CreateStructuredBuffers();
         CreateShaders();
         CreateDepthStencilStates();
         CreateRasterizerStates();
@@ -220,6 +226,7 @@ namespace Spartan
             m_buffer_frame_offset_index     = 0;
             m_buffer_light_offset_index     = 0;
             m_buffer_material_offset_index  = 0;
+            m_buffer_instances_offset       = 0;
         }
 
         // Update frame buffer
@@ -341,7 +348,7 @@ namespace Spartan
         // Re-create render textures
         CreateRenderTextures();
 
-        FIRE_EVENT(EventType::FrameResolutionChanged);
+        QUEUE_EVENT(EventType::FrameResolutionChanged);
 
         // Log
         LOG_INFO("Resolution set to %dx%d", width, height);
@@ -536,72 +543,361 @@ namespace Spartan
         return cmd_list->SetConstantBuffer(4, RHI_Shader_Pixel, m_buffer_light_gpu);
     }
 
-    void Renderer::RenderablesAcquire(const Variant& entities_variant)
+    bool Renderer::UpdateInstanceBuffer(RHI_CommandList* cmd_list, const uint32_t instance_count, uint32_t& instance_offset)
+    {
+        if (!cmd_list)
+        {
+            LOG_ERROR("Invalid command list");
+            return false;
+        }
+
+        if (instance_count == 0)
+            return true;
+
+        // Re-allocate buffer with double size (if needed)
+        const uint32_t instance_end = m_buffer_instances_offset + instance_count;
+        if (instance_end > m_buffer_instances_gpu->GetElementCount())
+        {
+            cmd_list->Flush();
+            const uint32_t new_size = Math::Helper::NextPowerOfTwo(instance_end);
+            if (!m_buffer_instances_gpu->Create<BufferInstance>(new_size))
+            {
+                LOG_ERROR("Failed to re-allocate %s buffer with %d elements", m_buffer_instances_gpu->GetName().c_str(), new_size);
+                return false;
+            }
+            LOG_INFO("Increased %s buffer elements to %d, that's %d kb", m_buffer_instances_gpu->GetName().c_str(), new_size, (new_size * m_buffer_instances_gpu->GetStride()) / 1000);
+        }
+
+        // Map
+        BufferInstance* buffer = static_cast<BufferInstance*>(m_buffer_instances_gpu->Map());
+        if (!buffer)
+        {
+            LOG_ERROR("Failed to map buffer");
+            return false;
+        }
+
+        // Update, the instances of the passes which are still in flight live before the offset, so they are left untouched
+        const uint64_t size     = static_cast<uint64_t>(instance_count) * sizeof(BufferInstance);
+        const uint64_t offset   = static_cast<uint64_t>(m_buffer_instances_offset) * sizeof(BufferInstance);
+        memcpy(buffer + m_buffer_instances_offset, m_buffer_instances_cpu.data(), size);
+
+        instance_offset             = m_buffer_instances_offset;
+        m_buffer_instances_offset   = instance_end;
+
+        // Unmap
+        return m_buffer_instances_gpu->Unmap(offset, size);
+    }
+
+    void Renderer::RenderablesAcquire(const EventData& data)
     {
         SCOPED_TIME_BLOCK(m_profiler);
 
-        // Clear previous state
-        m_entities.clear();
-        m_camera = nullptr;
+        const WorldResolveDelta& delta = data.Get<WorldResolveDelta>();
 
-        vector<shared_ptr<Entity>> entities = entities_variant.Get<vector<shared_ptr<Entity>>>();
-        for (const auto& entity : entities)
+        if (delta.full)
         {
-            if (!entity || !entity->IsActive())
+            RenderablesAcquireAll();
+            return;
+        }
+
+        // Entities which left a list, gathered first so that each list is compacted in a single pass
+        array<unordered_set<Entity*>, Renderer_Object_Count> removals;
+
+        // Removed entities might already be destroyed, so only their pointer is used
+        for (Entity* entity : delta.removed)
+        {
+            auto it = m_entity_lists.find(entity);
+            if (it == m_entity_lists.end())
                 continue;
 
-            // Get all the components we are interested in
-            Renderable* renderable  = entity->GetComponent<Renderable>();
-            Light* light            = entity->GetComponent<Light>();
-            Camera* camera          = entity->GetComponent<Camera>();
+            for (uint32_t type = 0; type < Renderer_Object_Count; type++)
+            {
+                if (it->second & (1 << type))
+                {
+                    removals[type].insert(entity);
+                }
+            }
+
+            m_entity_lists.erase(it);
+        }
+
+        // Changed entities are re-classified and moved between lists as needed
+        for (Entity* entity : delta.changed)
+        {
+            uint32_t& lists_previous = m_entity_lists[entity];
+            const uint32_t lists     = RenderablesClassify(entity);
 
-            if (renderable)
+            for (uint32_t type = 0; type < Renderer_Object_Count; type++)
             {
-                bool is_transparent = false;
+                const uint32_t bit = 1 << type;
 
-                if (const Material* material = renderable->GetMaterial())
+                if ((lists_previous & bit) && !(lists & bit))
+                {
+                    removals[type].insert(entity);
+                }
+                else if (!(lists_previous & bit) && (lists & bit))
                 {
-                    is_transparent = material->GetColorAlbedo().w < 1.0f;
+                    // A new entity can be allocated where a removed one was, in which case it's already in the list
+                    if (removals[type].erase(entity) == 0)
+                    {
+                        m_entities[static_cast<Renderer_Object_Type>(type)].emplace_back(entity);
+                    }
                 }
+            }
 
-                m_entities[is_transparent ? Renderer_Object_Transparent : Renderer_Object_Opaque].emplace_back(entity.get());
+            if (lists == 0)
+            {
+                m_entity_lists.erase(entity);
+            }
+            else
+            {
+                lists_previous = lists;
             }
+        }
+
+        for (uint32_t type = 0; type < Renderer_Object_Count; type++)
+        {
+            if (removals[type].empty())
+                continue;
+
+            vector<Entity*>& entities = m_entities[static_cast<Renderer_Object_Type>(type)];
+            const unordered_set<Entity*>& removed = removals[type];
+            entities.erase(remove_if(entities.begin(), entities.end(), [&removed](Entity* entity) { return removed.count(entity) != 0; }), entities.end());
+        }
+
+        // The active camera is the last one in the list, same as a full acquire
+        const vector<Entity*>& cameras = m_entities[Renderer_Object_Camera];
+        m_camera = cameras.empty() ? nullptr : cameras.back()->GetComponent<Camera>()->GetPtrShared<Camera>();
+    }
+
+    void Renderer::RenderablesAcquireAll()
+    {
+        // Clear previous state
+        m_entities.clear();
+        m_entity_lists.clear();
+        m_camera = nullptr;
+
+        // Walk the component pools of the types we are interested in, instead of every entity
+        const World* world = m_context->GetSubsystem<World>();
+
+        world->View<Renderable>().Each([this](Renderable* renderable)
+        {
+            Entity* entity = renderable->GetEntity();
+            if (!entity->IsActive())
+                return;
+
+            const uint32_t lists            = RenderablesClassify(entity);
+            const Renderer_Object_Type type = (lists & (1 << Renderer_Object_Transparent)) ? Renderer_Object_Transparent : Renderer_Object_Opaque;
+            m_entities[type].emplace_back(entity);
+            m_entity_lists[entity] |= 1 << type;
+        });
 
-            if (light)
+        world->View<Light>().Each([this](Light* light)
+        {
+            if (light->GetEntity()->IsActive())
             {
-                m_entities[Renderer_Object_Light].emplace_back(entity.get());
+                m_entities[Renderer_Object_Light].emplace_back(light->GetEntity());
+                m_entity_lists[light->GetEntity()] |= 1 << Renderer_Object_Light;
             }
+        });
 
-            if (camera)
+        world->View<Camera>().Each([this](Camera* camera)
+        {
+            if (camera->GetEntity()->IsActive())
             {
-                m_entities[Renderer_Object_Camera].emplace_back(entity.get());
+                m_entities[Renderer_Object_Camera].emplace_back(camera->GetEntity());
+                m_entity_lists[camera->GetEntity()] |= 1 << Renderer_Object_Camera;
                 m_camera = camera->GetPtrShared<Camera>();
             }
+        });
+    }
+
+    uint32_t Renderer::RenderablesClassify(Entity* entity)
+    {
+        if (!entity->IsActive())
+            return 0;
+
+        uint32_t lists = 0;
+
+        if (Renderable* renderable = entity->GetRenderable())
+        {
+            bool is_transparent = false;
+
+            if (const Material* material = renderable->GetMaterial())
+            {
+                is_transparent = material->GetColorAlbedo().w < 1.0f;
+            }
+
+            lists |= 1 << (is_transparent ? Renderer_Object_Transparent : Renderer_Object_Opaque);
         }
 
-        RenderablesSort(&m_entities[Renderer_Object_Opaque]);
-        RenderablesSort(&m_entities[Renderer_Object_Transparent]);
+        if (entity->GetComponent<Light>())
+        {
+            lists |= 1 << Renderer_Object_Light;
+        }
+
+        if (entity->GetComponent<Camera>())
+        {
+            lists |= 1 << Renderer_Object_Camera;
+        }
+
+        return lists;
     }
 
-    void Renderer::RenderablesSort(vector<Entity*>* renderables)
+    void Renderer::RenderablesCull()
     {
-        if (!m_camera || renderables->size() <= 2)
-            return;
+        SCOPED_TIME_BLOCK(m_profiler);
 
-        auto comparison_op = [this](Entity* entity)
+        const vector<Entity*>& entities_opaque      = m_entities[Renderer_Object_Opaque];
+        const vector<Entity*>& entities_transparent = m_entities[Renderer_Object_Transparent];
+        const uint32_t count_opaque                 = static_cast<uint32_t>(entities_opaque.size());
+        const uint32_t count                        = count_opaque + static_cast<uint32_t>(entities_transparent.size());
+        const uint32_t word_count                   = (count + 63) / 64;
+
+        // Views, the camera's and then one for every shadow map slice
+        m_view_count = 0;
+        m_view_light_first.clear();
+        auto view_add = [this, word_count](const Frustum& frustum, const Matrix& view_matrix, const float far_plane, const bool ignore_near_plane, const bool depth_only)
         {
-            auto renderable = entity->GetRenderable();
-            if (!renderable)
-                return 0.0f;
+            if (m_view_count == m_views.size())
+            {
+                m_views.emplace_back();
+            }
+
+            // The third column of a view matrix is it's forward axis, so this doesn't depend on the projection (orthographic or reverse-z)
+            const float far_inverse = far_plane > 0.0f ? 1.0f / far_plane : 0.0f;
+            const Vector3 forward   = Vector3(view_matrix.m02, view_matrix.m12, view_matrix.m22);
 
-            return (renderable->GetAabb().GetCenter() - m_camera->GetTransform()->GetPosition()).LengthSquared();
+            RendererView& view      = m_views[m_view_count++];
+            view.frustum            = frustum;
+            view.depth_plane        = Plane(forward * far_inverse, view_matrix.m32 * far_inverse);
+            view.ignore_near_plane  = ignore_near_plane;
+            view.depth_only         = depth_only;
+            view.visible_bits.resize(word_count);
         };
 
-        // Sort by depth (front to back)
-        sort(renderables->begin(), renderables->end(), [&comparison_op](Entity* a, Entity* b)
+        view_add(m_camera->GetFrustum(), m_camera->GetViewMatrix(), m_camera->GetFarPlane(), false, false);
+        for (Entity* entity : m_entities[Renderer_Object_Light])
         {
-            return comparison_op(a) < comparison_op(b);
+            const Light* light = entity->GetComponent<Light>();
+            if (!light || !light->GetShadowsEnabled())
+                continue;
+
+            // Ensure that potential shadow casters from behind the near plane of a directional light are not rejected
+            const bool ignore_near_plane = light->GetLightType() == LightType::Directional;
+
+            m_view_light_first[light] = m_view_count;
+            for (uint32_t i = 0; i < light->GetShadowArraySize(); i++)
+            {
+                view_add(light->GetFrustum(i), light->GetViewMatrix(i), light->GetShadowFarPlane(i), ignore_near_plane, true);
+            }
+        }
+
+        // Number the renderables, a renderable's index is it's bit in the views, and resolve their bounds once
+        m_cull_centers.resize(count);
+        m_threading->ParallelFor(count, [this, &entities_opaque, &entities_transparent, count_opaque](const uint32_t start, const uint32_t end)
+        {
+            for (uint32_t i = start; i < end; i++)
+            {
+                Entity* entity          = i < count_opaque ? entities_opaque[i] : entities_transparent[i - count_opaque];
+                Renderable* renderable  = entity->GetRenderable();
+                m_cull_centers[i]       = renderable ? renderable->GetAabb().GetCenter() : Vector3::Zero;
+
+                if (renderable)
+                {
+                    renderable->SetCullIndex(i);
+                }
+            }
         });
+
+        // Query the world's bounding volume hierarchy with every view, subtrees outside of a view are skipped as a whole
+        const World* world = m_context->GetSubsystem<World>();
+        m_threading->ParallelFor(m_view_count, [this, world, &entities_opaque, &entities_transparent, count_opaque, count](const uint32_t start, const uint32_t end)
+        {
+            for (uint32_t i = start; i < end; i++)
+            {
+                RendererView& view = m_views[i];
+                fill(view.visible_bits.begin(), view.visible_bits.end(), 0);
+
+                world->QueryRenderables(view.frustum, view.ignore_near_plane, [&](Renderable* renderable)
+                {
+                    // The tree also has the renderables that aren't in the lists (e.g. inactive ones), their index is stale
+                    const uint32_t index = renderable->GetCullIndex();
+                    if (index >= count)
+                        return;
+
+                    const Entity* entity = index < count_opaque ? entities_opaque[index] : entities_transparent[index - count_opaque];
+                    if (entity->GetRenderable() != renderable)
+                        return;
+
+                    view.visible_bits[index / 64] |= uint64_t(1) << (index % 64);
+                });
+            }
+        }, 1);
+
+        // Turn the bits into render queues
+        m_threading->ParallelFor(m_view_count, [this, &entities_opaque, &entities_transparent, count_opaque, word_count](const uint32_t start, const uint32_t end)
+        {
+            for (uint32_t i = start; i < end; i++)
+            {
+                RendererView& view = m_views[i];
+                view.queue.Clear();
+
+                for (uint32_t word = 0; word < word_count; word++)
+                {
+                    uint64_t bits = view.visible_bits[word];
+                    for (uint32_t index = word * 64; bits != 0; index++, bits >>= 1)
+                    {
+                        if (!(bits & 1))
+                            continue;
+
+                        const bool is_opaque        = index < count_opaque;
+                        Entity* entity              = is_opaque ? entities_opaque[index] : entities_transparent[index - count_opaque];
+                        Renderable* renderable      = entity->GetRenderable();
+                        if (!renderable || (view.depth_only && !renderable->GetCastShadows()))
+                            continue;
+
+                        const Model* model = renderable->GeometryModel();
+                        if (!model || !model->GetVertexBuffer() || !model->GetIndexBuffer())
+                            continue;
+
+                        RenderPacket packet;
+                        packet.entity       = entity;
+                        packet.renderable   = renderable;
+                        packet.material     = renderable->GetMaterial();
+                        packet.model        = model;
+
+                        // Depth only views don't need the shader variation, nor the material of opaque objects, so they group by mesh instead
+                        const Renderer_Object_Type pass = is_opaque ? Renderer_Object_Opaque : Renderer_Object_Transparent;
+                        const bool material_bound       = packet.material && (!view.depth_only || !is_opaque);
+                        const uint16_t variation        = packet.material && !view.depth_only ? packet.material->GetFlags() : 0;
+                        const uint32_t material_id      = material_bound ? packet.material->GetId() : 0;
+                        const uint32_t mesh_id          = model->GetId() * 31 + renderable->GeometryIndexOffset();
+                        const float depth               = Vector3::Dot(view.depth_plane.normal, m_cull_centers[index]) + view.depth_plane.d;
+                        packet.key                      = RenderQueue::GetKey(pass, variation, material_id, mesh_id, depth);
+
+                        view.queue.Add(packet);
+                    }
+                }
+            }
+        }, 1);
+
+        // Sort them one after the other, the big ones split the work between the threads
+        for (uint32_t i = 0; i < m_view_count; i++)
+        {
+            m_views[i].queue.Sort(m_threading);
+        }
+
+        m_profiler->m_renderer_meshes_culled += count - GetViewCamera().queue.GetCount();
+    }
+
+    const Renderer::RendererView* Renderer::GetViewLight(const Light* light, const uint32_t array_index) const
+    {
+        const auto it = m_view_light_first.find(light);
+        if (it == m_view_light_first.end() || it->second + array_index >= m_view_count)
+            return nullptr;
+
+        return &m_views[it->second + array_index];
     }
 
     void Renderer::ClearEntities()
@@ -616,6 +912,7 @@ namespace Spartan
         }
 
         m_entities.clear();
+        m_entity_lists.clear();
     }
 
     const shared_ptr<Spartan::RHI_Texture>& Renderer::GetEnvironmentTexture()
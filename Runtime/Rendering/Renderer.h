@@ -28,8 +28,11 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Renderer_ConstantBuffers.h"
 #include "Renderer_Enums.h"
 #include "Material.h"
+#include "RenderQueue.h"
 #include "../Core/ISubsystem.h"
+#include "../Core/EventSystem.h"
 #include "../Math/Rectangle.h"
+#include "../Math/Frustum.h"
 #include "../RHI/RHI_Definition.h"
 #include "../RHI/RHI_Viewport.h"
 #include "../RHI/RHI_Vertex.h"
@@ -43,15 +46,14 @@ namespace Spartan
     class Light;
     class ResourceCache;
     class Font;
-    class Variant;
     class Grid;
     class Transform_Gizmo;
     class Profiler;
+    class Threading;
 
     namespace Math
     {
         class BoundingBox;
-        class Frustum;
     }
 
     class SPARTAN_CLASS Renderer : public ISubsystem
@@ -154,6 +156,7 @@ namespace Spartan
     private:
         // Resource creation
         void CreateConstantBuffers();
+        void CreateStructuredBuffers();
         void CreateDepthStencilStates();
         void CreateRasterizerStates();
         void CreateBlendStates();
@@ -203,10 +206,13 @@ namespace Spartan
         bool UpdateUberBuffer(RHI_CommandList* cmd_list);
         bool UpdateObjectBuffer(RHI_CommandList* cmd_list);
         bool UpdateLightBuffer(RHI_CommandList* cmd_list, const Light* light);
+        bool UpdateInstanceBuffer(RHI_CommandList* cmd_list, const uint32_t instance_count, uint32_t& instance_offset);
 
         // Misc
-        void RenderablesAcquire(const Variant& renderables);
-        void RenderablesSort(std::vector<Entity*>* renderables);
+        void RenderablesAcquire(const EventData& data);
+        void RenderablesAcquireAll();
+        uint32_t RenderablesClassify(Entity* entity);
+        void RenderablesCull();
         void ClearEntities();
 
         // Render textures
@@ -323,13 +329,61 @@ namespace Spartan
         uint32_t m_buffer_light_offset_index = 0;
         //========================================================
 
+        // Instancing, the per instance data of every pass is appended to a single structured buffer
+        std::vector<BufferInstance> m_buffer_instances_cpu;
+        std::shared_ptr<RHI_StructuredBuffer> m_buffer_instances_gpu;
+        uint32_t m_buffer_instances_offset = 0;
+
         // Entities and material references
         std::unordered_map<Renderer_Object_Type, std::vector<Entity*>> m_entities;
+        std::unordered_map<Entity*, uint32_t> m_entity_lists; // which of the above lists an entity is in, as a bit mask of Renderer_Object_Type
         std::array<Material*, m_max_material_instances> m_material_instances;    
         std::shared_ptr<Camera> m_camera;
 
+        // Scratch space for batched matrix math
+        std::vector<Math::Matrix> m_matrices_world;
+        std::vector<Math::Matrix> m_matrices_wvp;
+
+        // A frustum that the renderables are culled against, and the draws of what it sees
+        struct RendererView
+        {
+            Math::Frustum frustum;
+            Math::Plane depth_plane; // the view space depth of a point divided by the far distance, which is what the queue's keys sort by
+            bool ignore_near_plane = false;
+            bool depth_only        = false; // shadow map slices, they only bind materials for transparent objects
+            std::vector<uint64_t> visible_bits; // the opaque renderables, followed by the transparent ones
+            RenderQueue queue;
+        };
+        const RendererView& GetViewCamera() const { return m_views[0]; }
+        const RendererView* GetViewLight(const Light* light, uint32_t array_index) const;
+
+        // Culling, the camera's view comes first and it's followed by the views of every shadow map slice
+        std::vector<RendererView> m_views;
+        uint32_t m_view_count = 0;
+        std::unordered_map<const Light*, uint32_t> m_view_light_first;
+        std::vector<Math::Vector3> m_cull_centers; // the centers of the renderables' bounds, which the queues sort by depth
+
+        // Draws which are prepared in parallel chunks ahead of the command list, and recorded on it in order
+        struct ShadowSlice
+        {
+            const Light* light          = nullptr;
+            const RendererView* view    = nullptr;
+            uint32_t array_index        = 0;
+            uint32_t instance_offset    = 0;
+            Math::Matrix view_projection;
+            std::vector<RenderDraw> draws;
+        };
+        std::vector<RenderDraw> m_draws;
+        std::vector<std::vector<RenderDraw>> m_draws_chunks;
+        std::vector<ShadowSlice> m_shadow_slices;
+
+        // Events
+        EventHandle m_event_world_resolved;
+        EventHandle m_event_world_unload;
+
         // Dependencies
         Profiler* m_profiler            = nullptr;
         ResourceCache* m_resource_cache = nullptr;
+        Threading* m_threading          = nullptr;
     };
 }
@@ -174,17 +174,29 @@ namespace Spartan
         Math::Matrix object;
         Math::Matrix wvp_current;
         Math::Matrix wvp_previous;
+
+        uint32_t instance_offset = 0; // where an instanced draw's instances start in the instance buffer
+        Math::Vector3 padding;
     
         bool operator==(const BufferObject& rhs) const
         {
             return
                 object          == rhs.object       &&
                 wvp_current     == rhs.wvp_current  &&
-                wvp_previous    == rhs.wvp_previous;
+                wvp_previous    == rhs.wvp_previous &&
+                instance_offset == rhs.instance_offset;
         }
 
         bool operator!=(const BufferObject& rhs) const { return !(*this == rhs); }
     };
+
+    // Per instance data of instanced draws, an element of the instance (structured) buffer
+    struct BufferInstance
+    {
+        Math::Matrix object;
+        Math::Matrix wvp_current;
+        Math::Matrix wvp_previous;
+    };
     
     // Light buffer
     struct BufferLight
@@ -68,7 +68,10 @@ namespace Spartan
         tex                = 30,
         tex2               = 31,
         font_atlas         = 32,
-        ssgi               = 33
+        ssgi               = 33,
+
+        // Instancing
+        instances          = 34
     };
 
     // Unordered access views bindings
@@ -223,6 +226,7 @@ namespace Spartan
         Renderer_Object_Opaque,
         Renderer_Object_Transparent,
         Renderer_Object_Light,
-        Renderer_Object_Camera
+        Renderer_Object_Camera,
+        Renderer_Object_Count
     };
 }
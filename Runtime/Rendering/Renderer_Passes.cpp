@@ -34,6 +34,8 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../RHI/RHI_VertexBuffer.h"
 #include "../RHI/RHI_PipelineState.h"
 #include "../RHI/RHI_Texture.h"
+#include "../Threading/Threading.h"
+#include "../World/World.h"
 #include "../World/Entity.h"
 #include "../World/Components/Camera.h"
 #include "../World/Components/Light.h"
@@ -48,6 +50,88 @@ using namespace Spartan::Math;
 
 namespace Spartan
 {
+    // Whether two packets draw the same geometry (and the same material), so that they can go out as one instanced draw
+    static bool is_instanceable(const RenderPacket& a, const RenderPacket& b, const bool match_material)
+    {
+        if (a.model != b.model)
+            return false;
+
+        if (a.renderable->GeometryIndexOffset()   != b.renderable->GeometryIndexOffset()   ||
+            a.renderable->GeometryIndexCount()    != b.renderable->GeometryIndexCount()    ||
+            a.renderable->GeometryVertexOffset()  != b.renderable->GeometryVertexOffset())
+            return false;
+
+        // Packets without a material are skipped, so they are never mixed with ones that have one
+        return match_material ? a.material == b.material : (a.material == nullptr) == (b.material == nullptr);
+    }
+
+    // Splits packets [start, end) into runs of instanceable packets and appends a draw for each run
+    static void prepare_draws(const RenderPacketRange& packets, const uint32_t start, const uint32_t end, const bool match_material, vector<RenderDraw>& draws)
+    {
+        for (uint32_t i = start; i < end;)
+        {
+            RenderDraw draw;
+            draw.packet_index   = i;
+            draw.instance_count = 1;
+            while (i + draw.instance_count < end && is_instanceable(packets[i], packets[i + draw.instance_count], match_material))
+            {
+                draw.instance_count++;
+            }
+
+            draws.emplace_back(draw);
+            i += draw.instance_count;
+        }
+    }
+
+    // Prepares the draws of a pass in chunks which run in parallel, and stitches them back together in packet order.
+    // Only the preparation is parallel, the command list is still recorded by the calling thread.
+    // Every chunk writes the instances of it's own packets (fill_instances) and it's own list of draws, so the threads share nothing.
+    // Transforms are resolved by the culling that comes before, so reading them from many threads doesn't update anything.
+    template<typename Function>
+    static void prepare_draws_parallel(Threading* threading, const RenderPacketRange& packets, const bool match_material, vector<vector<RenderDraw>>& chunks, vector<RenderDraw>& draws, Function&& fill_instances)
+    {
+        draws.clear();
+        if (packets.empty())
+            return;
+
+        // Chunks are aligned to the grain size, so the start of a chunk identifies it's list
+        const uint32_t grain_size   = 256;
+        const uint32_t chunk_count  = (packets.size() - 1) / grain_size + 1;
+        if (chunks.size() < chunk_count)
+        {
+            chunks.resize(chunk_count);
+        }
+        for (uint32_t i = 0; i < chunk_count; i++)
+        {
+            chunks[i].clear();
+        }
+
+        threading->ParallelFor(packets.size(), [&](const uint32_t start, const uint32_t end)
+        {
+            fill_instances(start, end);
+            prepare_draws(packets, start, end, match_material, chunks[start / grain_size]);
+        }, grain_size);
+
+        for (uint32_t i = 0; i < chunk_count; i++)
+        {
+            for (const RenderDraw& draw : chunks[i])
+            {
+                // Join the runs which were split by a chunk boundary
+                if (!draws.empty())
+                {
+                    RenderDraw& draw_previous = draws.back();
+                    if (draw_previous.packet_index + draw_previous.instance_count == draw.packet_index && is_instanceable(packets[draw_previous.packet_index], packets[draw.packet_index], match_material))
+                    {
+                        draw_previous.instance_count += draw.instance_count;
+                        continue;
+                    }
+                }
+
+                draws.emplace_back(draw);
+            }
+        }
+    }
+
     void Renderer::SetGlobalSamplersAndConstantBuffers(RHI_CommandList* cmd_list) const
     {
         // Constant buffers
@@ -81,6 +165,9 @@ namespace Spartan
         Pass_BrdfSpecularLut(cmd_list);
         
         const bool draw_transparent_objects = !m_entities[Renderer_Object_Transparent].empty();
+
+        // Cull against all the views at once, the passes below only walk what's visible
+        RenderablesCull();
         
         // Depth
         {
@@ -143,13 +230,14 @@ namespace Spartan
             return;
 
         // Get entities
-        const auto& entities = m_entities[object_type];
-        if (entities.empty())
+        if (m_entities[object_type].empty())
             return;
 
         const bool transparent_pass = object_type == Renderer_Object_Transparent;
 
-        // Go through all of the lights
+        // Gather the shadow map slices of all the lights, the packets of each slice are laid out one after the other as instances
+        m_shadow_slices.clear();
+        uint32_t instance_count = 0;
         const auto& entities_light = m_entities[Renderer_Object_Light];
         for (uint32_t light_index = 0; light_index < entities_light.size(); light_index++)
         {
@@ -165,10 +253,59 @@ namespace Spartan
 
             // Acquire light's shadow maps
             RHI_Texture* tex_depth = light->GetDepthTexture();
-            RHI_Texture* tex_color = light->GetColorTexture();
             if (!tex_depth)
                 continue;
 
+            for (uint32_t array_index = 0; array_index < tex_depth->GetArraySize(); array_index++)
+            {
+                // The objects which are inside the view frustum
+                const RendererView* view = GetViewLight(light, array_index);
+                if (!view)
+                    continue;
+
+                ShadowSlice& slice      = m_shadow_slices.emplace_back();
+                slice.light             = light;
+                slice.view              = view;
+                slice.array_index       = array_index;
+                slice.instance_offset   = instance_count;
+                slice.view_projection   = light->GetViewMatrix(array_index) * light->GetProjectionMatrix(array_index);
+
+                instance_count += view->queue.GetPackets(object_type).size();
+            }
+        }
+
+        // Prepare the draws of every slice in parallel, a slice only writes it's own instances and it's own draws
+        m_buffer_instances_cpu.resize(instance_count);
+        m_threading->ParallelFor(static_cast<uint32_t>(m_shadow_slices.size()), [this, object_type, transparent_pass](const uint32_t start, const uint32_t end)
+        {
+            for (uint32_t slice_index = start; slice_index < end; slice_index++)
+            {
+                ShadowSlice& slice = m_shadow_slices[slice_index];
+                const RenderPacketRange packets = slice.view->queue.GetPackets(object_type);
+
+                // Every packet is an instance, transformed by the cascade
+                for (uint32_t i = 0; i < packets.size(); i++)
+                {
+                    m_buffer_instances_cpu[slice.instance_offset + i].wvp_current = packets[i].entity->GetTransform()->GetMatrix() * slice.view_projection;
+                }
+
+                // The shadow casters, grouped by mesh (and by material for transparent ones)
+                slice.draws.clear();
+                prepare_draws(packets, 0, packets.size(), transparent_pass, slice.draws);
+            }
+        }, 1);
+
+        uint32_t instance_offset = 0;
+        if (!UpdateInstanceBuffer(cmd_list, instance_count, instance_offset))
+            return;
+
+        // Replay the draws, in order
+        for (const ShadowSlice& slice : m_shadow_slices)
+        {
+            const Light* light      = slice.light;
+            RHI_Texture* tex_depth  = light->GetDepthTexture();
+            RHI_Texture* tex_color  = light->GetColorTexture();
+
             // Set render state
             static RHI_PipelineState pipeline_state;
             pipeline_state.shader_vertex                    = shader_v;
@@ -183,101 +320,82 @@ namespace Spartan
             pipeline_state.primitive_topology               = RHI_PrimitiveTopology_TriangleList;
             pipeline_state.pass_name                        = transparent_pass ? "Pass_LightDepthTransparent" : "Pass_LightDepth";
 
-            for (uint32_t array_index = 0; array_index < tex_depth->GetArraySize(); array_index++)
+            // Set render target texture array index
+            pipeline_state.render_target_color_texture_array_index          = slice.array_index;
+            pipeline_state.render_target_depth_stencil_texture_array_index  = slice.array_index;
+
+            // Set clear values
+            pipeline_state.clear_color[0] = Vector4::One;
+            pipeline_state.clear_depth    = transparent_pass ? rhi_depth_load : GetClearDepth();
+
+            // Set appropriate rasterizer state
+            if (light->GetLightType() == LightType::Directional)
             {
-                // Set render target texture array index
-                pipeline_state.render_target_color_texture_array_index          = array_index;
-                pipeline_state.render_target_depth_stencil_texture_array_index  = array_index;
+                // "Pancaking" - https://www.gamedev.net/forums/topic/639036-shadow-mapping-and-high-up-objects/
+                // It's basically a way to capture the silhouettes of potential shadow casters behind the light's view point.
+                // Of course we also have to make sure that the light doesn't cull them in the first place (this is done automatically by the light)
+                pipeline_state.rasterizer_state = m_rasterizer_light_directional.get();
+            }
+            else
+            {
+                pipeline_state.rasterizer_state = m_rasterizer_light_point_spot.get();
+            }
 
-                // Set clear values
-                pipeline_state.clear_color[0] = Vector4::One;
-                pipeline_state.clear_depth    = transparent_pass ? rhi_depth_load : GetClearDepth();
+            // State tracking
+            bool render_pass_active     = false;
+            uint32_t m_set_material_id  = 0;
 
-                const Matrix& view_projection = light->GetViewMatrix(array_index) * light->GetProjectionMatrix(array_index);
+            const RenderPacketRange packets = slice.view->queue.GetPackets(object_type);
+            for (const RenderDraw& draw : slice.draws)
+            {
+                const RenderPacket& packet      = packets[draw.packet_index];
+                const Renderable* renderable    = packet.renderable;
+                const Model* model              = packet.model;
 
-                // Set appropriate rasterizer state
-                if (light->GetLightType() == LightType::Directional)
-                {
-                    // "Pancaking" - https://www.gamedev.net/forums/topic/639036-shadow-mapping-and-high-up-objects/
-                    // It's basically a way to capture the silhouettes of potential shadow casters behind the light's view point.
-                    // Of course we also have to make sure that the light doesn't cull them in the first place (this is done automatically by the light)
-                    pipeline_state.rasterizer_state = m_rasterizer_light_directional.get();
-                }
-                else
+                // Acquire material
+                const Material* material = packet.material;
+                if (!material)
+                    continue;
+
+                if (!render_pass_active)
                 {
-                    pipeline_state.rasterizer_state = m_rasterizer_light_point_spot.get();
+                    render_pass_active = cmd_list->BeginRenderPass(pipeline_state);
+                    cmd_list->SetStructuredBuffer(RendererBindingsSrv::instances, m_buffer_instances_gpu);
                 }
 
-                // State tracking
-                bool render_pass_active     = false;
-                uint32_t m_set_material_id  = 0;
-
-                for (uint32_t entity_index = 0; entity_index < static_cast<uint32_t>(entities.size()); entity_index++)
+                // Bind material
+                if (transparent_pass && m_set_material_id != material->GetId())
                 {
-                    Entity* entity = entities[entity_index];
-
-                    // Acquire renderable component
-                    const auto& renderable = entity->GetRenderable();
-                    if (!renderable)
-                        continue;
-
-                    // Skip meshes that don't cast shadows
-                    if (!renderable->GetCastShadows())
-                        continue;
-
-                    // Acquire geometry
-                    const auto& model = renderable->GeometryModel();
-                    if (!model || !model->GetVertexBuffer() || !model->GetIndexBuffer())
-                        continue;
-
-                    // Acquire material
-                    const auto& material = renderable->GetMaterial();
-                    if (!material)
-                        continue;
-
-                    // Skip objects outside of the view frustum
-                    if (!light->IsInViewFrustrum(renderable, array_index))
-                        continue;
-
-                    if (!render_pass_active)
-                    {
-                        render_pass_active = cmd_list->BeginRenderPass(pipeline_state);
-                    }
-
-                    // Bind material
-                    if (transparent_pass && m_set_material_id != material->GetId())
-                    {
-                        // Bind material textures
-                        RHI_Texture* tex_albedo = material->GetTexture_Ptr(Material_Color);
-                        cmd_list->SetTexture(RendererBindingsSrv::tex, tex_albedo ? tex_albedo : m_default_tex_white.get());
+                    // Bind material textures
+                    RHI_Texture* tex_albedo = material->GetTexture_Ptr(Material_Color);
+                    cmd_list->SetTexture(RendererBindingsSrv::tex, tex_albedo ? tex_albedo : m_default_tex_white.get());
 
-                        // Update uber buffer with material properties
-                        m_buffer_uber_cpu.mat_albedo    = material->GetColorAlbedo();
-                        m_buffer_uber_cpu.mat_tiling_uv = material->GetTiling();
-                        m_buffer_uber_cpu.mat_offset_uv = material->GetOffset();
+                    // Update uber buffer with material properties
+                    m_buffer_uber_cpu.mat_albedo    = material->GetColorAlbedo();
+                    m_buffer_uber_cpu.mat_tiling_uv = material->GetTiling();
+                    m_buffer_uber_cpu.mat_offset_uv = material->GetOffset();
 
-                        // Update constant buffer
-                        UpdateUberBuffer(cmd_list);
+                    // Update constant buffer
+                    UpdateUberBuffer(cmd_list);
 
-                        m_set_material_id = material->GetId();
-                    }
+                    m_set_material_id = material->GetId();
+                }
 
-                    // Bind geometry
-                    cmd_list->SetBufferIndex(model->GetIndexBuffer());
-                    cmd_list->SetBufferVertex(model->GetVertexBuffer());
+                // Bind geometry
+                cmd_list->SetBufferIndex(model->GetIndexBuffer());
+                cmd_list->SetBufferVertex(model->GetVertexBuffer());
 
-                    // Update uber buffer with cascade transform
-                    m_buffer_object_cpu.object = entity->GetTransform()->GetMatrix() * view_projection;
-                    if (!UpdateObjectBuffer(cmd_list))
-                        continue;
+                // Update object buffer with the first instance of the draw
+                m_buffer_object_cpu.instance_offset = instance_offset + slice.instance_offset + draw.packet_index;
+                if (!UpdateObjectBuffer(cmd_list))
+                    continue;
 
-                    cmd_list->DrawIndexed(renderable->GeometryIndexCount(), renderable->GeometryIndexOffset(), renderable->GeometryVertexOffset());
-                }
+                cmd_list->DrawIndexed(renderable->GeometryIndexCount(), renderable->GeometryIndexOffset(), renderable->GeometryVertexOffset(), draw.instance_count);
+            }
 
-                if (render_pass_active)
-                {
-                    cmd_list->EndRenderPass();
-                }
+            if (render_pass_active)
+            {
+                cmd_list->EndRenderPass();
             }
         }
     }
@@ -290,7 +408,7 @@ namespace Spartan
         // Acquire required resources/data
         const auto& shader_depth    = m_shaders[RendererShader::Depth_V];
         const auto& tex_depth       = m_render_targets[RendererRt::Gbuffer_Depth];
-        const auto& entities        = m_entities[Renderer_Object_Opaque];
+        const RenderPacketRange packets = GetViewCamera().queue.GetPackets(Renderer_Object_Opaque);
 
         // Ensure the shader has compiled
         if (!shader_depth->IsCompiled())
@@ -309,30 +427,36 @@ namespace Spartan
         pipeline_state.primitive_topology           = RHI_PrimitiveTopology_TriangleList;
         pipeline_state.pass_name                    = "Pass_DepthPrePass";
 
+        // Prepare the draws in parallel, every packet is an instance
+        m_buffer_instances_cpu.resize(packets.size());
+        prepare_draws_parallel(m_threading, packets, false, m_draws_chunks, m_draws, [this, &packets](const uint32_t start, const uint32_t end)
+        {
+            for (uint32_t i = start; i < end; i++)
+            {
+                m_buffer_instances_cpu[i].wvp_current = packets[i].entity->GetTransform()->GetMatrix() * m_buffer_frame_cpu.view_projection;
+            }
+        });
+
+        uint32_t instance_offset = 0;
+        if (!UpdateInstanceBuffer(cmd_list, packets.size(), instance_offset))
+            return;
+
         // Record commands
         if (cmd_list->BeginRenderPass(pipeline_state))
         { 
-            if (!entities.empty())
+            if (!packets.empty())
             {
+                cmd_list->SetStructuredBuffer(RendererBindingsSrv::instances, m_buffer_instances_gpu);
+
                 // Variables that help reduce state changes
                 uint32_t currently_bound_geometry = 0;
 
-                // Draw opaque
-                for (const auto& entity : entities)
+                // Draw opaque (the ones inside the view frustum)
+                for (const RenderDraw& draw : m_draws)
                 {
-                    // Get renderable
-                    const auto& renderable = entity->GetRenderable();
-                    if (!renderable)
-                        continue;
-
-                    // Get geometry
-                    const auto& model = renderable->GeometryModel();
-                    if (!model || !model->GetVertexBuffer() || !model->GetIndexBuffer())
-                        continue;
-
-                    // Skip objects outside of the view frustum
-                    if (!m_camera->IsInViewFrustrum(renderable))
-                        continue;
+                    const RenderPacket& packet      = packets[draw.packet_index];
+                    const Renderable* renderable    = packet.renderable;
+                    const Model* model              = packet.model;
 
                     // Bind geometry
                     if (currently_bound_geometry != model->GetId())
@@ -342,16 +466,13 @@ namespace Spartan
                         currently_bound_geometry = model->GetId();
                     }
 
-                    // Update uber buffer with entity transform
-                    if (Transform* transform = entity->GetTransform())
-                    {
-                        // Update uber buffer with cascade transform
-                        m_buffer_uber_cpu.transform = transform->GetMatrix() * m_buffer_frame_cpu.view_projection;
-                        UpdateUberBuffer(cmd_list);
-                    }
+                    // Update object buffer with the first instance of the draw
+                    m_buffer_object_cpu.instance_offset = instance_offset + draw.packet_index;
+                    if (!UpdateObjectBuffer(cmd_list))
+                        continue;
 
                     // Draw    
-                    cmd_list->DrawIndexed(renderable->GeometryIndexCount(), renderable->GeometryIndexOffset(), renderable->GeometryVertexOffset());
+                    cmd_list->DrawIndexed(renderable->GeometryIndexCount(), renderable->GeometryIndexOffset(), renderable->GeometryVertexOffset(), draw.instance_count);
                 }
             }
             cmd_list->EndRenderPass();
@@ -367,7 +488,6 @@ namespace Spartan
         RHI_Texture* tex_velocity     = m_render_targets[RendererRt::Gbuffer_Velocity].get();
         RHI_Texture* tex_depth        = m_render_targets[RendererRt::Gbuffer_Depth].get();
         RHI_Shader* shader_v          = m_shaders[RendererShader::Gbuffer_V].get();
-        ShaderGBuffer* shader_p       = static_cast<ShaderGBuffer*>(m_shaders[RendererShader::Gbuffer_P].get());
 
         // Validate that the shader has compiled
         if (!shader_v->IsCompiled())
@@ -399,141 +519,163 @@ namespace Spartan
         uint32_t material_bound_id = 0;
         m_material_instances.fill(nullptr);
 
-        // Iterate through all the G-Buffer shader variations
-        for (const auto& it : ShaderGBuffer::GetVariations())
-        {
-            // Skip the shader until it compiles or the users spots a compilation error
-            if (!it.second->IsCompiled())
-                continue;
-
-            // Set pixel shader
-            pso.shader_pixel = static_cast<RHI_Shader*>(it.second.get());
-
-            // Set pass name
-            pso.pass_name = pso.shader_pixel->GetName().c_str();
+        // The ones inside the view frustum, grouped by shader variation, then by material and mesh, and front to back within those
+        const RenderPacketRange packets = GetViewCamera().queue.GetPackets(is_transparent_pass ? Renderer_Object_Transparent : Renderer_Object_Opaque);
 
-            bool render_pass_active = false;
-            auto& entities = m_entities[is_transparent_pass ? Renderer_Object_Transparent : Renderer_Object_Opaque];
-
-            // Record commands
-            for (uint32_t i = 0; i < static_cast<uint32_t>(entities.size()); i++)
+        // Prepare the draws in parallel, every packet is an instance and every chunk computes the world view projection matrices of it's packets in one batch
+        m_matrices_world.resize(packets.size());
+        m_matrices_wvp.resize(packets.size());
+        m_buffer_instances_cpu.resize(packets.size());
+        prepare_draws_parallel(m_threading, packets, true, m_draws_chunks, m_draws, [this, &packets](const uint32_t start, const uint32_t end)
+        {
+            for (uint32_t i = start; i < end; i++)
             {
-                Entity* entity = entities[i];
+                m_matrices_world[i] = packets[i].entity->GetTransform()->GetMatrix();
+            }
+            Matrix::MultiplyBatch(m_matrices_world.data() + start, m_buffer_frame_cpu.view_projection, m_matrices_wvp.data() + start, end - start);
 
-                // Get renderable
-                const auto& renderable = entity->GetRenderable();
-                if (!renderable)
-                    continue;
+            for (uint32_t i = start; i < end; i++)
+            {
+                Transform* transform        = packets[i].entity->GetTransform();
+                BufferInstance& instance    = m_buffer_instances_cpu[i];
+                instance.object             = m_matrices_world[i];
+                instance.wvp_current        = m_matrices_wvp[i];
+                instance.wvp_previous       = transform->GetWvpLastFrame();
+
+                // Save matrix for velocity computation
+                transform->SetWvpLastFrame(instance.wvp_current);
+            }
+        });
 
-                // Get material
-                Material* material = renderable->GetMaterial();
-                if (!material)
-                    continue;
+        uint32_t instance_offset = 0;
+        if (!UpdateInstanceBuffer(cmd_list, packets.size(), instance_offset))
+            return;
 
-                // Skip objects with different shader requirements
-                if (!static_cast<ShaderGBuffer*>(pso.shader_pixel)->IsSuitable(material->GetFlags()))
-                    continue;
+        bool render_pass_active     = false;
+        uint16_t variation_bound    = 0;
+        RHI_Shader* shader_p        = nullptr;
 
-                // Skip transparent objects that won't contribute
-                if (material->GetColorAlbedo().w == 0 && is_transparent_pass)
-                    continue;
+        // Replay the draws, one per run of packets with the same mesh and material
+        for (uint32_t draw_index = 0; draw_index < m_draws.size(); draw_index++)
+        {
+            const RenderDraw& draw      = m_draws[draw_index];
+            const RenderPacket& packet  = packets[draw.packet_index];
 
-                // Get geometry
-                const auto& model = renderable->GeometryModel();
-                if (!model || !model->GetVertexBuffer() || !model->GetIndexBuffer())
-                    continue;
+            // Every shader variation is a render pass of it's own
+            const uint16_t variation = RenderQueue::GetVariation(packet.key);
+            if (draw_index == 0 || variation != variation_bound)
+            {
+                if (render_pass_active)
+                {
+                    cmd_list->EndRenderPass();
+                    render_pass_active = false;
+                }
 
-                // Skip objects outside of the view frustum
-                if (!m_camera->IsInViewFrustrum(renderable))
-                    continue;
+                // Skip the shader until it compiles or the users spots a compilation error
+                const auto& variations  = ShaderGBuffer::GetVariations();
+                const auto it           = variations.find(variation);
+                shader_p                = (it != variations.end() && it->second->IsCompiled()) ? static_cast<RHI_Shader*>(it->second.get()) : nullptr;
+                variation_bound         = variation;
 
-                if (!render_pass_active)
+                if (shader_p)
                 {
-                    render_pass_active = cmd_list->BeginRenderPass(pso);
+                    pso.shader_pixel    = shader_p;
+                    pso.pass_name       = shader_p->GetName().c_str();
                 }
+            }
 
-                // Set geometry (will only happen if not already set)
-                cmd_list->SetBufferIndex(model->GetIndexBuffer());
-                cmd_list->SetBufferVertex(model->GetVertexBuffer());
+            if (!shader_p)
+                continue;
 
-                // Bind material
-                const bool firs_run       = material_index == 0;
-                const bool new_material   = material_bound_id != material->GetId();
-                if (firs_run || new_material)
-                {
-                    material_bound_id = material->GetId();
+            // Get material
+            Material* material = packet.material;
+            if (!material)
+                continue;
 
-                    // Keep track of used material instances (they get mapped to shaders)
-                    if (material_index + 1 < m_material_instances.size())
-                    {
-                        // Advance index (0 is reserved for the sky)
-                        material_index++;
+            // Skip transparent objects that won't contribute
+            if (material->GetColorAlbedo().w == 0 && is_transparent_pass)
+                continue;
 
-                        // Keep reference
-                        m_material_instances[material_index] = material;
-                    }
-                    else
-                    {
-                        LOG_ERROR("Material instance array has reached it's maximum capacity of %d elements. Consider increasing the size.", m_max_material_instances);
-                    }
+            const Renderable* renderable    = packet.renderable;
+            const Model* model              = packet.model;
 
-                    // Bind material textures        
-                    cmd_list->SetTexture(RendererBindingsSrv::material_albedo, material->GetTexture_Ptr(Material_Color));
-                    cmd_list->SetTexture(RendererBindingsSrv::material_roughness, material->GetTexture_Ptr(Material_Roughness));
-                    cmd_list->SetTexture(RendererBindingsSrv::material_metallic, material->GetTexture_Ptr(Material_Metallic));
-                    cmd_list->SetTexture(RendererBindingsSrv::material_normal, material->GetTexture_Ptr(Material_Normal));
-                    cmd_list->SetTexture(RendererBindingsSrv::material_height, material->GetTexture_Ptr(Material_Height));
-                    cmd_list->SetTexture(RendererBindingsSrv::material_occlusion, material->GetTexture_Ptr(Material_Occlusion));
-                    cmd_list->SetTexture(RendererBindingsSrv::material_emission, material->GetTexture_Ptr(Material_Emission));
-                    cmd_list->SetTexture(RendererBindingsSrv::material_mask, material->GetTexture_Ptr(Material_Mask));
-                
-                    // Update uber buffer with material properties
-                    m_buffer_uber_cpu.mat_id            = static_cast<float>(material_index);
-                    m_buffer_uber_cpu.mat_albedo        = material->GetColorAlbedo();
-                    m_buffer_uber_cpu.mat_tiling_uv     = material->GetTiling();
-                    m_buffer_uber_cpu.mat_offset_uv     = material->GetOffset();
-                    m_buffer_uber_cpu.mat_roughness_mul = material->GetProperty(Material_Roughness);
-                    m_buffer_uber_cpu.mat_metallic_mul  = material->GetProperty(Material_Metallic);
-                    m_buffer_uber_cpu.mat_normal_mul    = material->GetProperty(Material_Normal);
-                    m_buffer_uber_cpu.mat_height_mul    = material->GetProperty(Material_Height);
+            if (!render_pass_active)
+            {
+                render_pass_active = cmd_list->BeginRenderPass(pso);
+                cmd_list->SetStructuredBuffer(RendererBindingsSrv::instances, m_buffer_instances_gpu);
+            }
 
-                    // Update constant buffer
-                    UpdateUberBuffer(cmd_list);
-                }
-                
-                // Update uber buffer with entity transform
-                if (Transform* transform = entity->GetTransform())
-                {
-                    m_buffer_object_cpu.object          = transform->GetMatrix();
-                    m_buffer_object_cpu.wvp_current     = transform->GetMatrix() * m_buffer_frame_cpu.view_projection;
-                    m_buffer_object_cpu.wvp_previous    = transform->GetWvpLastFrame();
+            // Set geometry (will only happen if not already set)
+            cmd_list->SetBufferIndex(model->GetIndexBuffer());
+            cmd_list->SetBufferVertex(model->GetVertexBuffer());
 
-                    // Save matrix for velocity computation
-                    transform->SetWvpLastFrame(m_buffer_object_cpu.wvp_current);
+            // Bind material
+            const bool firs_run       = material_index == 0;
+            const bool new_material   = material_bound_id != material->GetId();
+            if (firs_run || new_material)
+            {
+                material_bound_id = material->GetId();
 
-                    // Update object buffer
-                    if (!UpdateObjectBuffer(cmd_list))
-                        continue;
-                }
-                
-                // Render    
-                cmd_list->DrawIndexed(renderable->GeometryIndexCount(), renderable->GeometryIndexOffset(), renderable->GeometryVertexOffset());
-                m_profiler->m_renderer_meshes_rendered++;
+                // Keep track of used material instances (they get mapped to shaders)
+                if (material_index + 1 < m_material_instances.size())
+                {
+                    // Advance index (0 is reserved for the sky)
+                    material_index++;
 
-                // Clear only on first pass
-                if (!cleared)
+                    // Keep reference
+                    m_material_instances[material_index] = material;
+                }
+                else
                 {
-                    pso.ResetClearValues();
-                    cleared = true;
+                    LOG_ERROR("Material instance array has reached it's maximum capacity of %d elements. Consider increasing the size.", m_max_material_instances);
                 }
+
+                // Bind material textures        
+                cmd_list->SetTexture(RendererBindingsSrv::material_albedo, material->GetTexture_Ptr(Material_Color));
+                cmd_list->SetTexture(RendererBindingsSrv::material_roughness, material->GetTexture_Ptr(Material_Roughness));
+                cmd_list->SetTexture(RendererBindingsSrv::material_metallic, material->GetTexture_Ptr(Material_Metallic));
+                cmd_list->SetTexture(RendererBindingsSrv::material_normal, material->GetTexture_Ptr(Material_Normal));
+                cmd_list->SetTexture(RendererBindingsSrv::material_height, material->GetTexture_Ptr(Material_Height));
+                cmd_list->SetTexture(RendererBindingsSrv::material_occlusion, material->GetTexture_Ptr(Material_Occlusion));
+                cmd_list->SetTexture(RendererBindingsSrv::material_emission, material->GetTexture_Ptr(Material_Emission));
+                cmd_list->SetTexture(RendererBindingsSrv::material_mask, material->GetTexture_Ptr(Material_Mask));
+            
+                // Update uber buffer with material properties
+                m_buffer_uber_cpu.mat_id            = static_cast<float>(material_index);
+                m_buffer_uber_cpu.mat_albedo        = material->GetColorAlbedo();
+                m_buffer_uber_cpu.mat_tiling_uv     = material->GetTiling();
+                m_buffer_uber_cpu.mat_offset_uv     = material->GetOffset();
+                m_buffer_uber_cpu.mat_roughness_mul = material->GetProperty(Material_Roughness);
+                m_buffer_uber_cpu.mat_metallic_mul  = material->GetProperty(Material_Metallic);
+                m_buffer_uber_cpu.mat_normal_mul    = material->GetProperty(Material_Normal);
+                m_buffer_uber_cpu.mat_height_mul    = material->GetProperty(Material_Height);
+
+                // Update constant buffer
+                UpdateUberBuffer(cmd_list);
             }
+            
+            // Update object buffer with the first instance of the draw
+            m_buffer_object_cpu.instance_offset = instance_offset + draw.packet_index;
+            if (!UpdateObjectBuffer(cmd_list))
+                continue;
+            
+            // Render    
+            cmd_list->DrawIndexed(renderable->GeometryIndexCount(), renderable->GeometryIndexOffset(), renderable->GeometryVertexOffset(), draw.instance_count);
+            m_profiler->m_renderer_meshes_rendered += draw.instance_count;
 
-            if (render_pass_active)
+            // Clear only on first pass
+            if (!cleared)
             {
-                cmd_list->EndRenderPass();
+                pso.ResetClearValues();
+                cleared = true;
             }
         }
 
+        if (render_pass_active)
+        {
+            cmd_list->EndRenderPass();
+        }
+
         // Update constant buffer (light pass will access it using material IDs)
         UpdateMaterialBuffer(cmd_list);
     }
@@ -31,6 +31,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../RHI/RHI_Sampler.h"
 #include "../RHI/RHI_BlendState.h"
 #include "../RHI/RHI_ConstantBuffer.h"
+#include "../RHI/RHI_StructuredBuffer.h"
 #include "../RHI/RHI_RasterizerState.h"
 #include "../RHI/RHI_DepthStencilState.h"
 #include "../RHI/RHI_SwapChain.h"
@@ -63,6 +64,13 @@ namespace Spartan
         m_buffer_light_gpu->Create<BufferLight>(m_swap_chain_buffer_count);
     }
 
+    void Renderer::CreateStructuredBuffers()
+    {
+        // Grows on demand, see UpdateInstanceBuffer()
+        m_buffer_instances_gpu = make_shared<RHI_StructuredBuffer>(m_rhi_device, "instances");
+        m_buffer_instances_gpu->Create<BufferInstance>(1024);
+    }
+
     void Renderer::CreateDepthStencilStates()
     {
         // arguments: depth_test, depth_write, depth_function, stencil_test, stencil_write, stencil_function
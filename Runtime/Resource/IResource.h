@@ -23,6 +23,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES ======================
 #include <memory>
+#include <atomic>
 #include "../Core/Context.h"
 #include "../Core/FileSystem.h"
 #include "../Core/Spartan_Object.h"
@@ -106,9 +107,20 @@ namespace Spartan
         // Misc
         LoadState GetLoadState() const { return m_load_state; }
 
+        // Dirty resources differ from their native file, they are saved again on the next world save.
+        // A save clears the revision it serialized, so changes made while it's writing keep the resource dirty.
+        bool IsDirty() const                        { return m_revision != m_revision_saved; }
+        void MakeDirty()                            { m_revision++; }
+        uint32_t GetRevision() const                { return m_revision; }
+        void ClearDirty(const uint32_t revision)    { m_revision_saved = revision; }
+        void ClearDirty()                           { ClearDirty(m_revision); }
+
         // IO
         virtual bool SaveToFile(const std::string& file_path)    { return true; }
         virtual bool LoadFromFile(const std::string& file_path)    { return true; }
+        // Serializes what SaveToFile() writes, so that the file can be written on another thread.
+        // Returns false if the resource can't, it has to be saved with SaveToFile() instead.
+        virtual bool SaveToMemory(std::string* data)            { return false; }
 
         // Type
         template <typename T>
@@ -117,6 +129,8 @@ namespace Spartan
     protected:
         ResourceType m_resource_type    = ResourceType::Unknown;
         LoadState m_load_state            = Idle;
+        std::atomic<uint32_t> m_revision        = 1; // resources start dirty
+        std::atomic<uint32_t> m_revision_saved  = 0;
 
     private:
         std::string m_resource_name;
@@ -44,7 +44,6 @@ namespace Spartan::freeimage_helper
         uint32_t height          = 0;
         uint32_t channel_count   = 0;
         vector<std::byte>* data  = nullptr;
-        bool done                = false;
 
         RescaleJob(const uint32_t width, const uint32_t height, const uint32_t channel_count)
         {
@@ -289,9 +288,11 @@ namespace Spartan
 
         // Parallelize mipmap generation using multiple threads (because FreeImage_Rescale() using FILTER_LANCZOS3 is expensive)
         auto threading = m_context->GetSubsystem<Threading>();
+        vector<TaskHandle> tasks;
+        tasks.reserve(jobs.size());
         for (auto& job : jobs)
         {
-            threading->AddTask([this, &job, &bitmap]()
+            tasks.emplace_back(threading->AddTask([this, &job, &bitmap]()
             {
                 const auto bitmap_scaled = FreeImage_Rescale(bitmap, job.width, job.height, freeimage_helper::rescale_filter);
                 if (!GetBitsFromFibitmap(job.data, bitmap_scaled, job.width, job.height, job.channel_count))
@@ -299,22 +300,13 @@ namespace Spartan
                     LOG_ERROR("Failed to create mip level %dx%d", job.width, job.height);
                 }
                 FreeImage_Unload(bitmap_scaled);
-                job.done = true;
-            });
+            }));
         }
 
         // Wait until all mipmaps have been generated
-        auto ready = false;
-        while (!ready)
+        for (const TaskHandle& task : tasks)
         {
-            ready = true;
-            for (const auto& job : jobs)
-            {
-                if (!job.done)
-                {
-                    ready = false;
-                }
-            }
+            threading->Wait(task);
         }
     }
 
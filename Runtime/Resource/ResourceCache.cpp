@@ -22,7 +22,6 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES ======================
 #include "Spartan.h"
 #include "ResourceCache.h"
-#include "ProgressReport.h"
 #include "Import/ImageImporter.h"
 #include "Import/ModelImporter.h"
 #include "Import/FontImporter.h"
@@ -33,6 +32,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../RHI/RHI_TextureCube.h"
 #include "../Audio/AudioClip.h"
 #include "../Rendering/Model.h"
+#include "../Threading/Threading.h"
 //=================================
 
 //= NAMESPACES ================
@@ -59,15 +59,15 @@ namespace Spartan
         SetProjectDirectory("Project/");
 
         // Subscribe to events
-        SUBSCRIBE_TO_EVENT(EventType::WorldSave,    EVENT_HANDLER(SaveResourcesToFiles));
-        SUBSCRIBE_TO_EVENT(EventType::WorldLoad,    EVENT_HANDLER(LoadResourcesFromFiles));
-        SUBSCRIBE_TO_EVENT(EventType::WorldUnload,    EVENT_HANDLER(Clear));
+        m_event_world_save      = SUBSCRIBE_TO_EVENT(EventType::WorldSave,      [this](const EventData& data) { SaveResources(data.Get<WorldSnapshot*>()); });
+        m_event_world_unload    = SUBSCRIBE_TO_EVENT(EventType::WorldUnload,    EVENT_HANDLER(Clear));
     }
 
     ResourceCache::~ResourceCache()
     {
         // Unsubscribe from event
-        UNSUBSCRIBE_FROM_EVENT(EventType::WorldUnload, EVENT_HANDLER(Clear));
+        UNSUBSCRIBE_FROM_EVENT(m_event_world_save);
+        UNSUBSCRIBE_FROM_EVENT(m_event_world_unload);
         Clear();
     }
 
@@ -88,6 +88,8 @@ namespace Spartan
             return false;
         }
 
+        lock_guard<recursive_mutex> guard(m_mutex);
+
         for (const auto& resource : m_resource_groups[resource_type])
         {
             if (resource_name == resource->GetResourceName())
@@ -97,22 +99,25 @@ namespace Spartan
         return false;
     }
 
-    shared_ptr<IResource>& ResourceCache::GetByName(const string& name, const ResourceType type)
+    shared_ptr<IResource> ResourceCache::GetByName(const string& name, const ResourceType type)
     {
+        lock_guard<recursive_mutex> guard(m_mutex);
+
         for (auto& resource : m_resource_groups[type])
         {
             if (name == resource->GetResourceName())
                 return resource;
         }
 
-        static shared_ptr<IResource> empty;
-        return empty;
+        return nullptr;
     }
 
     vector<shared_ptr<IResource>> ResourceCache::GetByType(const ResourceType type /*= ResourceType::Unknown*/)
     {
         vector<shared_ptr<IResource>> resources;
 
+        lock_guard<recursive_mutex> guard(m_mutex);
+
         if (type == ResourceType::Unknown)
         {
             for (const auto& resource_group : m_resource_groups)
@@ -128,63 +133,77 @@ namespace Spartan
         return resources;
     }
 
-    void ResourceCache::SaveResourcesToFiles()
+    void ResourceCache::SaveResources(WorldSnapshot* snapshot)
     {
-        // Start progress report
-        ProgressReport::Get().Reset(g_progress_resource_cache);
-        ProgressReport::Get().SetIsLoading(g_progress_resource_cache, true);
-        ProgressReport::Get().SetStatus(g_progress_resource_cache, "Loading resources...");
-
-        // Create resource list file
-        string file_path = GetProjectDirectoryAbsolute() + m_context->GetSubsystem<World>()->GetName() + "_resources.dat";
-        auto file = make_unique<FileStream>(file_path, FileStream_Write);
-        if (!file->IsOpen())
+        // This runs on the main thread, while nothing is changing the resources. They are serialized into the snapshot
+        // and the snapshot is written to the files on an I/O thread.
+        auto file = make_unique<FileStream>("", FileStream_Memory | FileStream_Write);
+
+        // Save the list of the currently used resources, and gather the ones that changed since they were last saved
+        vector<shared_ptr<IResource>> resources_dirty;
         {
-            LOG_ERROR_GENERIC_FAILURE();
-            return;
-        }
+            lock_guard<recursive_mutex> guard(m_mutex);
+
+            // Save resource count
+            file->Write(GetResourceCount());
+
+            for (const auto& resource_group : m_resource_groups)
+            {
+                for (const auto& resource : resource_group.second)
+                {
+                    if (!resource->HasFilePathNative())
+                        continue;
 
-        const auto resource_count = GetResourceCount();
-        ProgressReport::Get().SetJobCount(g_progress_resource_cache, resource_count);
+                    // Save file path
+                    file->Write(resource->GetResourceFilePathNative());
+                    // Save type
+                    file->Write(static_cast<uint32_t>(resource->GetResourceType()));
 
-        // Save resource count
-        file->Write(resource_count);
+                    if (resource->IsDirty())
+                    {
+                        resources_dirty.emplace_back(resource);
+                    }
+                }
+            }
+        }
 
-        // Save all the currently used resources to disk
-        for (const auto& resource_group : m_resource_groups)
+        snapshot->files.push_back({ GetProjectDirectoryAbsolute() + m_context->GetSubsystem<World>()->GetName() + "_resources.dat", file->GetMemory() });
+
+        // Serialize the dirty resources (each to a dedicated file), without blocking the cache.
+        // The few which can't be serialized into memory are saved right away.
+        for (const auto& resource : resources_dirty)
         {
-            for (const auto& resource : resource_group.second)
+            WorldSnapshot::File resource_file;
+            resource_file.file_path         = resource->GetResourceFilePathNative();
+            resource_file.resource_revision = resource->GetRevision();
+
+            // It stays dirty until the file is written
+            if (resource->SaveToMemory(&resource_file.data))
             {
-                if (!resource->HasFilePathNative())
-                    continue;
-
-                // Save file path
-                file->Write(resource->GetResourceFilePathNative());
-                // Save type
-                file->Write(static_cast<uint32_t>(resource->GetResourceType()));
-                // Save resource (to a dedicated file)
-                resource->SaveToFile(resource->GetResourceFilePathNative());
-
-                // Update progress
-                ProgressReport::Get().IncrementJobsDone(g_progress_resource_cache);
+                resource_file.resource = resource;
+                snapshot->files.emplace_back(move(resource_file));
+            }
+            else if (resource->SaveToFile(resource_file.file_path))
+            {
+                resource->ClearDirty(resource_file.resource_revision);
             }
         }
-
-        // Finish with progress report
-        ProgressReport::Get().SetIsLoading(g_progress_resource_cache, false);
     }
 
-    void ResourceCache::LoadResourcesFromFiles()
+    Async<void> ResourceCache::LoadResourcesFromFiles()
     {
         // Open resource list file
         auto file_path = GetProjectDirectoryAbsolute() + m_context->GetSubsystem<World>()->GetName() + "_resources.dat";
         auto file = make_unique<FileStream>(file_path, FileStream_Read);
         if (!file->IsOpen())
-            return;
+            co_return;
         
         // Load resource count
         const auto resource_count = file->ReadAs<uint32_t>();
 
+        // Start loading all the resources, they don't depend on each other so they can load concurrently
+        vector<Async<void>> loads;
+        loads.reserve(resource_count);
         for (uint32_t i = 0; i < resource_count; i++)
         {
             // Load resource file path
@@ -193,27 +212,44 @@ namespace Spartan
             // Load resource type
             const auto type = static_cast<ResourceType>(file->ReadAs<uint32_t>());
 
-            switch (type)
-            {
-            case ResourceType::Model:
-                Load<Model>(file_path);
-                break;
-            case ResourceType::Material:
-                Load<Material>(file_path);
-                break;
-            case ResourceType::Texture:
-                Load<RHI_Texture>(file_path);
-                break;
-            case ResourceType::Texture2d:
-                Load<RHI_Texture2D>(file_path);
-                break;
-            case ResourceType::TextureCube:
-                Load<RHI_TextureCube>(file_path);
-                break;
-            case ResourceType::Audio:
-                Load<AudioClip>(file_path);
-                break;
-            }
+            loads.emplace_back(LoadAsync(move(file_path), type));
+        }
+
+        co_await WhenAll(move(loads));
+    }
+
+    Async<void> ResourceCache::LoadAsync(const string file_path, const ResourceType type)
+    {
+        // Engine files are mostly reading, so they load on the I/O pool, which keeps the compute pool free for frame jobs
+        Threading* threading = m_context->GetSubsystem<Threading>();
+        co_await ScheduleOn(threading, ThreadPool::Io);
+
+        // Foreign files (images, models, audio) have to be imported, that's mostly decoding, so it's done on the compute pool
+        if (!FileSystem::IsEngineFile(file_path))
+        {
+            co_await ScheduleOn(threading, ThreadPool::Compute);
+        }
+
+        switch (type)
+        {
+        case ResourceType::Model:
+            Load<Model>(file_path);
+            break;
+        case ResourceType::Material:
+            Load<Material>(file_path);
+            break;
+        case ResourceType::Texture:
+            Load<RHI_Texture>(file_path);
+            break;
+        case ResourceType::Texture2d:
+            Load<RHI_Texture2D>(file_path);
+            break;
+        case ResourceType::TextureCube:
+            Load<RHI_TextureCube>(file_path);
+            break;
+        case ResourceType::Audio:
+            Load<AudioClip>(file_path);
+            break;
         }
     }
 
@@ -221,6 +257,8 @@ namespace Spartan
     {
         uint64_t size = 0;
 
+        lock_guard<recursive_mutex> guard(m_mutex);
+
         if (type == ResourceType::Unknown)
         {
             for (const auto& group : m_resource_groups)
@@ -252,6 +290,8 @@ namespace Spartan
     {
         uint64_t size = 0;
 
+        lock_guard<recursive_mutex> guard(m_mutex);
+
         for (const auto& resource : m_resource_groups[type])
         {
             if (Spartan_Object* object = dynamic_cast<Spartan_Object*>(resource.get()))
@@ -21,11 +21,13 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #pragma once
 
-//= INCLUDES ==================
+//= INCLUDES ====================
 #include <unordered_map>
 #include "IResource.h"
 #include "../Core/ISubsystem.h"
-//=============================
+#include "../Core/EventSystem.h"
+#include "../Threading/Async.h"
+//===============================
 
 namespace Spartan
 {
@@ -33,6 +35,7 @@ namespace Spartan
     class FontImporter;
     class ImageImporter;
     class ModelImporter;
+    struct WorldSnapshot;
 
     enum Asset_Type
     {
@@ -56,9 +59,9 @@ namespace Spartan
         //=========================
 
         // Get by name
-        std::shared_ptr<IResource>& GetByName(const std::string& name, ResourceType type);
+        std::shared_ptr<IResource> GetByName(const std::string& name, ResourceType type);
         template <class T> 
-        constexpr std::shared_ptr<T> GetByName(const std::string& name) 
+        std::shared_ptr<T> GetByName(const std::string& name) 
         { 
             return std::static_pointer_cast<T>(GetByName(name, IResource::TypeToEnum<T>()));
         }
@@ -70,6 +73,8 @@ namespace Spartan
         template <class T>
         std::shared_ptr<T> GetByPath(const std::string& path)
         {
+            std::lock_guard<std::recursive_mutex> guard(m_mutex);
+
             for (auto& resource : m_resource_groups[IResource::TypeToEnum<T>()])
             {
                 if (path == resource->GetResourceFilePathNative())
@@ -101,18 +106,24 @@ namespace Spartan
                 return nullptr;
             }
 
-            // Ensure that this resource is not already cached
-            if (IsCached(resource->GetResourceName(), resource->GetResourceType()))
-                return GetByName<T>(resource->GetResourceName());
+            // Cache it, unless it's already cached
+            {
+                std::lock_guard<std::recursive_mutex> guard(m_mutex);
 
-            // Prevent threads from colliding in critical section
-            std::lock_guard<mutex> guard(m_mutex);
+                if (IsCached(resource->GetResourceName(), resource->GetResourceType()))
+                    return GetByName<T>(resource->GetResourceName());
 
-            // In order to guarantee deserialization, we save it now
-            resource->SaveToFile(resource->GetResourceFilePathNative());
+                m_resource_groups[resource->GetResourceType()].emplace_back(resource);
+            }
 
-            // Cache it
-            return static_pointer_cast<T>(m_resource_groups[resource->GetResourceType()].emplace_back(resource));
+            // In order to guarantee deserialization, we save it now (so there is nothing to save until it changes).
+            // That's outside of the lock, so that other threads aren't waiting for the disk.
+            if (resource->SaveToFile(resource->GetResourceFilePathNative()))
+            {
+                resource->ClearDirty();
+            }
+
+            return resource;
         }
         bool IsCached(const std::string& resource_name, ResourceType resource_type);
 
@@ -122,6 +133,8 @@ namespace Spartan
             if (!resource)
                 return;
 
+            std::lock_guard<std::recursive_mutex> guard(m_mutex);
+
             if (!IsCached(resource->GetResourceName(), resource->GetResourceType()))
                 return;
 
@@ -168,17 +181,18 @@ namespace Spartan
             return Cache<T>(typed);
         }
 
-        //= I/O ======================
-        void SaveResourcesToFiles();
-        void LoadResourcesFromFiles();
-        //============================
+        //= I/O ==================================
+        void SaveResources(WorldSnapshot* snapshot);
+        // Loads the resources of the world that's being loaded, the entities reference them so the world awaits them first
+        Async<void> LoadResourcesFromFiles();
+        //========================================
         
         //= MISC =============================================================
         // Memory
         uint64_t GetMemoryUsageCpu(ResourceType type = ResourceType::Unknown);
         uint64_t GetMemoryUsageGpu(ResourceType type = ResourceType::Unknown);
         // Unloads all resources
-        void Clear() { m_resource_groups.clear(); }
+        void Clear() { std::lock_guard<std::recursive_mutex> guard(m_mutex); m_resource_groups.clear(); }
         // Returns all resources of a given type
         uint32_t GetResourceCount(ResourceType type = ResourceType::Unknown);
         //====================================================================
@@ -198,9 +212,12 @@ namespace Spartan
         auto GetFontImporter()  const { return m_importer_font.get(); }
 
     private:
-        // Cache
+        // Loads a resource on the I/O pool, or on the compute pool if it has to be imported
+        Async<void> LoadAsync(std::string file_path, ResourceType type);
+
+        // Cache (recursive since loading a resource can load and cache its dependencies)
         std::unordered_map<ResourceType, std::vector<std::shared_ptr<IResource>>> m_resource_groups;
-        std::mutex m_mutex;
+        std::recursive_mutex m_mutex;
 
         // Directories
         std::unordered_map<Asset_Type, std::string> m_standard_resource_directories;
@@ -210,5 +227,9 @@ namespace Spartan
         std::shared_ptr<ModelImporter> m_importer_model;
         std::shared_ptr<ImageImporter> m_importer_image;
         std::shared_ptr<FontImporter> m_importer_font;
+
+        // Events
+        EventHandle m_event_world_save;
+        EventHandle m_event_world_unload;
     };
 }
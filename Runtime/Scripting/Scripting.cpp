@@ -43,11 +43,14 @@ namespace Spartan
     Scripting::Scripting(Context* context) : ISubsystem(context)
     {
         // Subscribe to events
-        SUBSCRIBE_TO_EVENT(EventType::WorldUnload, EVENT_HANDLER(Clear));
+        m_event_world_unload = SUBSCRIBE_TO_EVENT(EventType::WorldUnload, EVENT_HANDLER(Clear));
     }
 
     Scripting::~Scripting()
     {
+        // Unsubscribe from events
+        UNSUBSCRIBE_FROM_EVENT(m_event_world_unload);
+
         mono_jit_cleanup(m_domain);
     }
 
@@ -21,12 +21,13 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #pragma once
 
-//= INCLUDES ==================
+//= INCLUDES ===================
 #include <vector>
 #include <string>
 #include "ScriptInstance.h"
 #include "../Core/ISubsystem.h"
-//=============================
+#include "../Core/EventSystem.h"
+//==============================
 
 //= FORWARD DECLARATIONS =
 struct _MonoDomain;
@@ -63,5 +64,6 @@ namespace Spartan
         std::unordered_map<uint32_t, ScriptInstance> m_scripts;
         uint32_t m_script_id = SCRIPT_NOT_LOADED;
         bool m_api_assembly_compiled = false;
+        EventHandle m_event_world_unload;
     };
 }
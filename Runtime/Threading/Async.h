@@ -0,0 +1,289 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES =========
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <utility>
+#include "Threading.h"
+//====================
+
+namespace Spartan
+{
+    // Awaiting it moves the rest of the coroutine to a thread pool, e.g. co_await ScheduleOn(threading, ThreadPool::Io);
+    class ScheduleOn
+    {
+    public:
+        ScheduleOn(Threading* threading, const ThreadPool pool = ThreadPool::Compute, const TaskPriority priority = TaskPriority::Normal)
+        {
+            m_threading = threading;
+            m_pool      = pool;
+            m_priority  = priority;
+        }
+
+        bool await_ready() const { return false; }
+
+        void await_suspend(std::coroutine_handle<> handle) const
+        {
+            // The coroutine can resume (and finish) before AddTask() returns, so nothing can be touched after it
+            if (m_pool == ThreadPool::Io)
+            {
+                m_threading->AddTaskIo([handle]() { handle.resume(); }, m_priority);
+            }
+            else
+            {
+                m_threading->AddTask([handle]() { handle.resume(); }, m_priority);
+            }
+        }
+
+        void await_resume() const {}
+
+    private:
+        Threading* m_threading  = nullptr;
+        ThreadPool m_pool       = ThreadPool::Compute;
+        TaskPriority m_priority = TaskPriority::Normal;
+    };
+
+    // Blocks a thread which is not a coroutine until an Async completes
+    class AsyncWaiter
+    {
+    public:
+        void Signal()
+        {
+            // Notifying under the lock, so the waiter can't return (and destroy this) before we are done with it
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_done = true;
+            m_condition_var.notify_one();
+        }
+
+        void Wait()
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition_var.wait(lock, [this] { return m_done; });
+        }
+
+    private:
+        bool m_done = false;
+        std::mutex m_mutex;
+        std::condition_variable m_condition_var;
+    };
+
+    // The shared part of an Async's promise. The state is either one of the values below,
+    // the address of the awaiting coroutine, or the address of an AsyncWaiter tagged with the lowest bit.
+    class AsyncPromiseBase
+    {
+    public:
+        static constexpr uintptr_t state_running    = 0;
+        static constexpr uintptr_t state_done       = 2;
+        static constexpr uintptr_t state_detached   = 4;
+        static constexpr uintptr_t state_waiter_tag = 1;
+
+        struct FinalAwaiter
+        {
+            bool await_ready() const noexcept { return false; }
+            void await_resume() const noexcept {}
+
+            template <typename Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) const noexcept
+            {
+                const uintptr_t state = handle.promise().m_state.exchange(state_done, std::memory_order_acq_rel);
+
+                // Nobody owns the coroutine anymore, clean up after ourselves
+                if (state == state_detached)
+                {
+                    handle.destroy();
+                    return std::noop_coroutine();
+                }
+
+                // A thread is blocked on us
+                if (state & state_waiter_tag)
+                {
+                    reinterpret_cast<AsyncWaiter*>(state & ~state_waiter_tag)->Signal();
+                    return std::noop_coroutine();
+                }
+
+                // A coroutine is awaiting us, continue with it on this thread
+                if (state != state_running)
+                    return std::coroutine_handle<>::from_address(reinterpret_cast<void*>(state));
+
+                return std::noop_coroutine();
+            }
+        };
+
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        FinalAwaiter final_suspend() const noexcept         { return {}; }
+        void unhandled_exception()                          { m_exception = std::current_exception(); }
+
+        bool IsDone() const { return m_state.load(std::memory_order_acquire) == state_done; }
+
+        // Returns false if the coroutine is already done, in which case it can be continued right away
+        bool SetContinuation(const uintptr_t continuation)
+        {
+            uintptr_t expected = state_running;
+            return m_state.compare_exchange_strong(expected, continuation, std::memory_order_acq_rel, std::memory_order_acquire);
+        }
+
+        // Returns true if the coroutine is done and has to be destroyed by the caller
+        bool Detach()
+        {
+            return m_state.exchange(state_detached, std::memory_order_acq_rel) == state_done;
+        }
+
+        void RethrowException() const
+        {
+            if (m_exception)
+            {
+                std::rethrow_exception(m_exception);
+            }
+        }
+
+    protected:
+        std::atomic<uintptr_t> m_state = state_running;
+        std::exception_ptr m_exception;
+    };
+
+    template <typename T>
+    class AsyncPromise : public AsyncPromiseBase
+    {
+    public:
+        template <typename Value>
+        void return_value(Value&& value) { m_value.emplace(std::forward<Value>(value)); }
+        T TakeResult() { RethrowException(); return std::move(*m_value); }
+
+    private:
+        std::optional<T> m_value;
+    };
+
+    template <>
+    class AsyncPromise<void> : public AsyncPromiseBase
+    {
+    public:
+        void return_void() {}
+        void TakeResult() const { RethrowException(); }
+    };
+
+    // The result of a coroutine, e.g. Async<bool> Load() { co_await ScheduleOn(threading, ThreadPool::Io); ... co_return true; }
+    // The coroutine starts running immediately (on the calling thread, until its first co_await). The result can be
+    // either awaited by another coroutine, which suspends it instead of blocking a thread, or retrieved with Get().
+    // Either way, it can only be consumed once.
+    template <typename T = void>
+    class Async
+    {
+    public:
+        struct promise_type : AsyncPromise<T>
+        {
+            Async get_return_object() { return Async(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        };
+
+        Async() = default;
+        Async(const Async&) = delete;
+        Async& operator=(const Async&) = delete;
+        Async(Async&& other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+        Async& operator=(Async&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Release();
+                m_handle = std::exchange(other.m_handle, nullptr);
+            }
+
+            return *this;
+        }
+        ~Async() { Release(); }
+
+        bool IsValid() const { return static_cast<bool>(m_handle); }
+        bool IsDone()  const { return m_handle && m_handle.promise().IsDone(); }
+
+        // Blocks the calling thread until the coroutine is done
+        T Get()
+        {
+            if (!m_handle.promise().IsDone())
+            {
+                AsyncWaiter waiter;
+                if (m_handle.promise().SetContinuation(reinterpret_cast<uintptr_t>(&waiter) | AsyncPromiseBase::state_waiter_tag))
+                {
+                    waiter.Wait();
+                }
+            }
+
+            return m_handle.promise().TakeResult();
+        }
+
+        auto operator co_await() noexcept
+        {
+            struct Awaiter
+            {
+                std::coroutine_handle<promise_type> handle;
+
+                bool await_ready() const { return handle.promise().IsDone(); }
+                bool await_suspend(std::coroutine_handle<> awaiting) { return handle.promise().SetContinuation(reinterpret_cast<uintptr_t>(awaiting.address())); }
+                T await_resume() { return handle.promise().TakeResult(); }
+            };
+
+            return Awaiter{ m_handle };
+        }
+
+    private:
+        explicit Async(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+
+        void Release()
+        {
+            if (!m_handle)
+                return;
+
+            // If the coroutine is still running, it will destroy itself once it's done
+            if (m_handle.promise().Detach())
+            {
+                m_handle.destroy();
+            }
+
+            m_handle = nullptr;
+        }
+
+        std::coroutine_handle<promise_type> m_handle;
+    };
+
+    // Completes once all the given coroutines are done. As they are already running, they complete concurrently.
+    template <typename T>
+    Async<std::vector<T>> WhenAll(std::vector<Async<T>> tasks)
+    {
+        std::vector<T> results;
+        results.reserve(tasks.size());
+
+        for (Async<T>& task : tasks)
+        {
+            results.emplace_back(co_await task);
+        }
+
+        co_return results;
+    }
+
+    inline Async<void> WhenAll(std::vector<Async<void>> tasks)
+    {
+        for (Async<void>& task : tasks)
+        {
+            co_await task;
+        }
+    }
+}
@@ -30,37 +30,131 @@ using namespace std;
 
 namespace Spartan
 {
-    Threading::Threading(Context* context) : ISubsystem(context)
+    namespace
+    {
+        // The index of the queue that the calling thread owns (0 is the main thread)
+        const uint32_t queue_index_external = numeric_limits<uint32_t>::max();
+        thread_local uint32_t thread_queue_index = queue_index_external;
+    }
+
+    bool TaskDeque::Push(Task* task)
+    {
+        const int64_t bottom    = m_bottom.load(memory_order_relaxed);
+        const int64_t top       = m_top.load(memory_order_acquire);
+
+        if (bottom - top >= static_cast<int64_t>(capacity))
+            return false;
+
+        m_tasks[bottom & (capacity - 1)].store(task, memory_order_relaxed);
+        m_bottom.store(bottom + 1, memory_order_release);
+
+        return true;
+    }
+
+    Task* TaskDeque::Pop()
+    {
+        const int64_t bottom = m_bottom.load(memory_order_relaxed) - 1;
+        m_bottom.store(bottom, memory_order_relaxed);
+        atomic_thread_fence(memory_order_seq_cst);
+        int64_t top = m_top.load(memory_order_relaxed);
+
+        // Empty
+        if (top > bottom)
+        {
+            m_bottom.store(bottom + 1, memory_order_relaxed);
+            return nullptr;
+        }
+
+        Task* task = m_tasks[bottom & (capacity - 1)].load(memory_order_relaxed);
+
+        // Last task, race against any thieves
+        if (top == bottom)
+        {
+            if (!m_top.compare_exchange_strong(top, top + 1, memory_order_seq_cst, memory_order_relaxed))
+            {
+                task = nullptr;
+            }
+
+            m_bottom.store(bottom + 1, memory_order_relaxed);
+        }
+
+        return task;
+    }
+
+    Task* TaskDeque::Steal()
+    {
+        int64_t top = m_top.load(memory_order_acquire);
+        atomic_thread_fence(memory_order_seq_cst);
+        const int64_t bottom = m_bottom.load(memory_order_acquire);
+
+        if (top >= bottom)
+            return nullptr;
+
+        Task* task = m_tasks[top & (capacity - 1)].load(memory_order_relaxed);
+
+        // Another thief (or the owner) got it first
+        if (!m_top.compare_exchange_strong(top, top + 1, memory_order_seq_cst, memory_order_relaxed))
+            return nullptr;
+
+        return task;
+    }
+
+    Task* TaskQueue::Allocate()
+    {
+        // The pool is a ring, if the oldest slot is still pending then all of them are
+        Task* task = &pool[pool_index & (TaskDeque::capacity - 1)];
+        if (task->IsPending())
+            return nullptr;
+
+        pool_index++;
+        return task;
+    }
+
+    Threading::Threading(Context* context, const uint32_t thread_count /*= 0*/) : ISubsystem(context)
     {
-        m_stopping                                = false;
         m_thread_count_support                  = thread::hardware_concurrency();
-        m_thread_count                          = m_thread_count_support - 1; // exclude the main (this) thread
+        m_thread_count                          = thread_count != 0 ? thread_count : m_thread_count_support - 1; // exclude the main (this) thread
+        m_thread_count_io                       = Math::Helper::Clamp<uint32_t>(m_thread_count_support / 4, 2, 4); // on top of the compute threads, they mostly wait
         m_thread_names[this_thread::get_id()]   = "main";
 
+        // Create the queues before any thread starts looking into them
+        m_queue_external    = make_unique<TaskQueue>();
+        m_queue_io          = make_unique<TaskQueue>();
+        for (uint32_t i = 0; i < 1 + m_thread_count + m_thread_count_io; i++)
+        {
+            m_queues.emplace_back(make_unique<TaskQueue>());
+        }
+        thread_queue_index = 0;
+
         for (uint32_t i = 0; i < m_thread_count; i++)
         {
-            m_threads.emplace_back(thread(&Threading::ThreadLoop, this));
+            m_threads.emplace_back(thread(&Threading::ThreadLoop, this, 1 + i));
             m_thread_names[m_threads.back().get_id()] = "worker_" + to_string(i);
         }
 
-        LOG_INFO("%d threads have been created", m_thread_count);
+        for (uint32_t i = 0; i < m_thread_count_io; i++)
+        {
+            m_threads_io.emplace_back(thread(&Threading::ThreadLoopIo, this, 1 + m_thread_count + i));
+            m_thread_names[m_threads_io.back().get_id()] = "io_" + to_string(i);
+        }
+
+        LOG_INFO("%d compute threads and %d I/O threads have been created", m_thread_count, m_thread_count_io);
     }
 
     Threading::~Threading()
     {
         Flush(true);
 
-        // Put unique lock on task mutex.
-        unique_lock<mutex> lock(m_mutex_tasks);
-
         // Set termination flag to true.
-        m_stopping = true;
-
-        // Unlock the mutex
-        lock.unlock();
+        {
+            lock_guard<mutex> lock_sleep(m_mutex_sleep);
+            lock_guard<mutex> lock_io(m_mutex_io);
+            m_stopping = true;
+        }
 
         // Wake up all threads.
         m_condition_var.notify_all();
+        m_condition_var_io.notify_all();
 
         // Join all threads.
         for (auto& thread : m_threads)
@@ -68,20 +162,31 @@ namespace Spartan
             thread.join();
         }
 
+        for (auto& thread : m_threads_io)
+        {
+            thread.join();
+        }
+
         // Empty worker threads.
         m_threads.clear();
+        m_threads_io.clear();
     }
 
-    uint32_t Threading::GetThreadsAvailable() const
+    void Threading::Wait(const TaskHandle& handle)
     {
-        uint32_t available_threads = m_thread_count;
+        // The queues of the I/O threads come after the ones of the compute threads
+        const bool is_io_thread = thread_queue_index > m_thread_count && thread_queue_index < m_queues.size();
 
-        for (const auto& task : m_tasks)
+        while (!handle.IsDone())
         {
-            available_threads -= task->IsExecuting() ? 1 : 0;
-        }
+            if (is_io_thread && ExecuteQueuedTaskIo())
+                continue;
 
-        return available_threads;
+            if (!ExecuteQueuedTask())
+            {
+                this_thread::yield();
+            }
+        }
     }
 
     void Threading::Flush(bool removed_queued /*= false*/)
@@ -89,42 +194,302 @@ namespace Spartan
         // Clear any queued tasks
         if (removed_queued)
         {
-            m_tasks.clear();
+            auto discard = [this](TaskQueue* queue)
+            {
+                for (TaskDeque& deque : queue->deques)
+                {
+                    while (Task* task = deque.Steal())
+                    {
+                        m_tasks_queued.fetch_sub(1, memory_order_relaxed);
+                        task->Discard();
+                        m_tasks_pending.fetch_sub(1, memory_order_release);
+                    }
+                }
+            };
+
+            for (const auto& queue : m_queues)
+            {
+                discard(queue.get());
+            }
+            discard(m_queue_external.get());
+
+            lock_guard<mutex> lock(m_mutex_io);
+            for (deque<Task*>& tasks : m_tasks_io)
+            {
+                for (Task* task : tasks)
+                {
+                    task->Discard();
+                    m_tasks_pending.fetch_sub(1, memory_order_release);
+                }
+                tasks.clear();
+            }
         }
 
         // If so, wait for them
         while (AreTasksRunning())
         {
-            std::this_thread::sleep_for(std::chrono::milliseconds(16));
+            if (!ExecuteQueuedTask())
+            {
+                this_thread::sleep_for(chrono::milliseconds(1));
+            }
+        }
+    }
+
+    ThreadPoolMetrics Threading::GetMetrics(const ThreadPool pool)
+    {
+        ThreadPoolMetrics metrics;
+        ThreadPoolWaitTimes* wait_times = nullptr;
+
+        if (pool == ThreadPool::Compute)
+        {
+            const int32_t tasks_queued  = m_tasks_queued.load(memory_order_relaxed);
+            metrics.thread_count        = m_thread_count;
+            metrics.tasks_queued        = tasks_queued > 0 ? static_cast<uint32_t>(tasks_queued) : 0;
+            wait_times                  = &m_wait_times;
         }
+        else
+        {
+            lock_guard<mutex> lock(m_mutex_io);
+            metrics.thread_count = m_thread_count_io;
+            for (const deque<Task*>& tasks : m_tasks_io)
+            {
+                metrics.tasks_queued += static_cast<uint32_t>(tasks.size());
+            }
+            wait_times = &m_wait_times_io;
+        }
+
+        const uint64_t time_us_total    = wait_times->time_us_total.exchange(0, memory_order_relaxed);
+        metrics.tasks_executed          = wait_times->count.exchange(0, memory_order_relaxed);
+        metrics.wait_time_max_ms        = wait_times->time_us_max.exchange(0, memory_order_relaxed) / 1000.0f;
+        metrics.wait_time_avg_ms        = metrics.tasks_executed != 0 ? (time_us_total / metrics.tasks_executed) / 1000.0f : 0.0f;
+
+        return metrics;
+    }
+
+    TaskQueue* Threading::GetQueue(unique_lock<mutex>& lock)
+    {
+        if (thread_queue_index < m_queues.size())
+            return m_queues[thread_queue_index].get();
+
+        lock = unique_lock<mutex>(m_mutex_external);
+        return m_queue_external.get();
     }
 
-    void Threading::ThreadLoop()
+    Task* Threading::AcquireTask(TaskQueue* queue, unique_lock<mutex>& lock)
     {
-        shared_ptr<Task> task;
+        Task* task = queue->Allocate();
+        while (!task)
+        {
+            // Let other threads use the locked queue while we wait for the workers to catch up, don't execute
+            // anything while holding the lock though, as the task could be adding tasks to the same queue.
+            if (lock.owns_lock())
+            {
+                lock.unlock();
+                this_thread::yield();
+                lock.lock();
+            }
+            else if (!ExecuteQueuedTask())
+            {
+                this_thread::yield();
+            }
+
+            task = queue->Allocate();
+        }
+
+        return task;
+    }
+
+    void Threading::Submit(TaskQueue* queue, Task* task, const TaskPriority priority)
+    {
+        m_tasks_pending.fetch_add(1, memory_order_relaxed);
+        task->SetTimeSubmitted();
+
+        // The deques can hold as many tasks as the pool, so this should never happen
+        if (!queue->deques[static_cast<uint32_t>(priority)].Push(task))
+        {
+            ExecuteTask(task, m_wait_times);
+            return;
+        }
+
+        m_tasks_queued.fetch_add(1, memory_order_seq_cst);
+
+        // Wake up a thread, but only touch the mutex if someone is actually sleeping
+        if (m_threads_sleeping.load(memory_order_seq_cst) != 0)
+        {
+            lock_guard<mutex> lock(m_mutex_sleep);
+            m_condition_var.notify_one();
+        }
+    }
+
+    void Threading::SubmitIo(Task* task, const TaskPriority priority, unique_lock<mutex>& lock)
+    {
+        m_tasks_pending.fetch_add(1, memory_order_relaxed);
+        task->SetTimeSubmitted();
+        m_tasks_io[static_cast<uint32_t>(priority)].emplace_back(task);
+
+        lock.unlock();
+        m_condition_var_io.notify_one();
+    }
+
+    Task* Threading::FindTask(const uint32_t queue_index)
+    {
+        const uint32_t queue_count = static_cast<uint32_t>(m_queues.size());
+
+        // Higher priorities first, no matter whose queue they are in
+        for (uint32_t priority = 0; priority < static_cast<uint32_t>(TaskPriority::Count); priority++)
+        {
+            // Own queue first, newest tasks are the most likely to be in the cache
+            if (queue_index != 0 && queue_index < queue_count)
+            {
+                if (Task* task = m_queues[queue_index]->deques[priority].Pop())
+                {
+                    m_tasks_queued.fetch_sub(1, memory_order_relaxed);
+                    return task;
+                }
+            }
+
+            // Steal from the other queues, starting from our neighbour so that thieves spread out
+            for (uint32_t i = 1; i <= queue_count; i++)
+            {
+                const uint32_t victim = (queue_index + i) % queue_count;
+                if (victim == queue_index)
+                    continue;
+
+                if (Task* task = m_queues[victim]->deques[priority].Steal())
+                {
+                    m_tasks_queued.fetch_sub(1, memory_order_relaxed);
+                    return task;
+                }
+            }
+
+            if (Task* task = m_queue_external->deques[priority].Steal())
+            {
+                m_tasks_queued.fetch_sub(1, memory_order_relaxed);
+                return task;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void Threading::ExecuteTask(Task* task, ThreadPoolWaitTimes& wait_times)
+    {
+        wait_times.Add(task->GetTimeWaitedMs());
+        task->Execute();
+        m_tasks_pending.fetch_sub(1, memory_order_release);
+    }
+
+    bool Threading::ExecuteQueuedTask()
+    {
+        // The main thread doesn't pick up queued tasks, some of them (e.g. world loading) block until the main thread ticks.
+        // I/O threads do, compute tasks never block on them, so it's safe to help while waiting.
+        if (thread_queue_index == 0 || thread_queue_index >= m_queues.size())
+            return false;
+
+        Task* task = FindTask(thread_queue_index);
+        if (!task)
+            return false;
+
+        ExecuteTask(task, m_wait_times);
+        return true;
+    }
+
+    Task* Threading::PopTaskIo()
+    {
+        for (deque<Task*>& tasks : m_tasks_io)
+        {
+            if (!tasks.empty())
+            {
+                Task* task = tasks.front();
+                tasks.pop_front();
+                return task;
+            }
+        }
+
+        return nullptr;
+    }
+
+    bool Threading::ExecuteQueuedTaskIo()
+    {
+        Task* task = nullptr;
+        {
+            lock_guard<mutex> lock(m_mutex_io);
+            task = PopTaskIo();
+        }
+
+        if (!task)
+            return false;
+
+        ExecuteTask(task, m_wait_times_io);
+        return true;
+    }
+
+    void Threading::ThreadLoop(const uint32_t index)
+    {
+        thread_queue_index = index;
+
         while (true)
         {
-            // Lock tasks mutex
-            unique_lock<mutex> lock(m_mutex_tasks);
+            // Spin for a bit before going to sleep, as tasks tend to come in bursts
+            Task* task = nullptr;
+            for (uint32_t i = 0; i < 64 && !task; i++)
+            {
+                task = FindTask(index);
+                if (!task)
+                {
+                    this_thread::yield();
+                }
+            }
 
-            // Check condition on notification
-            m_condition_var.wait(lock, [this] { return !m_tasks.empty() || m_stopping; });
+            if (task)
+            {
+                m_threads_busy.fetch_add(1, memory_order_relaxed);
+                ExecuteTask(task, m_wait_times);
+                m_threads_busy.fetch_sub(1, memory_order_relaxed);
+                continue;
+            }
+
+            // Sleep until a task is submitted
+            unique_lock<mutex> lock(m_mutex_sleep);
+            m_threads_sleeping.fetch_add(1, memory_order_seq_cst);
+            m_condition_var.wait(lock, [this] { return m_tasks_queued.load(memory_order_seq_cst) > 0 || m_stopping; });
+            m_threads_sleeping.fetch_sub(1, memory_order_relaxed);
 
             // If m_stopping is true, it's time to shut everything down
-            if (m_stopping && m_tasks.empty())
+            if (m_stopping)
                 return;
+        }
+    }
+
+    void Threading::ThreadLoopIo(const uint32_t index)
+    {
+        // I/O threads get a compute queue too, so that they can kick off compute tasks without locking
+        thread_queue_index = index;
+
+        while (true)
+        {
+            unique_lock<mutex> lock(m_mutex_io);
+            m_condition_var_io.wait(lock, [this]
+            {
+                if (m_stopping)
+                    return true;
 
-            // Get next task in the queue.
-            task = m_tasks.front();
+                for (const deque<Task*>& tasks : m_tasks_io)
+                {
+                    if (!tasks.empty())
+                        return true;
+                }
 
-            // Remove it from the queue.
-            m_tasks.pop_front();
+                return false;
+            });
+
+            if (m_stopping)
+                return;
 
-            // Unlock the mutex
+            Task* task = PopTaskIo();
             lock.unlock();
 
-            // Execute the task.
-            task->Execute();
+            ExecuteTask(task, m_wait_times_io);
         }
     }
 }
@@ -21,119 +21,389 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 #pragma once
 
-//= INCLUDES ==================
+//= INCLUDES ===================
+#include <cstddef>
 #include <vector>
 #include <thread>
 #include <mutex>
+#include <array>
 #include <deque>
+#include <atomic>
+#include <condition_variable>
+#include <chrono>
 #include <unordered_map>
 #include <functional>
 #include "../Logging/Log.h"
 #include "../Core/ISubsystem.h"
-//=============================
+//==============================
 
 namespace Spartan
 {
+    enum class TaskPriority : uint32_t
+    {
+        Critical,   // Someone is waiting on it, e.g. shader compilation
+        Normal,
+        Background, // Long jobs which nobody is waiting for, e.g. terrain generation
+        Count
+    };
+
+    enum class ThreadPool : uint32_t
+    {
+        Compute,    // One thread per core, for jobs which keep the cpu busy
+        Io,         // A few extra threads, for jobs which mostly block on the disk (and decoding)
+        Count
+    };
+
+    struct ThreadPoolMetrics
+    {
+        uint32_t thread_count       = 0;
+        uint32_t tasks_queued       = 0;
+        uint32_t tasks_executed     = 0;
+        float wait_time_avg_ms      = 0.0f; // time spent in the queue, before execution
+        float wait_time_max_ms      = 0.0f;
+    };
+
+    // A type erased function which is stored inline, so submitting a task doesn't allocate
     class Task
     {
     public:
-        typedef std::function<void()> function_type;
+        static constexpr uint32_t storage_size = 64;
+
+        Task() = default;
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+
+        template <typename Function>
+        void Set(Function&& function)
+        {
+            using function_type = std::decay_t<Function>;
+            static_assert(sizeof(function_type) <= storage_size, "The task's function is too large, capture less (or capture by reference)");
+            static_assert(alignof(function_type) <= alignof(std::max_align_t), "The task's function is over-aligned");
+
+            new (m_storage) function_type(std::forward<Function>(function));
+            m_invoke    = [](void* storage) { (*static_cast<function_type*>(storage))(); };
+            m_destroy   = [](void* storage) { static_cast<function_type*>(storage)->~function_type(); };
+
+            // Odd state means pending
+            m_state.fetch_add(1, std::memory_order_release);
+        }
+
+        void Execute()
+        {
+            m_invoke(m_storage);
+            Complete();
+        }
+
+        void SetTimeSubmitted() { m_time_submitted = std::chrono::steady_clock::now(); }
+        float GetTimeWaitedMs() const { return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - m_time_submitted).count(); }
+
+        // Completes the task without running it
+        void Discard() { Complete(); }
+
+        bool IsPending()    const { return m_state.load(std::memory_order_acquire) & 1; }
+        uint32_t GetState() const { return m_state.load(std::memory_order_relaxed); }
+        const std::atomic<uint32_t>* GetStatePtr() const { return &m_state; }
+
+    private:
+        void Complete()
+        {
+            m_destroy(m_storage);
+            m_invoke    = nullptr;
+            m_destroy   = nullptr;
+
+            // Even state means done (or free)
+            m_state.fetch_add(1, std::memory_order_release);
+        }
+
+        alignas(std::max_align_t) unsigned char m_storage[storage_size];
+        void (*m_invoke)(void*)         = nullptr;
+        void (*m_destroy)(void*)        = nullptr;
+        std::atomic<uint32_t> m_state   = 0;
+        std::chrono::steady_clock::time_point m_time_submitted;
+    };
+
+    // A handle to a submitted task, it's lightweight and can be copied around and waited on
+    class TaskHandle
+    {
+    public:
+        TaskHandle() = default;
+        TaskHandle(const Task* task) : m_state(task->GetStatePtr()), m_state_pending(task->GetState()) {}
+
+        // The task's slot is recycled once the task completes, so any state change means that the task is done
+        bool IsDone() const { return !m_state || m_state->load(std::memory_order_acquire) != m_state_pending; }
+
+    private:
+        const std::atomic<uint32_t>* m_state    = nullptr;
+        uint32_t m_state_pending                = 0;
+    };
+
+    // A fixed size work-stealing deque (Chase-Lev). Only the owner thread can push and pop (from the bottom), any thread can steal (from the top).
+    class TaskDeque
+    {
+    public:
+        static constexpr uint32_t capacity = 1024;
 
-        Task(function_type&& function)  { m_function = std::forward<function_type>(function); }
-        void Execute()                  { m_is_executing = true; m_function(); m_is_executing = false; }
-        bool IsExecuting() const { return m_is_executing; }
+        bool Push(Task* task);
+        Task* Pop();
+        Task* Steal();
+        bool IsEmpty() const { return m_bottom.load(std::memory_order_relaxed) <= m_top.load(std::memory_order_relaxed); }
 
     private:
-        bool m_is_executing = false;
-        function_type m_function;
+        alignas(64) std::atomic<int64_t> m_top      = 0;
+        alignas(64) std::atomic<int64_t> m_bottom   = 0;
+        std::array<std::atomic<Task*>, capacity> m_tasks;
+    };
+
+    // Every thread that submits tasks owns a pool of task slots and a deque per priority, so submitting never contends with other threads
+    struct TaskQueue
+    {
+        Task* Allocate();
+
+        std::array<TaskDeque, static_cast<uint32_t>(TaskPriority::Count)> deques;
+        std::array<Task, TaskDeque::capacity> pool;
+        uint32_t pool_index = 0;
+    };
+
+    // Wait time statistics of a thread pool, gathered since the last time they were read
+    struct ThreadPoolWaitTimes
+    {
+        void Add(float time_ms)
+        {
+            const uint32_t time_us = static_cast<uint32_t>(time_ms * 1000.0f);
+            time_us_total.fetch_add(time_us, std::memory_order_relaxed);
+            count.fetch_add(1, std::memory_order_relaxed);
+
+            uint32_t max = time_us_max.load(std::memory_order_relaxed);
+            while (time_us > max && !time_us_max.compare_exchange_weak(max, time_us, std::memory_order_relaxed)) {}
+        }
+
+        std::atomic<uint64_t> time_us_total = 0;
+        std::atomic<uint32_t> time_us_max   = 0;
+        std::atomic<uint32_t> count         = 0;
+    };
+
+    // The shared state of a ParallelFor(), threads claim chunks by advancing an atomic cursor
+    class ParallelLoop
+    {
+    public:
+        ParallelLoop(const uint32_t range, const uint32_t grain_size, const uint32_t chunk_count)
+        {
+            m_range         = range;
+            m_grain_size    = grain_size;
+            m_chunk_count   = chunk_count;
+        }
+
+        template <typename Function>
+        void Run(Function& function)
+        {
+            uint32_t chunks_done = 0;
+            while (true)
+            {
+                const uint64_t start = m_cursor.fetch_add(m_grain_size, std::memory_order_relaxed);
+                if (start >= m_range)
+                    break;
+
+                const uint64_t end = start + m_grain_size;
+                function(static_cast<uint32_t>(start), static_cast<uint32_t>(end < m_range ? end : m_range));
+                chunks_done++;
+            }
+
+            if (chunks_done == 0)
+                return;
+
+            // The thread which completes the last chunk wakes up the caller
+            if (m_chunks_done.fetch_add(chunks_done, std::memory_order_acq_rel) + chunks_done == m_chunk_count)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_condition_var.notify_all();
+            }
+        }
+
+        bool IsDone() const { return m_chunks_done.load(std::memory_order_acquire) == m_chunk_count; }
+
+        // Blocks until all chunks are done, it spins for a bit first as the remaining chunks are already running
+        void Wait()
+        {
+            for (uint32_t i = 0; i < 64; i++)
+            {
+                if (IsDone())
+                    return;
+
+                std::this_thread::yield();
+            }
+
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_condition_var.wait(lock, [this] { return IsDone(); });
+        }
+
+    private:
+        std::atomic<uint64_t> m_cursor      = 0;
+        std::atomic<uint32_t> m_chunks_done = 0;
+        uint64_t m_range                    = 0;
+        uint32_t m_grain_size               = 0;
+        uint32_t m_chunk_count              = 0;
+        std::mutex m_mutex;
+        std::condition_variable m_condition_var;
     };
 
     class Threading : public ISubsystem
     {
     public:
-        Threading(Context* context);
+        // A thread_count of 0 creates a compute thread per core, minus one for the main thread
+        Threading(Context* context, uint32_t thread_count = 0);
         ~Threading();
 
-        // Add a task
+        // Add a task to the compute pool
         template <typename Function>
-        void AddTask(Function&& function)
+        TaskHandle AddTask(Function&& function, const TaskPriority priority = TaskPriority::Normal)
         {
             if (m_threads.empty())
             {
                 LOG_WARNING("No available threads, function will execute in the same thread");
                 function();
-                return;
+                return TaskHandle();
             }
 
-            // Lock tasks mutex
-            std::unique_lock<std::mutex> lock(m_mutex_tasks);
+            // Threads which are not owned by the task system share a queue, so they have to lock it
+            std::unique_lock<std::mutex> lock;
+            TaskQueue* queue    = GetQueue(lock);
+            Task* task          = AcquireTask(queue, lock);
 
-            // Save the task
-            m_tasks.push_back(std::make_shared<Task>(std::bind(std::forward<Function>(function))));
+            task->Set(std::forward<Function>(function));
+            const TaskHandle handle = TaskHandle(task);
+            Submit(queue, task, priority);
 
-            // Unlock the mutex
-            lock.unlock();
+            return handle;
+        }
 
-            // Wake up a thread
-            m_condition_var.notify_one();
+        // Add a task to the I/O pool, it's meant for jobs that block (loading, decoding, saving, etc)
+        template <typename Function>
+        TaskHandle AddTaskIo(Function&& function, const TaskPriority priority = TaskPriority::Normal)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex_io);
+            Task* task = AcquireTask(m_queue_io.get(), lock);
+
+            task->Set(std::forward<Function>(function));
+            const TaskHandle handle = TaskHandle(task);
+            SubmitIo(task, priority, lock);
+
+            return handle;
         }
 
-        // Adds a task which is a loop and executes chunks of it in parallel
+        // Splits [0, range) into chunks of grain_size iterations which the threads claim as they go, so uneven iterations balance out.
+        // The calling thread takes part in the work and the function returns once every chunk is done. A grain_size of 0 picks one.
         template <typename Function>
-        void AddTaskLoop(Function&& function, uint32_t range)
+        void ParallelFor(const uint32_t range, Function&& function, uint32_t grain_size = 0, const TaskPriority priority = TaskPriority::Normal)
         {
-            uint32_t available_threads  = GetThreadsAvailable();
-            vector<bool> tasks_done     = vector<bool>(available_threads, false);
-            const uint32_t task_count   = available_threads + 1; // plus one for the current thread
+            if (range == 0)
+                return;
 
-            uint32_t start  = 0;
-            uint32_t end    = 0;
-            for (uint32_t i = 0; i < available_threads; i++)
+            // By default, aim for a few chunks per thread
+            if (grain_size == 0)
             {
-                start   = (range / task_count) * i;
-                end     = start + (range / task_count);
-
-                // Kick off task
-                AddTask([&function, &tasks_done, i, start, end] { function(start, end); tasks_done[i] = true; });
+                grain_size = range / ((m_thread_count + 1) * 4);
+                grain_size = grain_size != 0 ? grain_size : 1;
             }
 
-            // Do last task in the current thread
-            function(end, range);
+            const uint32_t chunk_count = (range - 1) / grain_size + 1;
+            if (m_threads.empty() || chunk_count == 1)
+            {
+                function(0, range);
+                return;
+            }
 
-            // Wait till the threads are done
-            uint32_t tasks = 0;
-            while (tasks != tasks_done.size())
+            // Kick off helpers, they only touch the function if there are chunks left, so it's fine if some of them run after we return
+            auto loop = std::make_shared<ParallelLoop>(range, grain_size, chunk_count);
+            const uint32_t helper_count = chunk_count - 1 < m_thread_count ? chunk_count - 1 : m_thread_count;
+            for (uint32_t i = 0; i < helper_count; i++)
             {
-                tasks = 0;
-                for (const bool job_done : tasks_done)
-                {
-                    tasks += job_done ? 1 : 0;
-                }
+                AddTask([loop, &function]() { loop->Run(function); }, priority);
             }
+
+            // Claim chunks on this thread too
+            loop->Run(function);
+
+            // All the chunks are claimed at this point, wait for the ones which are still running on other threads
+            loop->Wait();
         }
 
-        // Get the number of threads used
+        // Adds a task which is a loop and executes chunks of it in parallel
+        template <typename Function>
+        void AddTaskLoop(Function&& function, uint32_t range)
+        {
+            ParallelFor(range, std::forward<Function>(function));
+        }
+
+        // Blocks until the task is done, worker threads will execute other tasks while they wait.
+        // I/O threads execute I/O tasks too, so an I/O task can wait on another one without the pool running out of threads.
+        void Wait(const TaskHandle& handle);
+
+        // Get the number of threads used (compute pool)
         uint32_t GetThreadCount()           const { return m_thread_count; }
+        // Get the number of threads used by the I/O pool
+        uint32_t GetThreadCountIo()         const { return m_thread_count_io; }
         // Get the maximum number of threads the hardware supports
         uint32_t GetThreadCountSupport()    const { return m_thread_count_support; }
-        // Get the number of threads which are not doing any work
-        uint32_t GetThreadsAvailable()      const;
+        // Get the number of compute threads which are not doing any work
+        uint32_t GetThreadsAvailable()      const { return m_thread_count - m_threads_busy.load(std::memory_order_relaxed); }
         // Returns true if at least one task is running
-        bool AreTasksRunning()              const { return GetThreadsAvailable() != GetThreadCount(); }
+        bool AreTasksRunning()              const { return m_tasks_pending.load(std::memory_order_acquire) != 0; }
         // Waits for all executing (and queued if requested) tasks to finish
         void Flush(bool removed_queued = false);
+        // Returns queue depth and wait times of a pool, the wait times reset every time they are read
+        ThreadPoolMetrics GetMetrics(ThreadPool pool);
 
     private:
-        // This function is invoked by the threads
-        void ThreadLoop();
+        // These functions are invoked by the threads
+        void ThreadLoop(uint32_t queue_index);
+        void ThreadLoopIo(uint32_t queue_index);
+        // Returns the queue of the calling thread (locked, if it's the external queue)
+        TaskQueue* GetQueue(std::unique_lock<std::mutex>& lock);
+        // Returns a free task slot from the queue, if there is none (too many tasks in flight) it helps until there is
+        Task* AcquireTask(TaskQueue* queue, std::unique_lock<std::mutex>& lock);
+        // Pushes a task to a queue and wakes up a thread
+        void Submit(TaskQueue* queue, Task* task, TaskPriority priority);
+        void SubmitIo(Task* task, TaskPriority priority, std::unique_lock<std::mutex>& lock);
+        // Pops a task from the queue of the calling thread or steals one from another queue
+        Task* FindTask(uint32_t queue_index);
+        // Executes a task and updates the pending task count and wait times
+        void ExecuteTask(Task* task, ThreadPoolWaitTimes& wait_times);
+        // Executes a single queued task (worker threads only), returns false if there was nothing to execute
+        bool ExecuteQueuedTask();
+        // Pops the oldest task of the highest priority from the I/O pool, m_mutex_io has to be locked
+        Task* PopTaskIo();
+        // Executes a single queued I/O task, returns false if there was nothing to execute
+        bool ExecuteQueuedTaskIo();
 
         uint32_t m_thread_count         = 0;
+        uint32_t m_thread_count_io      = 0;
         uint32_t m_thread_count_support = 0;
         std::vector<std::thread> m_threads;
-        std::deque<std::shared_ptr<Task>> m_tasks;
-        std::mutex m_mutex_tasks;
-        std::condition_variable m_condition_var;
+        std::vector<std::thread> m_threads_io;
         std::unordered_map<std::thread::id, std::string> m_thread_names;
-        bool m_stopping;
+
+        // Compute queues, one for the main thread (at index 0), then one per compute thread, then one per I/O thread
+        std::vector<std::unique_ptr<TaskQueue>> m_queues;
+        ThreadPoolWaitTimes m_wait_times;
+
+        // I/O pool, the tasks are few and long so a single locked queue is fine
+        std::unique_ptr<TaskQueue> m_queue_io;
+        std::array<std::deque<Task*>, static_cast<uint32_t>(TaskPriority::Count)> m_tasks_io;
+        std::mutex m_mutex_io;
+        std::condition_variable m_condition_var_io;
+        ThreadPoolWaitTimes m_wait_times_io;
+
+        // Queue for threads which are not owned by the task system
+        std::unique_ptr<TaskQueue> m_queue_external;
+        std::mutex m_mutex_external;
+
+        // Sleeping
+        std::mutex m_mutex_sleep;
+        std::condition_variable m_condition_var;
+        std::atomic<int32_t> m_tasks_queued     = 0;
+        std::atomic<uint32_t> m_tasks_pending   = 0;
+        std::atomic<uint32_t> m_threads_busy    = 0;
+        std::atomic<uint32_t> m_threads_sleeping = 0;
+        std::atomic<bool> m_stopping            = false;
     };
 }
@@ -0,0 +1,167 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES =====================
+#include <cstddef>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include "Components/IComponent.h"
+//================================
+
+namespace Spartan
+{
+    // Allocates components of the same type from blocks, so that they end up next to each other in memory.
+    // It's meant for std::allocate_shared(), which rebinds it to a type holding both the component and its reference counts.
+    template <typename T>
+    class ComponentAllocator
+    {
+    public:
+        using value_type = T;
+
+        ComponentAllocator() = default;
+        template <typename U>
+        ComponentAllocator(const ComponentAllocator<U>&) {}
+
+        T* allocate(const size_t count)
+        {
+            if (count != 1)
+                return std::allocator<T>().allocate(count);
+
+            return reinterpret_cast<T*>(GetBlocks().Allocate());
+        }
+
+        void deallocate(T* pointer, const size_t count)
+        {
+            if (count != 1)
+            {
+                std::allocator<T>().deallocate(pointer, count);
+                return;
+            }
+
+            GetBlocks().Free(reinterpret_cast<Slot*>(pointer));
+        }
+
+        template <typename U>
+        bool operator==(const ComponentAllocator<U>&) const { return true; }
+        template <typename U>
+        bool operator!=(const ComponentAllocator<U>&) const { return false; }
+
+    private:
+        struct alignas(alignof(T)) Slot
+        {
+            std::byte data[sizeof(T)];
+        };
+
+        class Blocks
+        {
+        public:
+            static constexpr uint32_t block_size = 64;
+
+            Slot* Allocate()
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+
+                if (m_slots_free.empty())
+                {
+                    Slot* block = m_blocks.emplace_back(std::make_unique<Slot[]>(block_size)).get();
+
+                    // Reversed, so that consecutive allocations are consecutive in memory
+                    for (uint32_t i = block_size; i > 0; i--)
+                    {
+                        m_slots_free.emplace_back(&block[i - 1]);
+                    }
+                }
+
+                Slot* slot = m_slots_free.back();
+                m_slots_free.pop_back();
+                return slot;
+            }
+
+            void Free(Slot* slot)
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_slots_free.emplace_back(slot);
+            }
+
+        private:
+            std::vector<std::unique_ptr<Slot[]>> m_blocks;
+            std::vector<Slot*> m_slots_free;
+            std::mutex m_mutex;
+        };
+
+        // Never destroyed, as components can be released during static destruction
+        static Blocks& GetBlocks()
+        {
+            static Blocks* blocks = new Blocks();
+            return *blocks;
+        }
+    };
+
+    // All the components of a type whose entities are registered with a world, packed densely for iteration.
+    // Each component knows its index in the pool, so adding and removing is O(1).
+    class ComponentPool
+    {
+    public:
+        static constexpr uint32_t index_invalid = static_cast<uint32_t>(-1);
+
+        void Add(IComponent* component)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            component->SetPoolIndex(static_cast<uint32_t>(m_components.size()));
+            m_components.emplace_back(component);
+        }
+
+        void Reserve(const uint32_t count)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_components.reserve(count);
+        }
+
+        void Remove(IComponent* component)
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+
+            const uint32_t index = component->GetPoolIndex();
+            if (index >= m_components.size() || m_components[index] != component)
+                return;
+
+            // Swap with the last one and pop
+            IComponent* last    = m_components.back();
+            m_components[index] = last;
+            last->SetPoolIndex(index);
+            m_components.pop_back();
+
+            component->SetPoolIndex(index_invalid);
+        }
+
+        // Not thread safe, components shouldn't be added or removed while iterating (the world doesn't tick while loading)
+        const std::vector<IComponent*>& GetAll() const  { return m_components; }
+        uint32_t GetCount() const                       { return static_cast<uint32_t>(m_components.size()); }
+
+    private:
+        std::vector<IComponent*> m_components;
+        std::mutex m_mutex;
+    };
+}
@@ -58,10 +58,10 @@ namespace Spartan
         void SetMute(bool mute);
 
         bool GetPlayOnStart() const                        { return m_play_on_start; }
-        void SetPlayOnStart(const bool play_on_start)    { m_play_on_start = play_on_start; }
+        void SetPlayOnStart(const bool play_on_start)    { m_play_on_start = play_on_start; MakeEntityDirty(); }
 
         bool GetLoop() const            { return m_loop; }
-        void SetLoop(const bool loop)    { m_loop = loop; }
+        void SetLoop(const bool loop)    { m_loop = loop; MakeEntityDirty(); }
 
         int GetPriority() const { return m_priority; }
         void SetPriority(int priority);
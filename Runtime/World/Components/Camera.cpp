@@ -116,18 +116,21 @@ namespace Spartan
     {
         m_near_plane = Helper::Max(0.01f, near_plane);
         m_is_dirty = true;
+        MakeEntityDirty();
     }
 
     void Camera::SetFarPlane(const float far_plane)
     {
         m_far_plane = far_plane;
         m_is_dirty = true;
+        MakeEntityDirty();
     }
 
     void Camera::SetProjection(const ProjectionType projection)
     {
         m_projection_type = projection;
         m_is_dirty = true;
+        MakeEntityDirty();
     }
 
     float Camera::GetFovHorizontalDeg() const
@@ -144,6 +147,7 @@ namespace Spartan
     {
         m_fov_horizontal_rad = Helper::DegreesToRadians(fov);
         m_is_dirty = true;
+        MakeEntityDirty();
     }
 
     const RHI_Viewport& Camera::GetViewport() const
@@ -182,33 +186,25 @@ namespace Spartan
         Vector3 ray_end     = Unproject(mouse_position_relative);
         m_ray               = Ray(ray_start, ray_end);
 
-        // Traces ray against all AABBs in the world
+        // Traces ray against the AABBs in the world, the bounding volume hierarchy only returns the ones it hits
         vector<RayHit> hits;
         {
-            const auto& entities = m_context->GetSubsystem<World>()->EntityGetAll();
-            for (const auto& entity : entities)
+            m_context->GetSubsystem<World>()->QueryRenderables(m_ray, [this, &hits](Renderable* renderable)
             {
-                // Make sure there entity has a renderable
-                if (!entity->HasComponent<Renderable>())
-                    continue;
-
-                // Get object oriented bounding box
-                const BoundingBox& aabb = entity->GetComponent<Renderable>()->GetAabb();
-
                 // Compute hit distance
-                float distance = m_ray.HitDistance(aabb);
+                const float distance = m_ray.HitDistance(renderable->GetAabb());
 
                 // Don't store hit data if there was no hit
                 if (distance == Helper::INFINITY_)
-                    continue;
+                    return;
 
                 hits.emplace_back(
-                    entity,                                             // Entity
+                    renderable->GetEntity()->GetPtrShared(),            // Entity
                     m_ray.GetStart() + distance * m_ray.GetDirection(), // Position
                     distance,                                           // Distance
                     distance == 0.0f                                    // Inside
                 );
-            }
+            });
 
             // Sort by distance (ascending)
             std::sort(hits.begin(), hits.end(), [](const RayHit& a, const RayHit& b) { return a.m_distance < b.m_distance; });
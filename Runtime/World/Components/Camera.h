@@ -84,13 +84,13 @@ namespace Spartan
         //==============================================================================
 
         float GetAperture() const { return m_aperture; }
-        void SetAperture(const float aperture) { m_aperture = aperture; }
+        void SetAperture(const float aperture) { m_aperture = aperture; MakeEntityDirty(); }
 
         float GetShutterSpeed() const                   { return m_shutter_speed; }
-        void SetShutterSpeed(const float shutter_speed) { m_shutter_speed = shutter_speed; }
+        void SetShutterSpeed(const float shutter_speed) { m_shutter_speed = shutter_speed; MakeEntityDirty(); }
 
         float GetIso() const            { return m_iso; }
-        void SetIso(const float iso)    { m_iso = iso; }
+        void SetIso(const float iso)    { m_iso = iso; MakeEntityDirty(); }
 
         
         float GetEv100()    const { return std::log2((m_aperture * m_aperture) / m_shutter_speed * 100.0f / m_iso);} // Reference: https://google.github.io/filament/Filament.md.html#lighting/units/lightunitsvalidation
@@ -116,8 +116,9 @@ namespace Spartan
         //= MISC ==============================================================================
         bool IsInViewFrustrum(Renderable* renderable) const;
         bool IsInViewFrustrum(const Math::Vector3& center, const Math::Vector3& extents) const;
+        const Math::Frustum& GetFrustum() const           { return m_frustrum; }
         const Math::Vector4& GetClearColor() const        { return m_clear_color; }
-        void SetClearColor(const Math::Vector4& color)    { m_clear_color = color; }
+        void SetClearColor(const Math::Vector4& color)    { m_clear_color = color; MakeEntityDirty(); }
         bool GetFpsControl()                 const { return m_fps_control; }
         void SetFpsControl(const bool fps_control) { m_fps_control = fps_control; }
         //=====================================================================================
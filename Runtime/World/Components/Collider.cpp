@@ -45,11 +45,15 @@ namespace Spartan
         m_size        = Vector3::One;
         m_shape        = nullptr;
 
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_size, Vector3);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_center, Vector3);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_vertexLimit, uint32_t);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_optimize, bool);
-        REGISTER_ATTRIBUTE_VALUE_SET(m_shapeType, SetShapeType, ColliderShape);
+        static constexpr Attribute attributes[] =
+        {
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_size, Vector3),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_center, Vector3),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_vertexLimit, uint32_t),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_optimize, bool),
+            REGISTER_ATTRIBUTE_VALUE_SET(m_shapeType, SetShapeType, ColliderShape)
+        };
+        RegisterAttributes(attributes);
     }
 
     void Collider::OnInitialize()
@@ -94,6 +98,7 @@ namespace Spartan
         m_size.x = Helper::Clamp(m_size.x, Helper::EPSILON, INFINITY);
         m_size.y = Helper::Clamp(m_size.y, Helper::EPSILON, INFINITY);
         m_size.z = Helper::Clamp(m_size.z, Helper::EPSILON, INFINITY);
+        MakeEntityDirty();
 
         Shape_Update();
     }
@@ -104,6 +109,7 @@ namespace Spartan
             return;
 
         m_center = center;
+        MakeEntityDirty();
         RigidBody_SetCenterOfMass(m_center);
     }
 
@@ -113,6 +119,7 @@ namespace Spartan
             return;
 
         m_shapeType = type;
+        MakeEntityDirty();
         Shape_Update();
     }
 
@@ -122,6 +129,7 @@ namespace Spartan
             return;
 
         m_optimize = optimize;
+        MakeEntityDirty();
         Shape_Update();
     }
 
@@ -48,15 +48,19 @@ namespace Spartan
         m_constraintType            = ConstraintType_Point;
         m_physics                    = GetContext()->GetSubsystem<Physics>();
 
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_errorReduction, float);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_constraintForceMixing, float);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_enabledEffective, bool);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_collisionWithLinkedBody, bool);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_position, Vector3);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_rotation, Quaternion);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_highLimit, Vector2);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_lowLimit, Vector2);
-        REGISTER_ATTRIBUTE_VALUE_SET(m_constraintType, SetConstraintType, ConstraintType);
+        static constexpr Attribute attributes[] =
+        {
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_errorReduction, float),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_constraintForceMixing, float),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_enabledEffective, bool),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_collisionWithLinkedBody, bool),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_position, Vector3),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_rotation, Quaternion),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_highLimit, Vector2),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_lowLimit, Vector2),
+            REGISTER_ATTRIBUTE_VALUE_SET(m_constraintType, SetConstraintType, ConstraintType)
+        };
+        RegisterAttributes(attributes);
     }
 
     Constraint::~Constraint()
@@ -123,6 +127,7 @@ namespace Spartan
         if (m_constraintType != type || !m_constraint)
         {
             m_constraintType = type;
+            MakeEntityDirty();
             Construct();
         }
     }
@@ -132,6 +137,7 @@ namespace Spartan
         if (m_position != position)
         {
             m_position = position;
+            MakeEntityDirty();
             ApplyFrames();
         }
     }
@@ -141,6 +147,7 @@ namespace Spartan
         if (m_rotation != rotation)
         {
             m_rotation = rotation;
+            MakeEntityDirty();
             ApplyFrames();
         }
     }
@@ -150,6 +157,7 @@ namespace Spartan
         if (position != m_positionOther)
         {
             m_positionOther = position;
+            MakeEntityDirty();
             ApplyFrames();
         }
     }
@@ -159,6 +167,7 @@ namespace Spartan
         if (rotation != m_rotationOther)
         {
             m_rotationOther = rotation;
+            MakeEntityDirty();
             ApplyFrames();
         }
     }
@@ -175,6 +184,7 @@ namespace Spartan
         }
 
         m_bodyOther = body_other;
+        MakeEntityDirty();
         Construct();
     }
 
@@ -183,6 +193,7 @@ namespace Spartan
         if (m_highLimit != limit)
         {
             m_highLimit = limit;
+            MakeEntityDirty();
             ApplyLimits();
         }
     }
@@ -192,6 +203,7 @@ namespace Spartan
         if (m_lowLimit != limit)
         {
             m_lowLimit = limit;
+            MakeEntityDirty();
             ApplyLimits();
         }
     }
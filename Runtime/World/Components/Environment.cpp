@@ -23,7 +23,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Spartan.h"
 #include "Environment.h"
 #include "../../IO/FileStream.h"
-#include "../../Threading/Threading.h"
+#include "../../Threading/Async.h"
 #include "../../Resource/ResourceCache.h"
 #include "../../Rendering/Renderer.h"
 #include "../../RHI/RHI_Texture2D.h"
@@ -63,13 +63,22 @@ namespace Spartan
 
     void Environment::OnTick(float delta_time)
     {
-        if (!m_is_dirty)
+        // Polled, so that the main thread never waits for the disk
+        if (m_load.IsDone())
+        {
+            if (shared_ptr<RHI_Texture> texture = m_load.Get())
+            {
+                ApplyTexture(texture);
+            }
+
+            m_load = Async<shared_ptr<RHI_Texture>>();
+        }
+
+        // A load that's in flight goes first
+        if (!m_is_dirty || m_load.IsValid())
             return;
 
-        m_context->GetSubsystem<Threading>()->AddTask([this]
-        {
-            SetFromTextureSphere(m_file_paths.front());
-        });
+        m_load = LoadTextureSphere(m_context, m_file_paths.front());
 
         m_is_dirty = false;
     }
@@ -85,24 +94,21 @@ namespace Spartan
         m_environment_type = static_cast<Environment_Type>(stream->ReadAs<uint8_t>());
         stream->Read(&m_file_paths);
 
-        m_context->GetSubsystem<Threading>()->AddTask([this]
+        // Completes in the background and gets applied by OnTick(), a load that was in flight is discarded
+        if (m_environment_type == Enviroment_Cubemap)
         {
-            if (m_environment_type == Enviroment_Cubemap)
-            {
-                SetFromTextureArray(m_file_paths);
-                
-            }
-            else if (m_environment_type == Environment_Sphere)
-            {
-                
-                SetFromTextureSphere(m_file_paths.front());
-            }
-        });
+            m_load = LoadTextureArray(m_context, m_file_paths);
+        }
+        else if (m_environment_type == Environment_Sphere)
+        {
+            m_load = LoadTextureSphere(m_context, m_file_paths.front());
+        }
     }
 
     void Environment::LoadDefault()
     {
         m_is_dirty = true;
+        MakeEntityDirty();
     }
 
     const shared_ptr<RHI_Texture>& Environment::GetTexture() const
@@ -111,6 +117,12 @@ namespace Spartan
     }
 
     void Environment::SetTexture(const shared_ptr<RHI_Texture>& texture)
+    {
+        ApplyTexture(texture);
+        MakeEntityDirty();
+    }
+
+    void Environment::ApplyTexture(const shared_ptr<RHI_Texture>& texture)
     {
         m_context->GetSubsystem<Renderer>()->SetEnvironmentTexture(texture);
 
@@ -118,70 +130,67 @@ namespace Spartan
         m_file_paths = { texture ? texture->GetResourceFilePath() : "" };
     }
 
-    void Environment::SetFromTextureArray(const vector<string>& file_paths)
+    Async<shared_ptr<RHI_Texture>> Environment::LoadTextureArray(Context* context, const vector<string> file_paths)
     {
         if (file_paths.empty())
-            return;
+            co_return nullptr;
 
         LOG_INFO("Creating sky box...");
 
-        // Load all textures (sides)
-        vector<vector<vector<std::byte>>> cubemapData;
-
-        // Load all the cubemap sides
-        auto m_generate_mipmaps = false;
-        auto loaderTex = make_shared<RHI_Texture2D>(GetContext(), m_generate_mipmaps);
+        // Load all the cubemap sides concurrently
+        vector<Async<shared_ptr<RHI_Texture2D>>> loads;
+        for (const string& file_path : file_paths)
         {
-            loaderTex->LoadFromFile(file_paths[0]);
-            cubemapData.emplace_back(loaderTex->GetMips());
-
-            loaderTex->LoadFromFile(file_paths[1]);
-            cubemapData.emplace_back(loaderTex->GetMips());
-
-            loaderTex->LoadFromFile(file_paths[2]);
-            cubemapData.emplace_back(loaderTex->GetMips());
+            loads.emplace_back([](Context* context, const string file_path) -> Async<shared_ptr<RHI_Texture2D>>
+            {
+                co_await ScheduleOn(context->GetSubsystem<Threading>(), ThreadPool::Io);
 
-            loaderTex->LoadFromFile(file_paths[3]);
-            cubemapData.emplace_back(loaderTex->GetMips());
+                auto generate_mipmaps = false;
+                auto side = make_shared<RHI_Texture2D>(context, generate_mipmaps);
+                side->LoadFromFile(file_path);
+                co_return side;
+            }(context, file_path));
+        }
 
-            loaderTex->LoadFromFile(file_paths[4]);
-            cubemapData.emplace_back(loaderTex->GetMips());
+        // Continues on the thread which loads the last side
+        const vector<shared_ptr<RHI_Texture2D>> sides = co_await WhenAll(move(loads));
 
-            loaderTex->LoadFromFile(file_paths[5]);
-            cubemapData.emplace_back(loaderTex->GetMips());
+        vector<vector<vector<std::byte>>> cubemapData;
+        for (const shared_ptr<RHI_Texture2D>& side : sides)
+        {
+            cubemapData.emplace_back(side->GetMips());
         }
+        const shared_ptr<RHI_Texture2D>& loaderTex = sides.front();
 
         // Texture
-        auto texture = make_shared<RHI_TextureCube>(GetContext(), loaderTex->GetWidth(), loaderTex->GetHeight(), loaderTex->GetFormat(), cubemapData);
-        texture->SetResourceFilePath(m_context->GetSubsystem<ResourceCache>()->GetProjectDirectory() + "environment" + EXTENSION_TEXTURE);
+        auto texture = make_shared<RHI_TextureCube>(context, loaderTex->GetWidth(), loaderTex->GetHeight(), loaderTex->GetFormat(), cubemapData);
+        texture->SetResourceFilePath(context->GetSubsystem<ResourceCache>()->GetProjectDirectory() + "environment" + EXTENSION_TEXTURE);
         texture->SetWidth(loaderTex->GetWidth());
         texture->SetHeight(loaderTex->GetHeight());
         texture->SetGrayscale(false);
 
-        // Apply sky sphere to renderer
-        SetTexture(static_pointer_cast<RHI_Texture>(texture));
-
         LOG_INFO("Sky box has been created successfully");
+        co_return static_pointer_cast<RHI_Texture>(texture);
     }
 
-    void Environment::SetFromTextureSphere(const string& file_path)
+    Async<shared_ptr<RHI_Texture>> Environment::LoadTextureSphere(Context* context, const string file_path)
     {
+        co_await ScheduleOn(context->GetSubsystem<Threading>(), ThreadPool::Io);
+
         LOG_INFO("Creating sky sphere...");
 
         // Don't generate mipmaps as the Renderer will generate a prefiltered environment which is required for proper IBL
         auto generate_mipmaps = true;
 
         // Skysphere
-        auto texture = make_shared<RHI_Texture2D>(GetContext(), generate_mipmaps);
-        if (texture->LoadFromFile(file_path))
-        {
-            // Set sky sphere to renderer
-            SetTexture(static_pointer_cast<RHI_Texture>(texture));
-            LOG_INFO("Sky sphere has been created successfully");
-        }
-        else
+        auto texture = make_shared<RHI_Texture2D>(context, generate_mipmaps);
+        if (!texture->LoadFromFile(file_path))
         {
             LOG_ERROR("Sky sphere creation failed");
+            co_return nullptr;
         }
+
+        LOG_INFO("Sky sphere has been created successfully");
+        co_return static_pointer_cast<RHI_Texture>(texture);
     }
 }
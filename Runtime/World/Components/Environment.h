@@ -24,6 +24,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES ========================
 #include "IComponent.h"
 #include "../../RHI/RHI_Definition.h"
+#include "../../Threading/Async.h"
 //===================================
 
 namespace Spartan
@@ -52,11 +53,15 @@ namespace Spartan
         void SetTexture(const std::shared_ptr<RHI_Texture>& texture);
 
     private:
-        void SetFromTextureArray(const std::vector<std::string>& texturePaths);
-        void SetFromTextureSphere(const std::string& texturePath);
+        // They don't reference the component, so a load that's still in flight when it's destroyed just completes in the background
+        static Async<std::shared_ptr<RHI_Texture>> LoadTextureArray(Context* context, std::vector<std::string> texturePaths);
+        static Async<std::shared_ptr<RHI_Texture>> LoadTextureSphere(Context* context, std::string texturePath);
+        // What the loads apply, it reproduces what was saved so it doesn't mark the entity dirty
+        void ApplyTexture(const std::shared_ptr<RHI_Texture>& texture);
 
         std::vector<std::string> m_file_paths;
         Environment_Type m_environment_type;
         bool m_is_dirty = false;
+        Async<std::shared_ptr<RHI_Texture>> m_load; // the texture load in flight, OnTick() applies it once it's done
     };
 }
@@ -60,6 +60,14 @@ namespace Spartan
         return m_entity->GetName();
     }
 
+    void IComponent::MakeEntityDirty()
+    {
+        if (m_entity)
+        {
+            m_entity->MakeDirty();
+        }
+    }
+
     template <typename T>
     inline constexpr ComponentType IComponent::TypeToEnum() { return ComponentType::Unknown; }
 
@@ -24,9 +24,9 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 //= INCLUDES =========================
 #include <memory>
 #include <string>
-#include <any>
 #include <vector>
 #include <functional>
+#include <type_traits>
 #include "../../Core/Spartan_Object.h"
 //====================================
 
@@ -36,6 +36,7 @@ namespace Spartan
     class Transform;
     class Context;
     class FileStream;
+    class IComponent;
 
     enum class ComponentType : uint32_t
     {
@@ -55,12 +56,21 @@ namespace Spartan
         Unknown
     };
 
+    // A field of a component type. The table of a type is built at compile time, once,
+    // and copying goes through a typed function, so nothing gets boxed or allocated.
     struct Attribute
     {
-        std::function<std::any()> getter;
-        std::function<void(std::any)> setter;
+        const char* name = nullptr;
+        void (*copy)(const IComponent* source, IComponent* destination) = nullptr;
     };
 
+    // Wraps a generic copy lambda into a function that operates on components of type T
+    template <typename T, typename Copy>
+    constexpr Attribute MakeAttribute(const char* name, Copy)
+    {
+        return { name, [](const IComponent* source, IComponent* destination) { Copy{}(static_cast<const T*>(source), static_cast<T*>(destination)); } };
+    }
+
     class SPARTAN_CLASS IComponent : public Spartan_Object, public std::enable_shared_from_this<IComponent>
     {
     public:
@@ -88,6 +98,10 @@ namespace Spartan
         // Runs when the entity is being loaded
         virtual void Deserialize(FileStream* stream) {}
 
+        // Runs on the main thread once the entity is loaded. Deserialize() can run on any thread, so
+        // anything which isn't thread safe (gpu resources, shader variations, etc) is deferred to here.
+        virtual void OnDeserialized() {}
+
         //= TYPE ===================================
         template <typename T>
         static constexpr ComponentType TypeToEnum();
@@ -102,40 +116,61 @@ namespace Spartan
         template <typename T>
         std::shared_ptr<T> GetPtrShared() { return dynamic_pointer_cast<T>(shared_from_this()); }
 
-        const auto& GetAttributes() const { return m_attributes; }
-        void SetAttributes(const std::vector<Attribute>& attributes)
-        { 
-            for (uint32_t i = 0; i < static_cast<uint32_t>(m_attributes.size()); i++)
+        // Copies the attributes of another component of the same type
+        void CopyAttributes(const IComponent* source)
+        {
+            if (!source || source->GetType() != m_type)
+                return;
+
+            for (uint32_t i = 0; i < m_attribute_count; i++)
             {
-                m_attributes[i].setter(attributes[i].getter());
+                m_attributes[i].copy(source, this);
             }
+
+            MakeEntityDirty();
         }
 
         // Entity
         Entity* GetEntity()    const { return m_entity; }
         std::string GetEntityName() const;
+
+        // Index in the world's component pool
+        uint32_t GetPoolIndex() const           { return m_pool_index; }
+        void SetPoolIndex(const uint32_t index) { m_pool_index = index; }
         //=======================================================================================
 
     protected:
-        #define REGISTER_ATTRIBUTE_GET_SET(getter, setter, type) RegisterAttribute(     \
-        [this]()                        { return getter(); },                           \
-        [this](const std::any& valueIn) { setter(std::any_cast<type>(valueIn)); });     \
-
-        #define REGISTER_ATTRIBUTE_VALUE_SET(value, setter, type) RegisterAttribute(    \
-        [this]()                        { return value; },                              \
-        [this](const std::any& valueIn) { setter(std::any_cast<type>(valueIn)); });     \
-
-        #define REGISTER_ATTRIBUTE_VALUE_VALUE(value, type) RegisterAttribute(          \
-        [this]()                        { return value; },                              \
-        [this](const std::any& valueIn) { value = std::any_cast<type>(valueIn); });     \
-
-        // Registers an attribute
-        void RegisterAttribute(std::function<std::any()>&& getter, std::function<void(std::any)>&& setter)
-        { 
-            Attribute attribute;
-            attribute.getter = std::move(getter);
-            attribute.setter = std::move(setter);
-            m_attributes.emplace_back(attribute);
+        // The attribute macros are meant to be used inside a static constexpr Attribute table, in the constructor of a component.
+        #define REGISTER_ATTRIBUTE_GET_SET(getter, setter, type) MakeAttribute<std::remove_pointer_t<decltype(this)>>(#getter,                  \
+        [](const auto* source, auto* destination)                                                                                               \
+        {                                                                                                                                       \
+            static_assert(std::is_same_v<std::remove_cv_t<std::remove_reference_t<decltype(source->getter())>>, type>, "Attribute type mismatch"); \
+            destination->setter(source->getter());                                                                                              \
+        })
+
+        #define REGISTER_ATTRIBUTE_VALUE_SET(value, setter, type) MakeAttribute<std::remove_pointer_t<decltype(this)>>(#value,                  \
+        [](const auto* source, auto* destination)                                                                                               \
+        {                                                                                                                                       \
+            static_assert(std::is_same_v<decltype(source->value), type>, "Attribute type mismatch");                                          \
+            destination->setter(source->value);                                                                                                 \
+        })
+
+        #define REGISTER_ATTRIBUTE_VALUE_VALUE(value, type) MakeAttribute<std::remove_pointer_t<decltype(this)>>(#value,                        \
+        [](const auto* source, auto* destination)                                                                                               \
+        {                                                                                                                                       \
+            static_assert(std::is_same_v<decltype(source->value), type>, "Attribute type mismatch");                                          \
+            destination->value = source->value;                                                                                                 \
+        })
+
+        // Setters of serialized fields call it, so that the entity is saved again
+        void MakeEntityDirty();
+
+        // Registers the attribute table of the component type
+        template <uint32_t count>
+        void RegisterAttributes(const Attribute (&attributes)[count])
+        {
+            m_attributes        = attributes;
+            m_attribute_count   = count;
         }
 
         // The type of the component
@@ -146,9 +181,12 @@ namespace Spartan
         Entity* m_entity        = nullptr;
         // The transform of the component (always exists)
         Transform* m_transform  = nullptr;
+        // The index of the component in the world's component pool
+        uint32_t m_pool_index   = static_cast<uint32_t>(-1);
 
     private:
-        // The attributes of the component
-        std::vector<Attribute> m_attributes;
+        // The attributes of the component (a static table shared by all components of the same type)
+        const Attribute* m_attributes   = nullptr;
+        uint32_t m_attribute_count      = 0;
     };
 }
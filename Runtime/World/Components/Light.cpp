@@ -41,16 +41,20 @@ namespace Spartan
 {
     Light::Light(Context* context, Entity* entity, uint32_t id /*= 0*/) : IComponent(context, entity, id)
     {
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_shadows_enabled, bool);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_shadows_screen_space_enabled, bool);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_shadows_transparent_enabled, bool);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_range, float);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_intensity, float);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_angle_rad, float);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_color_rgb, Vector4);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_bias, float);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_normal_bias, float);
-        REGISTER_ATTRIBUTE_GET_SET(GetLightType, SetLightType, LightType);
+        static constexpr Attribute attributes[] =
+        {
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_shadows_enabled, bool),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_shadows_screen_space_enabled, bool),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_shadows_transparent_enabled, bool),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_range, float),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_intensity, float),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_angle_rad, float),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_color_rgb, Vector4),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_bias, float),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_normal_bias, float),
+            REGISTER_ATTRIBUTE_GET_SET(GetLightType, SetLightType, LightType)
+        };
+        RegisterAttributes(attributes);
 
         m_renderer = m_context->GetSubsystem<Renderer>();
     }
@@ -167,14 +171,18 @@ namespace Spartan
 
         m_light_type    = type;
         m_is_dirty      = true;
+        MakeEntityDirty();
 
         if (m_shadows_enabled)
         {
             CreateShadowMap();
         }
 
-        
-        m_context->GetSubsystem<World>()->MakeDirty();
+        // Lights which aren't in the world yet (e.g. a streamed cell) are picked up when they are added
+        if (m_entity->GetHandle().IsValid())
+        {
+            m_context->GetSubsystem<World>()->MakeDirty();
+        }
     }
 
     void Light::SetColor(const float temperature)
@@ -189,6 +197,7 @@ namespace Spartan
 
         m_shadows_enabled   = cast_shadows;
         m_is_dirty          = true;
+        MakeEntityDirty();
 
         if (m_shadows_enabled)
         {
@@ -202,6 +211,7 @@ namespace Spartan
             return;
 
         m_shadows_transparent_enabled = cast_transparent_shadows;
+        MakeEntityDirty();
 
         if (m_shadows_transparent_enabled)
         {
@@ -213,12 +223,14 @@ namespace Spartan
     {
         m_range = Helper::Clamp(range, 0.0f, std::numeric_limits<float>::max());
         m_is_dirty = true;
+        MakeEntityDirty();
     }
 
     void Light::SetAngle(float angle)
     {
         m_angle_rad = Helper::Clamp(angle, 0.0f, Helper::PI_2);
         m_is_dirty  = true;
+        MakeEntityDirty();
     }
 
     void Light::SetTimeOfDay(float time_of_day)
@@ -288,6 +300,7 @@ namespace Spartan
             const float max_z           = reverse_z ? 0.0f : cascade_depth;
             m_matrix_projection[index]  = Matrix::CreateOrthoOffCenterLH(shadow_slice.min.x, shadow_slice.max.x, shadow_slice.min.y, shadow_slice.max.y, min_z, max_z);
             shadow_slice.frustum        = Frustum(m_matrix_view[index], m_matrix_projection[index], max_z);
+            shadow_slice.far_plane      = cascade_depth;
         }
         else
         {
@@ -299,6 +312,7 @@ namespace Spartan
             const float far_plane       = reverse_z ? 0.1f : m_range;
             m_matrix_projection[index]  = Matrix::CreatePerspectiveFieldOfViewLH(fov, aspect_ratio, near_plane, far_plane);
             shadow_slice.frustum        = Frustum(m_matrix_view[index], m_matrix_projection[index], far_plane);
+            shadow_slice.far_plane      = m_range;
         }
 
         return true;
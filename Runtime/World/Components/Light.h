@@ -50,6 +50,7 @@ namespace Spartan
         Math::Vector3 min       = Math::Vector3::Zero;
         Math::Vector3 max       = Math::Vector3::Zero;
         Math::Vector3 center    = Math::Vector3::Zero;
+        float far_plane         = 0.0f;
         Math::Frustum frustum;
     };
 
@@ -78,23 +79,23 @@ namespace Spartan
         void SetLightType(LightType type);
 
         void SetColor(const float temperature);
-        void SetColor(const Math::Vector4& rgb) { m_color_rgb = rgb; }
+        void SetColor(const Math::Vector4& rgb) { m_color_rgb = rgb; MakeEntityDirty(); }
         const auto& GetColor() const            { return m_color_rgb; }
 
-        void SetIntensity(float value)    { m_intensity = value; }
+        void SetIntensity(float value)    { m_intensity = value; MakeEntityDirty(); }
         auto GetIntensity()    const        { return m_intensity; }
 
         bool GetShadowsEnabled() const { return m_shadows_enabled; }
         void SetShadowsEnabled(bool cast_shadows);
 
         bool GetShadowsScreenSpaceEnabled() const                      { return m_shadows_screen_space_enabled; }
-        void SetShadowsScreenSpaceEnabled(bool cast_contact_shadows)   { m_shadows_screen_space_enabled = cast_contact_shadows; }
+        void SetShadowsScreenSpaceEnabled(bool cast_contact_shadows)   { m_shadows_screen_space_enabled = cast_contact_shadows; MakeEntityDirty(); }
 
         bool GetShadowsTransparentEnabled() const { return m_shadows_transparent_enabled; }
         void SetShadowsTransparentEnabled(bool cast_transparent_shadows);
 
         bool GetVolumetricEnabled() const               { return m_volumetric_enabled; }
-        void SetVolumetricEnabled(bool is_volumetric)   { m_volumetric_enabled = is_volumetric; }
+        void SetVolumetricEnabled(bool is_volumetric)   { m_volumetric_enabled = is_volumetric; MakeEntityDirty(); }
 
         void SetRange(float range);
         auto GetRange() const { return m_range; }
@@ -105,10 +106,10 @@ namespace Spartan
         void SetTimeOfDay(float time_of_day);
         auto GetTimeOfDay() const { return m_time_of_day; }
 
-        void SetBias(float value)   { m_bias = value; }
+        void SetBias(float value)   { m_bias = value; MakeEntityDirty(); }
         float GetBias() const       { return m_bias; }
 
-        void SetNormalBias(float value) { m_normal_bias = value; }
+        void SetNormalBias(float value) { m_normal_bias = value; MakeEntityDirty(); }
         auto GetNormalBias() const { return m_normal_bias; }
 
         Math::Vector3 GetDirection() const;
@@ -122,6 +123,8 @@ namespace Spartan
         void CreateShadowMap();
 
         bool IsInViewFrustrum(Renderable* renderable, uint32_t index) const;
+        const Math::Frustum& GetFrustum(const uint32_t index) const { return m_shadow_map.slices[index].frustum; }
+        float GetShadowFarPlane(const uint32_t index) const         { return m_shadow_map.slices[index].far_plane; }
 
     private:
         void ComputeViewMatrix();
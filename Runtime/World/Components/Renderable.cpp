@@ -23,6 +23,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Spartan.h"
 #include "Renderable.h"
 #include "Transform.h"
+#include "../World.h"
 #include "../../IO/FileStream.h"
 #include "../../Resource/ResourceCache.h"
 #include "../../Utilities/Geometry.h"
@@ -100,17 +101,21 @@ namespace Spartan
         m_material_default      = false;
         m_cast_shadows          = true;
 
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_material_default,      bool);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_material,              shared_ptr<Material>);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_cast_shadows,          bool);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_geometryIndexOffset,   uint32_t);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_geometryIndexCount,    uint32_t);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_geometryVertexOffset,  uint32_t);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_geometryVertexCount,   uint32_t);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_geometryName,          string);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_model,                 shared_ptr<Model>);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_bounding_box,          BoundingBox);
-        REGISTER_ATTRIBUTE_GET_SET(Geometry_Type, GeometrySet,  Geometry_Type);
+        static constexpr Attribute attributes[] =
+        {
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_material_default,      bool),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_material,              shared_ptr<Material>),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_cast_shadows,          bool),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_geometryIndexOffset,   uint32_t),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_geometryIndexCount,    uint32_t),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_geometryVertexOffset,  uint32_t),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_geometryVertexCount,   uint32_t),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_geometryName,          string),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_model,                 shared_ptr<Model>),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_bounding_box,          BoundingBox),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_geometry_type,         Geometry_Type)
+        };
+        RegisterAttributes(attributes);
     }
 
     void Renderable::Serialize(FileStream* stream)
@@ -146,20 +151,10 @@ namespace Spartan
         stream->Read(&model_name);
         m_model = m_context->GetSubsystem<ResourceCache>()->GetByName<Model>(model_name);
 
-        // If it was a default mesh, we have to reconstruct it
-        if (m_geometry_type != Geometry_Custom) 
-        {
-            GeometrySet(m_geometry_type);
-        }
-
         // Material
         stream->Read(&m_cast_shadows);
         stream->Read(&m_material_default);
-        if (m_material_default)
-        {
-            UseDefaultMaterial();
-        }
-        else
+        if (!m_material_default)
         {
             string material_name;
             stream->Read(&material_name);
@@ -167,6 +162,21 @@ namespace Spartan
         }
     }
 
+    void Renderable::OnDeserialized()
+    {
+        // If it was a default mesh, we have to reconstruct it (it creates vertex and index buffers)
+        if (m_geometry_type != Geometry_Custom)
+        {
+            GeometrySet(m_geometry_type);
+        }
+
+        // Loads textures and generates shader variations
+        if (m_material_default)
+        {
+            UseDefaultMaterial();
+        }
+    }
+
     void Renderable::GeometrySet(const string& name, const uint32_t index_offset, const uint32_t index_count, const uint32_t vertex_offset, const uint32_t vertex_count, const BoundingBox& bounding_box, Model* model)
     {    
         m_geometryName          = name;
@@ -175,12 +185,20 @@ namespace Spartan
         m_geometryVertexOffset  = vertex_offset;
         m_geometryVertexCount   = vertex_count;
         m_bounding_box          = bounding_box;
+        m_aabb                  = BoundingBox(); // recomputed from the new bounding box when requested
         m_model                 = model ? model->GetSharedPtr() : nullptr;
+        MakeEntityDirty();
+
+        if (m_tree_proxy != AabbTree::null_node)
+        {
+            m_context->GetSubsystem<World>()->OnRenderableBoundsChanged(this);
+        }
     }
 
     void Renderable::GeometrySet(const Geometry_Type type)
     {
         m_geometry_type = type;
+        MakeEntityDirty();
 
         if (type != Geometry_Custom)
         {
@@ -230,6 +248,11 @@ namespace Spartan
 
         // Set to false otherwise material won't serialize/deserialize
         m_material_default = false;
+
+        MakeEntityDirty();
+
+        // The material decides whether it's rendered as opaque or transparent
+        m_context->GetSubsystem<World>()->OnRenderableMaterialChanged(this);
     }
 
     shared_ptr<Material> Renderable::SetMaterial(const string& file_path)
@@ -26,6 +26,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <vector>
 #include "../../Math/BoundingBox.h"
 #include "../../Math/Matrix.h"
+#include "../../Math/AabbTree.h"
 //=================================
 
 namespace Spartan
@@ -58,6 +59,7 @@ namespace Spartan
         //= ICOMPONENT ===============================
         void Serialize(FileStream* stream) override;
         void Deserialize(FileStream* stream) override;
+        void OnDeserialized() override;
         //============================================
 
         //= GEOMETRY ==========================================================================================
@@ -98,10 +100,18 @@ namespace Spartan
         //=======================================================================
 
         //= PROPERTIES =======================================================================
-        void SetCastShadows(const bool cast_shadows)        { m_cast_shadows = cast_shadows; }
+        void SetCastShadows(const bool cast_shadows)        { m_cast_shadows = cast_shadows; MakeEntityDirty(); }
         auto GetCastShadows() const                         { return m_cast_shadows; }
         //====================================================================================
 
+        // Identifies the renderable in the world's bounding volume hierarchy, while it's registered
+        uint32_t GetTreeProxy() const               { return m_tree_proxy; }
+        void SetTreeProxy(const uint32_t proxy)     { m_tree_proxy = proxy; }
+
+        // It's index in the renderer's lists, stale once it leaves them (see Renderer::RenderablesCull())
+        uint32_t GetCullIndex() const               { return m_cull_index; }
+        void SetCullIndex(const uint32_t index)     { m_cull_index = index; }
+
     private:
         std::string m_geometryName;
         uint32_t m_geometryIndexOffset;
@@ -114,6 +124,8 @@ namespace Spartan
         Math::BoundingBox m_aabb;
         Math::Matrix m_last_transform   = Math::Matrix::Identity;
         bool m_cast_shadows             = true;
+        uint32_t m_tree_proxy           = Math::AabbTree::null_node;
+        uint32_t m_cull_index           = 0;
         bool m_material_default;
         std::shared_ptr<Material> m_material;
     };
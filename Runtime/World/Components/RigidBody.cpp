@@ -89,16 +89,20 @@ namespace Spartan
         m_collision_shape    = nullptr;
         m_rigidBody            = nullptr;
 
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_mass, float);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_friction, float);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_friction_rolling, float);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_restitution, float);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_use_gravity, bool);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_is_kinematic, bool);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_gravity, Vector3);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_position_lock, Vector3);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_rotation_lock, Vector3);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_center_of_mass, Vector3);    
+        static constexpr Attribute attributes[] =
+        {
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_mass, float),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_friction, float),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_friction_rolling, float),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_restitution, float),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_use_gravity, bool),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_is_kinematic, bool),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_gravity, Vector3),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_position_lock, Vector3),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_rotation_lock, Vector3),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_center_of_mass, Vector3)
+        };
+        RegisterAttributes(attributes);
     }
 
     RigidBody::~RigidBody()
@@ -180,6 +184,7 @@ namespace Spartan
         if (mass != m_mass)
         {
             m_mass = mass;
+            MakeEntityDirty();
             Body_AddToWorld();
         }
     }
@@ -190,6 +195,7 @@ namespace Spartan
             return;
 
         m_friction = friction;
+        MakeEntityDirty();
         m_rigidBody->setFriction(friction);
     }
 
@@ -199,6 +205,7 @@ namespace Spartan
             return;
 
         m_friction_rolling = frictionRolling;
+        MakeEntityDirty();
         m_rigidBody->setRollingFriction(frictionRolling);
     }
 
@@ -208,6 +215,7 @@ namespace Spartan
             return;
 
         m_restitution = restitution;
+        MakeEntityDirty();
         m_rigidBody->setRestitution(restitution);
     }
 
@@ -217,6 +225,7 @@ namespace Spartan
             return;
 
         m_use_gravity = gravity;
+        MakeEntityDirty();
         Body_AddToWorld();
     }
 
@@ -226,6 +235,7 @@ namespace Spartan
             return;
 
         m_gravity = acceleration;
+        MakeEntityDirty();
         Body_AddToWorld();
     }
 
@@ -235,6 +245,7 @@ namespace Spartan
             return;
 
         m_is_kinematic = kinematic;
+        MakeEntityDirty();
         Body_AddToWorld();
     }
 
@@ -331,6 +342,7 @@ namespace Spartan
             return;
 
         m_position_lock = lock;
+        MakeEntityDirty();
         m_rigidBody->setLinearFactor(ToBtVector3(Vector3::One - lock));
     }
 
@@ -352,12 +364,14 @@ namespace Spartan
             return;
 
         m_rotation_lock = lock;
+        MakeEntityDirty();
         m_rigidBody->setAngularFactor(ToBtVector3(Vector3::One - lock));
     }
 
     void RigidBody::SetCenterOfMass(const Vector3& centerOfMass)
     {
         m_center_of_mass = centerOfMass;
+        MakeEntityDirty();
         SetPosition(GetPosition());
     }
 
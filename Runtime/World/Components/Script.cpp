@@ -83,6 +83,7 @@ namespace Spartan
         m_script_instance   = m_scripting->GetScript(id);
         m_file_path         = file_path;
         m_name              = FileSystem::GetFileNameNoExtensionFromFilePath(file_path);
+        MakeEntityDirty();
 
         return true;
     }
@@ -75,6 +75,7 @@ namespace Spartan
     {
         // In order for the component to guarantee serialization/deserialization, we cache the height_map
         m_height_map = m_context->GetSubsystem<ResourceCache>()->Cache<RHI_Texture2D>(height_map);
+        MakeEntityDirty();
     }
 
     void Terrain::GenerateAsync()
@@ -99,6 +100,7 @@ namespace Spartan
             return;
         }
 
+        // It's long but it keeps the cpu busy, so it goes to the compute pool (with a low priority, so frame jobs go first)
         m_context->GetSubsystem<Threading>()->AddTask([this]()
         {
             m_is_generating = true;
@@ -150,7 +152,7 @@ namespace Spartan
             m_progress_desc.clear();
 
             m_is_generating = false;
-        });
+        }, TaskPriority::Background);
     }
 
     bool Terrain::GeneratePositions(vector<Vector3>& positions, const vector<std::byte>& height_map)
@@ -375,7 +377,7 @@ namespace Spartan
             }
         };
 
-        m_context->GetSubsystem<Threading>()->AddTaskLoop(compute_vertex_normals_tangents, vertex_count);
+        m_context->GetSubsystem<Threading>()->ParallelFor(vertex_count, compute_vertex_normals_tangents);
 
         return true;
     }
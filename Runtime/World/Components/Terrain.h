@@ -51,10 +51,10 @@ namespace Spartan
         void SetHeightMap(const std::shared_ptr<RHI_Texture2D>& height_map);
 
         float GetMinY() const { return m_min_y; }
-        void SetMinY(float min_z)   { m_min_y = min_z; }
+        void SetMinY(float min_z)   { m_min_y = min_z; MakeEntityDirty(); }
 
         float GetMaxY() const { return m_max_y; }
-        void SetMaxY(float max_z)   { m_max_y = max_z; }
+        void SetMaxY(float max_z)   { m_max_y = max_z; MakeEntityDirty(); }
 
         float GetProgress() const { return static_cast<float>(static_cast<double>(m_progress_jobs_done) / static_cast<double>(m_progress_job_count)); }
         const auto& GetProgressDescription() const { return m_progress_desc; }
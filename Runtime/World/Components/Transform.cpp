@@ -44,12 +44,15 @@ namespace Spartan
         m_wvp_previous  = Matrix::Identity;
         m_parent        = nullptr;
 
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_positionLocal, Vector3);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_rotationLocal, Quaternion);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_scaleLocal,    Vector3);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_matrix,        Matrix);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_matrixLocal,   Matrix);
-        REGISTER_ATTRIBUTE_VALUE_VALUE(m_lookAt,        Vector3);
+        // The matrices are derived from these, so they are not attributes
+        static constexpr Attribute attributes[] =
+        {
+            REGISTER_ATTRIBUTE_GET_SET(GetPositionLocal,    SetPositionLocal,   Vector3),
+            REGISTER_ATTRIBUTE_GET_SET(GetRotationLocal,    SetRotationLocal,   Quaternion),
+            REGISTER_ATTRIBUTE_GET_SET(GetScaleLocal,       SetScaleLocal,      Vector3),
+            REGISTER_ATTRIBUTE_VALUE_VALUE(m_lookAt,        Vector3)
+        };
+        RegisterAttributes(attributes);
     }
 
     void Transform::OnInitialize()
@@ -72,26 +75,27 @@ namespace Spartan
         stream->Read(&m_rotationLocal);
         stream->Read(&m_scaleLocal);
         stream->Read(&m_lookAt);
+
+        // Only kept for the file layout, the parent attaches this transform when it deserializes it's children
         uint32_t parententity_id = 0;
         stream->Read(&parententity_id);
 
-        if (parententity_id != 0)
-        {
-            if (const auto parent = GetContext()->GetSubsystem<World>()->EntityGetById(parententity_id))
-            {
-                parent->GetTransform()->AddChild(this);
-            }
-        }
+        MarkDirty();
+    }
 
-        UpdateTransform();
+    void Transform::UpdateTransform() const
+    {
+        if (!m_is_dirty)
+            return;
+
+        UpdateTransform(Matrix(m_positionLocal, m_rotationLocal, m_scaleLocal));
     }
 
-    void Transform::UpdateTransform()
+    void Transform::UpdateTransform(const Matrix& matrix_local) const
     {
-        // Compute local transform
-        m_matrixLocal = Matrix(m_positionLocal, m_rotationLocal, m_scaleLocal);
+        m_matrixLocal = matrix_local;
 
-        // Compute world transform
+        // Compute world transform (the parent updates itself first, if it's dirty)
         if (!HasParent())
         {
             m_matrix = m_matrixLocal;
@@ -100,11 +104,22 @@ namespace Spartan
         {
             m_matrix = m_matrixLocal * GetParentTransformMatrix();
         }
-        
-        // Update children
-        for (const auto& child : m_children)
+
+        m_is_dirty = false;
+        m_is_moved = true;
+    }
+
+    void Transform::MarkDirty()
+    {
+        // Descendants of a dirty transform are already dirty
+        if (m_is_dirty)
+            return;
+
+        m_is_dirty = true;
+
+        for (Transform* child : m_children)
         {
-            child->UpdateTransform();
+            child->MarkDirty();
         }
     }
 
@@ -113,7 +128,7 @@ namespace Spartan
         if (GetPosition() == position)
             return;
 
-        SetPositionLocal(!HasParent() ? position : position * GetParent()->GetMatrix().Inverted());
+        SetPositionLocal(!HasParent() ? position : position * GetParent()->GetMatrix().InvertedAffine());
     }
 
     void Transform::SetPositionLocal(const Vector3& position)
@@ -122,7 +137,8 @@ namespace Spartan
             return;
 
         m_positionLocal = position;
-        UpdateTransform();
+        m_entity->MakeDirty();
+        MarkDirty();
     }
 
     void Transform::SetRotation(const Quaternion& rotation)
@@ -139,7 +155,8 @@ namespace Spartan
             return;
 
         m_rotationLocal = rotation;
-        UpdateTransform();
+        m_entity->MakeDirty();
+        MarkDirty();
     }
 
     void Transform::SetScale(const Vector3& scale)
@@ -162,7 +179,8 @@ namespace Spartan
         m_scaleLocal.y = (m_scaleLocal.y == 0.0f) ? Helper::EPSILON : m_scaleLocal.y;
         m_scaleLocal.z = (m_scaleLocal.z == 0.0f) ? Helper::EPSILON : m_scaleLocal.z;
 
-        UpdateTransform();
+        m_entity->MakeDirty();
+        MarkDirty();
     }
 
     void Transform::Translate(const Vector3& delta)
@@ -173,7 +191,7 @@ namespace Spartan
         }
         else
         {
-            SetPositionLocal(m_positionLocal + GetParent()->GetMatrix().Inverted() * delta);
+            SetPositionLocal(m_positionLocal + GetParent()->GetMatrix().InvertedAffine() * delta);
         }
     }
 
@@ -270,13 +288,19 @@ namespace Spartan
         m_parent = new_parent;
         if (parent_old) parent_old->AcquireChildren(); // update the old parent (so it removes this child)
 
+        // Both parents save their children, so they have to be saved again
+        m_entity->MakeDirty();
+        if (parent_old) parent_old->GetEntity()->MakeDirty();
+        m_parent->GetEntity()->MakeDirty();
+
         // make the new parent "aware" of this transform/child
         if (m_parent)
         {
             m_parent->AcquireChildren();
         }
 
-        UpdateTransform();
+        MarkDirty();
+        GetContext()->GetSubsystem<World>()->TransformHierarchyChanged();
     }
 
     void Transform::AddChild(Transform* child)
@@ -290,6 +314,25 @@ namespace Spartan
         child->SetParent(this);
     }
 
+    void Transform::LookAt(const Vector3& v)
+    {
+        m_lookAt = v;
+        m_entity->MakeDirty();
+    }
+
+    // Parents a transform which has just been created (no parent, no children), without resolving
+    // the hierarchy through the world. The caller has to call World::TransformHierarchyChanged().
+    void Transform::AttachChild(Transform* child)
+    {
+        if (!child || child == this || child->HasParent())
+            return;
+
+        child->m_parent = this;
+        m_children.emplace_back(child);
+        child->MarkDirty();
+        m_entity->MakeDirty();
+    }
+
     // Returns a child with the given index
     Transform* Transform::GetChildByIndex(const uint32_t index)
     {
@@ -352,6 +395,13 @@ namespace Spartan
         }
     }
 
+    // Removes the children whose entities are about to be destroyed, without walking the entire hierarchy.
+    void Transform::RemoveChildrenPendingDestruction()
+    {
+        m_children.erase(remove_if(m_children.begin(), m_children.end(), [](Transform* child) { return child->GetEntity()->IsPendingDestruction(); }), m_children.end());
+        m_entity->MakeDirty();
+    }
+
     bool Transform::IsDescendantOf(const Transform* transform) const
     {
         for (const Transform* child : transform->GetChildren())
@@ -400,8 +450,13 @@ namespace Spartan
         // delete the original reference
         m_parent = nullptr;
 
+        // The parent saves it's children, so both have to be saved again
+        m_entity->MakeDirty();
+        temp_ref->GetEntity()->MakeDirty();
+
         // Update the transform without the parent now
-        UpdateTransform();
+        MarkDirty();
+        GetContext()->GetSubsystem<World>()->TransformHierarchyChanged();
 
         // make the parent search for children,
         // that's indirect way of making the parent "forget"
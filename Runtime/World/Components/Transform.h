@@ -46,24 +46,32 @@ namespace Spartan
         void Deserialize(FileStream* stream) override;
         //============================================
 
-        void UpdateTransform();
+        // Recomputes the matrices if a local value (of this transform or of an ancestor) changed since the last time.
+        // It happens lazily when a matrix is requested, and for every transform once per frame, when the world ticks.
+        void UpdateTransform() const;
+        // Same as above, with a local matrix that the caller composed (the world does it for many transforms at once)
+        void UpdateTransform(const Math::Matrix& matrix_local) const;
+        bool IsDirty() const    { return m_is_dirty; }
+        // Whether the matrix changed since the world last looked (it keeps the bounds of the renderables up to date)
+        bool IsMoved() const    { return m_is_moved; }
+        void ClearMoved()       { m_is_moved = false; }
 
         //= POSITION ==============================================================
-        Math::Vector3 GetPosition()     const { return m_matrix.GetTranslation(); }
+        Math::Vector3 GetPosition()     const { return GetMatrix().GetTranslation(); }
         const auto& GetPositionLocal()  const { return m_positionLocal; }
         void SetPosition(const Math::Vector3& position);
         void SetPositionLocal(const Math::Vector3& position);
         //=========================================================================
 
         //= ROTATION ===========================================================
-        Math::Quaternion GetRotation() const { return m_matrix.GetRotation(); }
+        Math::Quaternion GetRotation() const { return GetMatrix().GetRotation(); }
         const auto& GetRotationLocal() const { return m_rotationLocal; }
         void SetRotation(const Math::Quaternion& rotation);
         void SetRotationLocal(const Math::Quaternion& rotation);
         //======================================================================
 
         //= SCALE =======================================================
-        auto GetScale()             const { return m_matrix.GetScale(); }
+        auto GetScale()             const { return GetMatrix().GetScale(); }
         const auto& GetScaleLocal() const { return m_scaleLocal; }
         void SetScale(const Math::Vector3& scale);
         void SetScaleLocal(const Math::Vector3& scale);
@@ -91,6 +99,7 @@ namespace Spartan
         bool HasChildren() const            { return GetChildrenCount() > 0 ? true : false; }
         uint32_t GetChildrenCount() const    { return static_cast<uint32_t>(m_children.size()); }
         void AddChild(Transform* child);
+        void AttachChild(Transform* child);
         Transform* GetRoot()            { return HasParent() ? GetParent()->GetRoot() : this; }
         Transform* GetParent() const    { return m_parent; }
         Transform* GetChildByIndex(uint32_t index);
@@ -98,26 +107,35 @@ namespace Spartan
         const std::vector<Transform*>& GetChildren() const    { return m_children; }
     
         void AcquireChildren();
+        void RemoveChildrenPendingDestruction();
         bool IsDescendantOf(const Transform* transform) const;
         void GetDescendants(std::vector<Transform*>* descendants);
         //======================================================================================
 
-        void LookAt(const Math::Vector3& v)                       { m_lookAt = v; }
-        const Math::Matrix& GetMatrix()                     const { return m_matrix; }     
-        const Math::Matrix& GetLocalMatrix()                const { return m_matrixLocal; }
+        void LookAt(const Math::Vector3& v);
+
+        // A dirty transform is computed on the spot, which isn't thread safe. The world brings every transform up to date
+        // before it's tick phases, after any phase that moves transforms and at the end of it's tick, so workers only read.
+        const Math::Matrix& GetMatrix()                     const { if (m_is_dirty) UpdateTransform(); return m_matrix; }
+        const Math::Matrix& GetLocalMatrix()                const { if (m_is_dirty) UpdateTransform(); return m_matrixLocal; }
         const Math::Matrix& GetWvpLastFrame()               const { return m_wvp_previous; }
         void SetWvpLastFrame(const Math::Matrix& matrix)          { m_wvp_previous = matrix;}
 
     private:
         Math::Matrix GetParentTransformMatrix() const;
+        void MarkDirty();
 
         // local
         Math::Vector3 m_positionLocal;
         Math::Quaternion m_rotationLocal;
         Math::Vector3 m_scaleLocal;
 
-        Math::Matrix m_matrix;
-        Math::Matrix m_matrixLocal;
+        // Derived from the above, they are stale while dirty.
+        // If a transform is dirty, so are all of its descendants.
+        mutable Math::Matrix m_matrix;
+        mutable Math::Matrix m_matrixLocal;
+        mutable bool m_is_dirty = true;
+        mutable bool m_is_moved = true;
         Math::Vector3 m_lookAt;
 
         Transform* m_parent; // the parent of this transform
@@ -48,6 +48,7 @@ namespace Spartan
     Entity::Entity(Context* context, uint32_t transform_id /*= 0*/)
     {
         m_context               = context;
+        m_world                 = context->GetSubsystem<World>();
         m_name                  = "Entity";
         m_is_active             = true;
         m_hierarchy_visibility  = true;
@@ -66,59 +67,69 @@ namespace Spartan
         for (auto it = m_components.begin(); it != m_components.end();)
         {
             (*it)->OnRemove();
+            m_world->GetComponentPool((*it)->GetType()).Remove((*it).get());
             (*it).reset();
             it = m_components.erase(it);
         }
         m_components.clear();
+        m_components_by_type = {};
+
+        // The transform is gone, so the world has to re-flatten it's hierarchy
+        m_world->TransformHierarchyChanged();
     }
 
-    void Entity::Clone()
+    void Entity::SetName(const string& name)
     {
-        auto scene = m_context->GetSubsystem<World>();
-        vector<Entity*> clones;
+        if (m_name == name)
+            return;
+
+        const string name_previous = m_name;
+        m_name      = name;
+        m_is_dirty  = true;
 
-        // Creation of new entity and copying of a few properties
-        auto clone_entity = [&scene, &clones](Entity* entity)
+        if (m_handle.IsValid())
         {
-            // Clone the name and the ID
-            auto clone = scene->EntityCreate().get();
-            clone->SetId(GenerateId());
-            clone->SetName(entity->GetName());
-            clone->SetActive(entity->IsActive());
-            clone->SetHierarchyVisibility(entity->IsVisibleInHierarchy());
-
-            // Clone all the components
-            for (const auto& component : entity->GetAllComponents())
-            {
-                const auto& original_comp    = component;
-                auto clone_comp                = clone->AddComponent(component->GetType());
-                clone_comp->SetAttributes(original_comp->GetAttributes());
-            }
+            m_world->OnEntityRenamed(this, name_previous);
+        }
+    }
 
-            clones.emplace_back(clone);
+    void Entity::SetActive(const bool active)
+    {
+        if (m_is_active == active)
+            return;
 
-            return clone;
-        };
+        m_is_active = active;
 
-        // Cloning of an entity and it's descendants (this is a recursive lambda)
-        function<Entity*(Entity*)> clone_entity_and_descendants = [&clone_entity_and_descendants, &clone_entity](Entity* original)
+        if (m_handle.IsValid())
         {
-            // clone self
-            const auto clone_self = clone_entity(original);
+            m_world->EntityChanged(this);
+        }
+    }
 
-            // clone children make them call this lambda
-            for (const auto& child_transform : original->GetTransform()->GetChildren())
-            {
-                const auto clone_child = clone_entity_and_descendants(child_transform->GetEntity());
-                clone_child->GetTransform()->SetParent(clone_self->GetTransform());
-            }
+    void Entity::SetId(const uint32_t id)
+    {
+        if (m_id == id)
+            return;
 
-            // return self
-            return clone_self;
-        };
+        if (m_handle.IsValid() && m_world->EntityGetById(id))
+        {
+            LOG_ERROR("Id %d is already used by another entity.", id);
+            return;
+        }
+
+        const uint32_t id_previous = m_id;
+        Spartan_Object::SetId(id);
+        m_is_dirty = true;
 
-        // Clone the entire hierarchy
-        clone_entity_and_descendants(this);
+        if (m_handle.IsValid())
+        {
+            m_world->OnEntityIdChanged(this, id_previous);
+        }
+    }
+
+    void Entity::Clone()
+    {
+        m_world->Instantiate(this, 1);
     }
 
     void Entity::Start()
@@ -205,14 +216,16 @@ namespace Spartan
         }
     }
 
-    void Entity::Deserialize(FileStream* stream, Transform* parent)
+    // The descendants are created without being added to the world, so that subtrees can be loaded in parallel.
+    // They are appended to descendants, parents before children, and it's up to the caller to add them to the world.
+    void Entity::Deserialize(FileStream* stream, Transform* parent, vector<shared_ptr<Entity>>* descendants)
     {
         // BASIC DATA
         {
             stream->Read(&m_is_active);
             stream->Read(&m_hierarchy_visibility);
-            stream->Read(&m_id);
-            stream->Read(&m_name);
+            SetId(stream->ReadAs<uint32_t>());
+            SetName(stream->ReadAs<string>());
         }
 
         // COMPONENTS
@@ -238,9 +251,9 @@ namespace Spartan
             }
 
             // Set the transform's parent
-            if (m_transform)
+            if (m_transform && parent)
             {
-                m_transform->SetParent(parent);
+                parent->AttachChild(m_transform);
             }
         }
 
@@ -250,29 +263,20 @@ namespace Spartan
             const auto children_count = stream->ReadAs<uint32_t>();
 
             // Children IDs
-            auto scene = m_context->GetSubsystem<World>();
-            vector<std::weak_ptr<Entity>> children;
+            const size_t children_start = descendants->size();
             for (uint32_t i = 0; i < children_count; i++)
             {
-                auto child = scene->EntityCreate();
+                auto& child = descendants->emplace_back(make_shared<Entity>(m_context));
                 child->SetId(stream->ReadAs<uint32_t>());
-                children.emplace_back(child);
-            }
-
-            // Children
-            for (const auto& child : children)
-            {
-                child.lock()->Deserialize(stream, GetTransform());
             }
 
-            if (m_transform)
+            // Children, the vector grows while they load their own children, so they are accessed by index
+            for (uint32_t i = 0; i < children_count; i++)
             {
-                m_transform->AcquireChildren();
+                Entity* child = (*descendants)[children_start + i].get();
+                child->Deserialize(stream, GetTransform(), descendants);
             }
         }
-
-        // Make the scene resolve
-        FIRE_EVENT(EventType::WorldResolve);
     }
 
     IComponent* Entity::AddComponent(const ComponentType type, uint32_t id /*= 0*/)
@@ -304,16 +308,14 @@ namespace Spartan
 
     void Entity::RemoveComponentById(const uint32_t id)
     {
-        ComponentType component_type = ComponentType::Unknown;
-
         for (auto it = m_components.begin(); it != m_components.end(); ) 
         {
             auto component = *it;
             if (id == component->GetId())
             {
-                component_type = component->GetType();
                 component->OnRemove();
                 it = m_components.erase(it);    
+                OnComponentRemoved(component.get());
                 break;
             }
             else
@@ -321,21 +323,72 @@ namespace Spartan
                 ++it;
             }
         }
+    }
+
+    void Entity::OnComponentAdded(IComponent* component)
+    {
+        const ComponentType type = component->GetType();
+
+        IComponent*& component_by_type = m_components_by_type[static_cast<uint32_t>(type)];
+        if (!component_by_type)
+        {
+            component_by_type = component;
+        }
+
+        m_component_mask |= GetComponentMask(type);
 
-        // The script component can have multiple instance, so only remove
-        // it's flag if there are no more components of that type left
-        bool others_of_same_type_exist = false;
-        for (auto it = m_components.begin(); it != m_components.end(); ++it)
+        if (type == ComponentType::Transform)
         {
-            others_of_same_type_exist = ((*it)->GetType() == component_type) ? true : others_of_same_type_exist;
+            m_world->TransformHierarchyChanged();
         }
 
-        if (!others_of_same_type_exist)
+        // Entities which aren't in the world yet (e.g. still loading) join the pools once they are registered
+        if (m_handle.IsValid())
         {
-            m_component_mask &= ~GetComponentMask(component_type);
+            m_world->ComponentAdded(component);
+            m_world->EntityChanged(this);
         }
+    }
+
+    void Entity::OnComponentRemoved(IComponent* component)
+    {
+        const ComponentType type = component->GetType();
+
+        m_world->ComponentRemoved(component);
 
-        // Make the scene resolve
-        FIRE_EVENT(EventType::WorldResolve);
+        if (type == ComponentType::Transform)
+        {
+            m_world->TransformHierarchyChanged();
+        }
+
+        // The script component can have multiple instances, so fall back to
+        // any other component of the same type, and only remove it's flag if there are none left
+        IComponent*& component_by_type = m_components_by_type[static_cast<uint32_t>(type)];
+        if (component_by_type == component)
+        {
+            component_by_type = nullptr;
+            for (const auto& other : m_components)
+            {
+                if (other->GetType() == type)
+                {
+                    component_by_type = other.get();
+                    break;
+                }
+            }
+        }
+
+        if (!component_by_type)
+        {
+            m_component_mask &= ~GetComponentMask(type);
+        }
+
+        // Caching of rendering performance critical components
+        if (component == m_transform)   { m_transform   = nullptr; }
+        if (component == m_renderable)  { m_renderable  = nullptr; }
+
+        if (m_handle.IsValid())
+        {
+            m_world->EntityChanged(this);
+        }
     }
 }
@@ -23,6 +23,9 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 
 //= INCLUDES =====================
 #include <vector>
+#include <array>
+#include <atomic>
+#include "ComponentPool.h"
 #include "../Core/EventSystem.h"
 #include "Components/IComponent.h"
 //================================
@@ -32,6 +35,19 @@ namespace Spartan
     class Context;
     class Transform;
     class Renderable;
+    class World;
+
+    // Refers to an entity without owning it, a handle to a removed entity is detected as stale (and resolves to nothing)
+    struct EntityHandle
+    {
+        static constexpr uint32_t index_invalid = static_cast<uint32_t>(-1);
+
+        uint32_t index      = index_invalid;
+        uint32_t generation = 0;
+
+        bool IsValid() const { return index != index_invalid; }
+        bool operator==(const EntityHandle& rhs) const { return index == rhs.index && generation == rhs.generation; }
+    };
     
     class SPARTAN_CLASS Entity : public Spartan_Object, public std::enable_shared_from_this<Entity>
     {
@@ -44,17 +60,29 @@ namespace Spartan
         void Stop();
         void Tick(float delta_time);
         void Serialize(FileStream* stream);
-        void Deserialize(FileStream* stream, Transform* parent);
+        void Deserialize(FileStream* stream, Transform* parent, std::vector<std::shared_ptr<Entity>>* descendants);
 
         //= PROPERTIES ===================================================================================================
         const std::string& GetName() const                                { return m_name; }
-        void SetName(const std::string& name)                            { m_name = name; }
+        void SetName(const std::string& name);
+
+        // Keeps the world's id lookup up to date, an id which another entity in the world already has is rejected
+        void SetId(uint32_t id) override;
+
+        // Assigned by the world when the entity is added to it
+        const EntityHandle& GetHandle() const                            { return m_handle; }
+        void SetHandle(const EntityHandle& handle)                        { m_handle = handle; }
 
         bool IsActive() const                                            { return m_is_active; }
-        void SetActive(const bool active)                                { m_is_active = active; }
+        void SetActive(bool active);
 
         bool IsVisibleInHierarchy() const                                { return m_hierarchy_visibility; }
-        void SetHierarchyVisibility(const bool hierarchy_visibility)    { m_hierarchy_visibility = hierarchy_visibility; }
+        void SetHierarchyVisibility(const bool hierarchy_visibility)    { m_hierarchy_visibility = hierarchy_visibility; m_is_dirty = true; }
+
+        // Dirty entities have changes which haven't been saved yet, they are serialized again on the next save
+        bool IsDirty() const                                            { return m_is_dirty; }
+        void MakeDirty()                                                { m_is_dirty = true; }
+        void ClearDirty()                                               { m_is_dirty = false; }
         //================================================================================================================
 
         // Adds a component of type T
@@ -67,24 +95,21 @@ namespace Spartan
             if (HasComponent(type) && type != ComponentType::Script)
                 return GetComponent<T>();
 
-            // Create a new component
-            std::shared_ptr<T> component = std::make_shared<T>(m_context, this, id);
+            // Create a new component, it's allocated next to the other components of the same type
+            std::shared_ptr<T> component = std::allocate_shared<T>(ComponentAllocator<T>(), m_context, this, id);
 
             // Save new component
             m_components.emplace_back(std::static_pointer_cast<IComponent>(component));
-            m_component_mask |= GetComponentMask(type);
+            component->SetType(type);
+            OnComponentAdded(component.get());
 
             // Caching of rendering performance critical components
             if constexpr (std::is_same<T, Transform>::value)    { m_transform   = static_cast<Transform*>(component.get()); }
             if constexpr (std::is_same<T, Renderable>::value)   { m_renderable  = static_cast<Renderable*>(component.get()); }
 
             // Initialize component
-            component->SetType(type);
             component->OnInitialize();
 
-            // Make the scene resolve
-            FIRE_EVENT(EventType::WorldResolve);
-
             return component.get();
         }
 
@@ -95,18 +120,7 @@ namespace Spartan
         template <class T>
         T* GetComponent()
         {
-            const ComponentType type = IComponent::TypeToEnum<T>();
-
-            if (!HasComponent(type))
-                return nullptr;
-
-            for (const auto& component : m_components)
-            {
-                if (component->GetType() == type)
-                    return static_cast<T*>(component.get());
-            }
-
-            return nullptr;
+            return static_cast<T*>(m_components_by_type[static_cast<uint32_t>(IComponent::TypeToEnum<T>())]);
         }
 
         // Returns any components of type T (if they exist)
@@ -150,16 +164,13 @@ namespace Spartan
                 {
                     component->OnRemove();
                     it = m_components.erase(it);
-                    m_component_mask &= ~GetComponentMask(type);
+                    OnComponentRemoved(component.get());
                 }
                 else
                 {
                     ++it;
                 }
             }
-
-            // Make the scene resolve
-            FIRE_EVENT(Event_World_Resolve_Pending);
         }
 
         void RemoveComponentById(uint32_t id);
@@ -176,15 +187,23 @@ namespace Spartan
     private:
         constexpr uint32_t GetComponentMask(ComponentType type) { return static_cast<uint32_t>(1) << static_cast<uint32_t>(type); }
 
+        // Keep the per type lookup, the mask and the world's component pools in sync
+        void OnComponentAdded(IComponent* component);
+        void OnComponentRemoved(IComponent* component);
+
         std::string m_name            = "Entity";
         bool m_is_active            = true;
         bool m_hierarchy_visibility    = true;
         Transform* m_transform        = nullptr;
         Renderable* m_renderable    = nullptr;
         bool m_destruction_pending  = false;
+        std::atomic<bool> m_is_dirty = true; // set from components which change on other threads (e.g. while loading)
         
         // Components
         std::vector<std::shared_ptr<IComponent>> m_components;
-        uint32_t m_component_mask = 0;
+        std::array<IComponent*, static_cast<uint32_t>(ComponentType::Unknown)> m_components_by_type = {}; // the first component of each type
+        uint32_t m_component_mask   = 0;
+        World* m_world              = nullptr;
+        EntityHandle m_handle;
     };
 }
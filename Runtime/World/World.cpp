@@ -23,8 +23,11 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "Spartan.h"
 #include "World.h"
 #include "Entity.h"
+#include "WorldFile.h"
+#include "WorldPartition.h"
 #include "Components/Transform.h"
 #include "Components/Camera.h"
+#include "Components/Renderable.h"
 #include "Components/Light.h"
 #include "Components/Environment.h"
 #include "Components/AudioListener.h"
@@ -35,6 +38,7 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include "../Rendering/Renderer.h"
 #include "../Input/Input.h"
 #include "../RHI/RHI_Device.h"
+#include "../Threading/Threading.h"
 //=====================================
 
 //= NAMESPACES ================
@@ -44,25 +48,146 @@ using namespace Spartan::Math;
 
 namespace Spartan
 {
+    namespace
+    {
+        // State that a tick phase reads or writes, other than the components it ticks
+        enum TickAccess : uint32_t
+        {
+            TickAccess_Transform    = 1 << 0,
+            TickAccess_Camera       = 1 << 1, // includes the renderer's camera
+            TickAccess_Light        = 1 << 2,
+            TickAccess_Physics      = 1 << 3,
+            TickAccess_Audio        = 1 << 4,
+            TickAccess_Input        = 1 << 5,
+            TickAccess_Renderer     = 1 << 6,
+            TickAccess_All          = ~0u
+        };
+
+        // Ticks all the components of a type. A phase whose components only touch their own state (chunked) is spread across
+        // the worker threads, alongside the other phases of it's stage. Any other phase runs on the calling (main) thread, since
+        // it's components talk to the rhi, bullet or fmod.
+        struct TickPhase
+        {
+            ComponentType type;
+            uint32_t reads;
+            uint32_t writes;
+            bool chunked;
+        };
+
+        // Listed in dependency order, only component types which do something in OnTick() are here.
+        // None of them is chunked at the moment, every OnTick() reaches outside of it's component (e.g. a light creates it's shadow map).
+        const TickPhase tick_phases[] =
+        {
+            { ComponentType::Script,        TickAccess_All,                                 TickAccess_All,                                 false },
+            { ComponentType::Camera,        TickAccess_Transform | TickAccess_Input,        TickAccess_Camera | TickAccess_Transform,       false },
+            { ComponentType::Constraint,    TickAccess_Transform | TickAccess_Physics,      TickAccess_Physics,                             false },
+            { ComponentType::RigidBody,     TickAccess_Transform,                           TickAccess_Physics,                             false },
+            { ComponentType::SoftBody,      TickAccess_Transform,                           TickAccess_Physics,                             false },
+            { ComponentType::Light,         TickAccess_Transform | TickAccess_Camera,       TickAccess_Light | TickAccess_Renderer,         false },
+            { ComponentType::AudioListener, TickAccess_Transform,                           TickAccess_Audio,                               false },
+            { ComponentType::AudioSource,   TickAccess_Transform | TickAccess_Audio,        TickAccess_Audio,                               false },
+            { ComponentType::Environment,   TickAccess_Renderer,                            TickAccess_Renderer,                            false }
+        };
+
+        // Groups consecutive phases which don't conflict into stages, the stages run one after the other.
+        // Conflicting phases never overlap and keep their relative order, so the outcome is deterministic.
+        const vector<vector<const TickPhase*>>& GetTickStages()
+        {
+            static const vector<vector<const TickPhase*>> stages = []()
+            {
+                vector<vector<const TickPhase*>> stages;
+                uint32_t stage_reads    = 0;
+                uint32_t stage_writes   = 0;
+
+                for (const TickPhase& phase : tick_phases)
+                {
+                    const bool conflicts = (phase.writes & (stage_reads | stage_writes)) || (phase.reads & stage_writes);
+                    if (stages.empty() || conflicts)
+                    {
+                        stages.emplace_back();
+                        stage_reads     = 0;
+                        stage_writes    = 0;
+                    }
+
+                    stages.back().emplace_back(&phase);
+                    stage_reads     |= phase.reads;
+                    stage_writes    |= phase.writes;
+                }
+
+                return stages;
+            }();
+
+            return stages;
+        }
+
+        // Reads some of the chunks which can be loaded in parallel, on the compute pool and through it's own stream
+        Async<void> ReadChunks(Context* context, const string& file_path, const vector<WorldFile::Chunk>& chunks, const vector<uint32_t>& indices, const uint32_t start, const uint32_t end, vector<vector<shared_ptr<Entity>>>& loaded)
+        {
+            co_await ScheduleOn(context->GetSubsystem<Threading>(), ThreadPool::Compute);
+
+            FileStream stream(file_path, FileStream_Read);
+            if (!stream.IsOpen())
+                co_return;
+
+            for (uint32_t i = start; i < end; i++)
+            {
+                const WorldFile::Chunk& chunk = chunks[indices[i]];
+                stream.SetPosition(chunk.offset);
+                WorldFile::ReadRoot(context, &stream, chunk.id, &loaded[indices[i]]);
+
+                if (stream.GetPosition() != chunk.offset + chunk.size)
+                {
+                    LOG_ERROR("%s: the chunk of entity %d has an unexpected size.", file_path.c_str(), chunk.id);
+                }
+            }
+        }
+
+        // Renderables without geometry are kept as a point, the tree can't deal with an undefined box
+        BoundingBox GetRenderableBounds(Renderable* renderable)
+        {
+            const BoundingBox& aabb = renderable->GetAabb();
+            if (aabb.Defined())
+                return aabb;
+
+            const Vector3 position = renderable->GetTransform()->GetPosition();
+            return BoundingBox(position, position);
+        }
+    }
+
     World::World(Context* context) : ISubsystem(context)
     {
         // Subscribe to events
-        SUBSCRIBE_TO_EVENT(EventType::WorldResolve, [this](Variant) { m_is_dirty = true; });
-        SUBSCRIBE_TO_EVENT(EventType::WorldStop,    [this](Variant)    { m_state = WorldState::Idle; });
-        SUBSCRIBE_TO_EVENT(EventType::WorldStart,   [this](Variant)    { m_state = WorldState::Ticking; });
+        m_event_world_resolve   = SUBSCRIBE_TO_EVENT(EventType::WorldResolve,   [this](const EventData&) { m_is_dirty = true; });
+        m_event_world_stop      = SUBSCRIBE_TO_EVENT(EventType::WorldStop,      [this](const EventData&) { m_state = WorldState::Idle; });
+        m_event_world_start     = SUBSCRIBE_TO_EVENT(EventType::WorldStart,     [this](const EventData&) { m_state = WorldState::Ticking; });
     }
 
     World::~World()
     {
+        // Let any save that is in progress finish
+        if (m_threading)
+        {
+            m_threading->Wait(m_save_task);
+        }
+
+        // Unsubscribe from events
+        UNSUBSCRIBE_FROM_EVENT(m_event_world_resolve);
+        UNSUBSCRIBE_FROM_EVENT(m_event_world_stop);
+        UNSUBSCRIBE_FROM_EVENT(m_event_world_start);
+
         Unload();
+        m_partition = nullptr;
         m_input     = nullptr;
         m_profiler  = nullptr;
+        m_threading = nullptr;
     }
 
     bool World::Initialize()
     {
         m_input        = m_context->GetSubsystem<Input>();
         m_profiler    = m_context->GetSubsystem<Profiler>();
+        m_threading   = m_context->GetSubsystem<Threading>();
+        m_partition   = make_unique<WorldPartition>(m_context, this);
 
         CreateCamera();
         CreateEnvironment();
@@ -79,11 +204,20 @@ namespace Spartan
             return;
         }
 
+        // Between two ticks nothing is changing the world, so it's where saving takes it's snapshot
+        if (m_state != WorldState::Loading)
+        {
+            SaveSnapshot();
+        }
+
         if (m_state != WorldState::Ticking)
             return;
 
         SCOPED_TIME_BLOCK(m_profiler);
 
+        // Stream cells in and out around the camera
+        m_partition->Tick();
+
         // Tick entities
         {
             // Detect game toggling
@@ -100,41 +234,191 @@ namespace Spartan
                 }
             }
 
-            // Stop
+            // Stop, anything could have changed while the game was running, so everything has to be saved again
             if (stopped)
             {
                 for (const auto& entity : m_entities)
                 {
                     entity->Stop();
+                    entity->MakeDirty();
                 }
             }
 
+            // Bring what moved since the last tick (physics, the editor, etc) up to date, so that no phase computes a transform lazily
+            TransformsUpdate();
+
             // Tick
-            for (const auto& entity : m_entities)
+            TickPhases(delta_time);
+        }
+
+        // Remove entities which are pending destruction
+        if (m_destruction_pending)
+        {
+            m_destruction_pending = false;
+            EntitiesDestroyPending();
+        }
+
+        // Everything the renderer reads this frame is up to date
+        TransformsUpdate();
+
+        // Notify Renderer, with what changed since the last resolve (or with everything)
+        WorldResolveDelta delta;
+        {
+            lock_guard<mutex> lock(m_mutex_changes);
+
+            delta.full = m_is_dirty;
+            if (!delta.full)
             {
-                entity->Tick(delta_time);
+                delta.changed.assign(m_entities_changed.begin(), m_entities_changed.end());
+                delta.removed.swap(m_entities_removed);
             }
+
+            m_entities_changed.clear();
+            m_entities_removed.clear();
+            m_is_dirty = false;
         }
 
-        if (m_is_dirty)
+        if (delta.full || !delta.changed.empty() || !delta.removed.empty())
         {
-            // Update dirty entities
+            FIRE_EVENT_DATA(EventType::WorldResolved, delta);
+        }
+    }
+
+    void World::TickPhases(const float delta_time)
+    {
+        for (const vector<const TickPhase*>& stage : GetTickStages())
+        {
+            // Chunked phases run as tasks, the rest run on this thread (in order) while they do
+            vector<TaskHandle> tasks;
+            for (const TickPhase* phase : stage)
             {
-                // Make a copy so we can iterate while removing entities
-                auto entities_copy = m_entities;
+                if (phase->chunked && GetComponentPool(phase->type).GetCount() != 0)
+                {
+                    tasks.emplace_back(m_threading->AddTask([this, phase, delta_time]() { TickComponents(phase->type, true, delta_time); }, TaskPriority::Critical));
+                }
+            }
 
-                for (const auto& entity : entities_copy)
+            for (const TickPhase* phase : stage)
+            {
+                if (!phase->chunked && GetComponentPool(phase->type).GetCount() != 0)
                 {
-                    if (entity->IsPendingDestruction())
-                    {
-                        _EntityRemove(entity);
-                    }
+                    TickComponents(phase->type, false, delta_time);
                 }
             }
 
-            // Notify Renderer
-            FIRE_EVENT_DATA(EventType::WorldResolved, m_entities);
-            m_is_dirty = false;
+            for (const TaskHandle& task : tasks)
+            {
+                m_threading->Wait(task);
+            }
+
+            // Bring moved transforms up to date, so that later phases can read them from any thread
+            const bool writes_transforms = any_of(stage.begin(), stage.end(), [](const TickPhase* phase) { return phase->writes & TickAccess_Transform; });
+            if (writes_transforms)
+            {
+                TransformsUpdate();
+            }
+        }
+    }
+
+    void World::TransformsUpdate()
+    {
+        SCOPED_TIME_BLOCK(m_profiler);
+
+        // Flatten the hierarchy so that parents come before their children
+        if (m_transforms_ordered_dirty.exchange(false))
+        {
+            m_transforms_ordered.clear();
+
+            for (IComponent* component : GetComponentPool(ComponentType::Transform).GetAll())
+            {
+                Transform* transform = static_cast<Transform*>(component);
+                if (transform->IsRoot())
+                {
+                    m_transforms_ordered.emplace_back(transform);
+                }
+            }
+
+            // Breadth first, appending to the array we walk
+            for (uint32_t i = 0; i < static_cast<uint32_t>(m_transforms_ordered.size()); i++)
+            {
+                const vector<Transform*>& children = m_transforms_ordered[i]->GetChildren();
+                m_transforms_ordered.insert(m_transforms_ordered.end(), children.begin(), children.end());
+            }
+        }
+
+        // Gather the dirty transforms, keeping parents before children
+        m_transforms_dirty.clear();
+        for (Transform* transform : m_transforms_ordered)
+        {
+            if (transform->IsDirty())
+            {
+                m_transforms_dirty.emplace_back(transform);
+            }
+        }
+
+        if (!m_transforms_dirty.empty())
+        {
+            // Compose their local matrices in one batch
+            const uint32_t count = static_cast<uint32_t>(m_transforms_dirty.size());
+            m_transforms_positions.resize(count);
+            m_transforms_rotations.resize(count);
+            m_transforms_scales.resize(count);
+            m_transforms_matrices.resize(count);
+            for (uint32_t i = 0; i < count; i++)
+            {
+                m_transforms_positions[i]   = m_transforms_dirty[i]->GetPositionLocal();
+                m_transforms_rotations[i]   = m_transforms_dirty[i]->GetRotationLocal();
+                m_transforms_scales[i]      = m_transforms_dirty[i]->GetScaleLocal();
+            }
+            Matrix::ComposeBatch(m_transforms_positions.data(), m_transforms_rotations.data(), m_transforms_scales.data(), m_transforms_matrices.data(), count);
+
+            // A parent is always up to date by the time it's children are reached, so each transform only computes itself
+            for (uint32_t i = 0; i < count; i++)
+            {
+                m_transforms_dirty[i]->UpdateTransform(m_transforms_matrices[i]);
+            }
+        }
+
+        // Move the renderables in the tree, this includes transforms which were updated lazily (when their matrix was requested)
+        for (Transform* transform : m_transforms_ordered)
+        {
+            if (!transform->IsMoved())
+                continue;
+
+            transform->ClearMoved();
+
+            Renderable* renderable = transform->GetEntity()->GetRenderable();
+            if (renderable && renderable->GetTreeProxy() != AabbTree::null_node)
+            {
+                m_renderables_tree.Update(renderable->GetTreeProxy(), GetRenderableBounds(renderable));
+            }
+        }
+    }
+
+    void World::TickComponents(const ComponentType type, const bool chunked, const float delta_time)
+    {
+        const vector<IComponent*>& components = GetComponentPool(type).GetAll();
+
+        auto tick = [&components, delta_time](const uint32_t start, const uint32_t end)
+        {
+            for (uint32_t i = start; i < end && i < components.size(); i++)
+            {
+                IComponent* component = components[i];
+                if (component->GetEntity()->IsActive())
+                {
+                    component->OnTick(delta_time);
+                }
+            }
+        };
+
+        if (chunked)
+        {
+            m_threading->ParallelFor(static_cast<uint32_t>(components.size()), tick);
+        }
+        else
+        {
+            // Serial phases (e.g. scripts) may remove components, so the size is checked as they go
+            tick(0, static_cast<uint32_t>(-1));
         }
     }
 
@@ -143,59 +427,176 @@ namespace Spartan
         // Notify any systems that the entities are about to be cleared
         FIRE_EVENT(EventType::WorldUnload);
 
+        if (m_partition)
+        {
+            m_partition->Close();
+        }
+
+        EntityUnregisterAll();
         m_entities.clear();
         m_entities.shrink_to_fit();
+        m_roots_saved.clear();
 
         m_is_dirty = true;
     }
 
     bool World::SaveToFile(const string& filePathIn)
     {
-        // Start progress report and timer
-        ProgressReport::Get().Reset(g_progress_world);
-        ProgressReport::Get().SetIsLoading(g_progress_world, true);
-        ProgressReport::Get().SetStatus(g_progress_world, "Saving world...");
-        const Stopwatch timer;
-    
         // Add scene file extension to the filepath if it's missing
         auto file_path = filePathIn;
         if (FileSystem::GetExtensionFromFilePath(file_path) != EXTENSION_WORLD)
         {
             file_path += EXTENSION_WORLD;
         }
-        m_name = FileSystem::GetFileNameNoExtensionFromFilePath(file_path);
 
-        // Notify subsystems that need to save data
-        FIRE_EVENT(EventType::WorldSave);
+        const string directory = FileSystem::GetDirectoryFromFilePath(file_path);
+        if (!directory.empty() && !FileSystem::IsDirectory(directory))
+        {
+            LOG_ERROR("Failed to save %s, the directory doesn't exist.", file_path.c_str());
+            return false;
+        }
 
-        // Create a prefab file
-        auto file = make_unique<FileStream>(file_path, FileStream_Write);
-        if (!file->IsOpen())
+        // The snapshot is taken between two ticks, and it's written to the file on an I/O thread.
+        // Saves that are requested before that are merged into one.
+        lock_guard<mutex> lock(m_mutex_save);
+        m_save_file_path = file_path;
+
+        return true;
+    }
+
+    bool World::SaveToFilePartitioned(const string& file_path, const float cell_size)
+    {
+        if (m_partition->IsEnabled())
         {
-            LOG_ERROR_GENERIC_FAILURE();
+            LOG_ERROR("The world is already partitioned.");
             return false;
         }
 
-        // Only save root entities as they will also save their descendants
-        auto root_actors = EntityGetRoots();
-        const auto root_entity_count = static_cast<uint32_t>(root_actors.size());
+        if (cell_size <= 0.0f)
+        {
+            LOG_ERROR_INVALID_PARAMETER();
+            return false;
+        }
+
+        if (!SaveToFile(file_path))
+            return false;
 
-        ProgressReport::Get().SetJobCount(g_progress_world, root_entity_count);
+        // The roots are moved into the cells when the snapshot is taken, so the world file is written without them
+        lock_guard<mutex> lock(m_mutex_save);
+        m_save_cell_size = cell_size;
+
+        return true;
+    }
 
-        // Save root entity count
-        file->Write(root_entity_count);
+    void World::SaveSnapshot()
+    {
+        // One save at a time, as they write to the same files. A request made in the meantime waits for the next tick.
+        if (!m_save_task.IsDone())
+            return;
 
-        // Save root entity IDs
-        for (const auto& root : root_actors)
+        auto snapshot   = make_shared<WorldSnapshot>();
+        float cell_size = 0.0f;
         {
-            file->Write(root->GetId());
+            lock_guard<mutex> lock(m_mutex_save);
+            if (m_save_file_path.empty())
+                return;
+
+            snapshot->file_path.swap(m_save_file_path);
+            cell_size = exchange(m_save_cell_size, 0.0f);
         }
 
-        // Save root entities
-        for (const auto& root : root_actors)
+        // The roots which are moved into cells are removed from the world, so the snapshot below won't include them
+        if (cell_size != 0.0f && !m_partition->Build(snapshot->file_path, cell_size))
         {
-            root->Serialize(file.get());
-            ProgressReport::Get().IncrementJobsDone(g_progress_world);
+            LOG_ERROR("Failed to partition %s, it's saved as a whole.", snapshot->file_path.c_str());
+        }
+
+        const Stopwatch timer;
+        m_name = FileSystem::GetFileNameNoExtensionFromFilePath(snapshot->file_path);
+
+        // Serialize the roots which changed since the last save, the rest are shared with it.
+        // Only save root entities as they will also save their descendants.
+        unordered_map<uint32_t, WorldSnapshot::Root> roots_saved;
+        uint32_t roots_serialized = 0;
+        for (const shared_ptr<Entity>& entity : EntityGetRoots())
+        {
+            Entity* root = entity.get();
+            if (root->IsPendingDestruction() || m_partition->IsStreamed(root))
+                continue;
+
+            vector<Transform*> descendants;
+            root->GetTransform()->GetDescendants(&descendants);
+
+            bool is_dirty = root->IsDirty();
+            for (uint32_t i = 0; i < static_cast<uint32_t>(descendants.size()) && !is_dirty; i++)
+            {
+                is_dirty = descendants[i]->GetEntity()->IsDirty();
+            }
+
+            const auto it = m_roots_saved.find(root->GetId());
+            WorldSnapshot::Root saved;
+            if (!is_dirty && it != m_roots_saved.end())
+            {
+                saved = it->second;
+            }
+            else
+            {
+                saved = WorldFile::SerializeRoot(root);
+                roots_serialized++;
+            }
+
+            snapshot->roots.emplace_back(saved);
+            roots_saved[saved.id] = saved;
+        }
+        m_roots_saved.swap(roots_saved);
+
+        // Streamed roots are saved to their cells
+        m_partition->Save(snapshot->file_path);
+
+        // Notify subsystems that need to save data, they serialize it into the snapshot while nothing is changing it
+        FIRE_EVENT_DATA(EventType::WorldSave, snapshot.get());
+
+        LOG_INFO("Snapshot took %.2f ms, %d of %d roots had to be serialized", timer.GetElapsedTimeMs(), roots_serialized, static_cast<uint32_t>(snapshot->roots.size()));
+
+        m_save_task = m_threading->AddTaskIo([this, snapshot]() { SaveSnapshotToFile(*snapshot); });
+    }
+
+    bool World::SaveSnapshotToFile(const WorldSnapshot& snapshot)
+    {
+        // Start progress report and timer
+        ProgressReport::Get().Reset(g_progress_world);
+        ProgressReport::Get().SetIsLoading(g_progress_world, true);
+        ProgressReport::Get().SetStatus(g_progress_world, "Saving world...");
+        const Stopwatch timer;
+
+        ProgressReport::Get().SetJobCount(g_progress_world, static_cast<int>(snapshot.roots.size()));
+
+        bool saved = true;
+        for (const WorldSnapshot::File& file : snapshot.files)
+        {
+            {
+                FileStream stream(file.file_path, FileStream_Write);
+                if (!stream.IsOpen())
+                {
+                    LOG_ERROR("Failed to save %s", file.file_path.c_str());
+                    saved = false;
+                    continue;
+                }
+
+                stream.WriteRaw(file.data.data(), file.data.size());
+            }
+
+            // The file matches what was serialized now, later changes keep the resource dirty
+            if (file.resource)
+            {
+                file.resource->ClearDirty(file.resource_revision);
+            }
+        }
+
+        if (!WorldFile::Write(snapshot, true))
+        {
+            LOG_ERROR("Failed to save %s", snapshot.file_path.c_str());
+            saved = false;
         }
 
         // Finish with progress report and timer
@@ -203,19 +604,26 @@ namespace Spartan
         LOG_INFO("Saving took %.2f ms", timer.GetElapsedTimeMs());
 
         // Notify subsystems waiting for us to finish
-        FIRE_EVENT(EventType::WorldSaved);
+        QUEUE_EVENT_DATA(EventType::WorldSaved, move(saved));
 
-        return true;
+        return saved;
     }
 
     bool World::LoadFromFile(const string& file_path)
+    {
+        return LoadFromFileAsync(file_path).Get();
+    }
+
+    Async<bool> World::LoadFromFileAsync(const string file_path)
     {
         if (!FileSystem::Exists(file_path))
         {
             LOG_ERROR("%s was not found.", file_path.c_str());
-            return false;
+            co_return false;
         }
 
+        co_await ScheduleOn(m_threading, ThreadPool::Io);
+
         // Thread safety: Wait for the world and the renderer to stop using entities
         while (m_state != WorldState::Loading || m_context->GetSubsystem<Renderer>()->IsRendering())
         {
@@ -232,48 +640,138 @@ namespace Spartan
         // Unload current entities
         Unload();
 
-        // Read all the resource file paths
         auto file = make_unique<FileStream>(file_path, FileStream_Read);
         if (!file->IsOpen())
-            return false;
+        {
+            ProgressReport::Get().SetIsLoading(g_progress_world, false);
+            m_state = WorldState::Ticking;
+            co_return false;
+        }
 
         m_name = FileSystem::GetFileNameNoExtensionFromFilePath(file_path);
 
         // Notify subsystems that need to load data
         FIRE_EVENT(EventType::WorldLoad);
 
-        // Load root entity count
-        const auto root_entity_count = file->ReadAs<uint32_t>();
+        // Entities reference the resources, so they are loaded first (concurrently, without holding a thread while they do)
+        co_await m_context->GetSubsystem<ResourceCache>()->LoadResourcesFromFiles();
+
+        // Header, older files don't have one and start with the root count
+        uint32_t version        = 0;
+        uint32_t root_count     = 0;
+        const bool has_contents = WorldFile::ReadHeader(file.get(), &version, &root_count);
+        if (version > WorldFile::version)
+        {
+            LOG_ERROR("%s is of version %d, the latest supported version is %d.", file_path.c_str(), version, WorldFile::version);
+            ProgressReport::Get().SetIsLoading(g_progress_world, false);
+            m_state = WorldState::Ticking;
+            co_return false;
+        }
+
+        ProgressReport::Get().SetJobCount(g_progress_world, root_count);
 
-        ProgressReport::Get().SetJobCount(g_progress_world, root_entity_count);
+        // Every root and it's descendants, they are added to the world once they are all loaded
+        vector<vector<shared_ptr<Entity>>> loaded(root_count);
+        auto load_root = [this, &loaded](FileStream* stream, const uint32_t index, const uint32_t id)
+        {
+            WorldFile::ReadRoot(m_context, stream, id, &loaded[index]);
+        };
 
-        // Load root entity IDs
-        for (uint32_t i = 0; i < root_entity_count; i++)
+        if (!has_contents)
         {
-            auto& entity = EntityCreate();
-            entity->SetId(file->ReadAs<uint32_t>());
+            vector<uint32_t> ids(root_count);
+            for (uint32_t& id : ids)
+            {
+                file->Read(&id);
+            }
+
+            for (uint32_t i = 0; i < root_count; i++)
+            {
+                load_root(file.get(), i, ids[i]);
+                ProgressReport::Get().IncrementJobsDone(g_progress_world);
+            }
+        }
+        else
+        {
+            vector<WorldFile::Chunk> chunks(root_count);
+            WorldFile::ReadContents(file.get(), chunks);
+
+            // A chunk that doesn't end where the contents say, means that the file is corrupt
+            auto validate_chunk = [&file_path](FileStream* stream, const WorldFile::Chunk& chunk)
+            {
+                if (stream->GetPosition() != chunk.offset + chunk.size)
+                {
+                    LOG_ERROR("%s: the chunk of entity %d has an unexpected size.", file_path.c_str(), chunk.id);
+                }
+            };
+
+            vector<uint32_t> chunks_parallel;
+            vector<uint32_t> chunks_serial;
+            for (uint32_t i = 0; i < root_count; i++)
+            {
+                (WorldFile::IsParallelLoadable(chunks[i]) ? chunks_parallel : chunks_serial).emplace_back(i);
+            }
+
+            // Split them in a group per thread, and wait for the groups without holding this thread
+            const uint32_t count_parallel   = static_cast<uint32_t>(chunks_parallel.size());
+            const uint32_t group_count      = Helper::Min(count_parallel, m_threading->GetThreadCount() + 1);
+            vector<Async<void>> groups;
+            groups.reserve(group_count);
+            for (uint32_t group = 0; group < group_count; group++)
+            {
+                const uint32_t start    = count_parallel * group / group_count;
+                const uint32_t end      = count_parallel * (group + 1) / group_count;
+                groups.emplace_back(ReadChunks(m_context, file_path, chunks, chunks_parallel, start, end, loaded));
+            }
+            co_await WhenAll(move(groups));
+            ProgressReport::Get().SetJobsDone(g_progress_world, static_cast<int>(count_parallel));
+
+            for (const uint32_t index : chunks_serial)
+            {
+                const WorldFile::Chunk& chunk = chunks[index];
+                file->SetPosition(chunk.offset);
+                load_root(file.get(), index, chunk.id);
+                validate_chunk(file.get(), chunk);
+                ProgressReport::Get().IncrementJobsDone(g_progress_world);
+            }
         }
 
-        // Serialize root entities
-        for (uint32_t i = 0; i < root_entity_count; i++)
+        // Add everything to the world, in the order it was saved
+        size_t entity_count = 0;
+        for (const vector<shared_ptr<Entity>>& entities : loaded)
         {
-            m_entities[i]->Deserialize(file.get(), nullptr);
-            ProgressReport::Get().IncrementJobsDone(g_progress_world);
+            entity_count += entities.size();
+        }
+        m_entities.reserve(entity_count);
+
+        for (vector<shared_ptr<Entity>>& entities : loaded)
+        {
+            WorldFile::ReadRootFinish(entities);
+            for (shared_ptr<Entity>& entity : entities)
+            {
+                EntityRegister(entity);
+                m_entities.emplace_back(move(entity));
+            }
         }
+        TransformHierarchyChanged();
+
+        // Partitioned worlds stream the rest of their roots in, once ticking
+        m_partition->Open(WorldPartition::GetDirectory(file_path));
 
         m_is_dirty    = true;
         m_state        = WorldState::Ticking;
         ProgressReport::Get().SetIsLoading(g_progress_world, false);    
         LOG_INFO("Loading took %.2f ms", timer.GetElapsedTimeMs());
 
-        FIRE_EVENT(EventType::WorldLoaded);
-        return true;
+        QUEUE_EVENT(EventType::WorldLoaded);
+        co_return true;
     }
 
     shared_ptr<Entity>& World::EntityCreate(bool is_active /*= true*/)
     {
         auto& entity = m_entities.emplace_back(make_shared<Entity>(m_context));
         entity->SetActive(is_active);
+        EntityRegister(entity);
         return entity;
     }
 
@@ -284,9 +782,117 @@ namespace Spartan
         if (!entity)
             return empty;
 
+        EntityRegister(entity);
         return m_entities.emplace_back(entity);
     }
 
+    // Spawns count copies of the prefab and it's descendants, the copies are roots, placed with transforms[i] (if provided).
+    // Components are copied through their attribute tables, so models and materials are shared, not duplicated.
+    vector<shared_ptr<Entity>> World::Instantiate(Entity* prefab, const uint32_t count, const Matrix* transforms /*= nullptr*/)
+    {
+        vector<shared_ptr<Entity>> roots;
+
+        if (!prefab || count == 0)
+            return roots;
+
+        // Flatten the prefab hierarchy, parents before children
+        struct Node
+        {
+            Entity* entity;
+            uint32_t parent;
+        };
+        static constexpr uint32_t no_parent = static_cast<uint32_t>(-1);
+
+        vector<Node> nodes = { { prefab, no_parent } };
+        for (uint32_t i = 0; i < static_cast<uint32_t>(nodes.size()); i++)
+        {
+            Transform* transform = nodes[i].entity->GetTransform();
+            for (Transform* child : transform->GetChildren())
+            {
+                nodes.push_back({ child->GetEntity(), i });
+            }
+        }
+
+        // Reserve everything once
+        const uint32_t entity_count = count * static_cast<uint32_t>(nodes.size());
+        {
+            array<uint32_t, static_cast<uint32_t>(ComponentType::Unknown)> component_counts = {};
+            for (const Node& node : nodes)
+            {
+                for (const auto& component : node.entity->GetAllComponents())
+                {
+                    component_counts[static_cast<uint32_t>(component->GetType())]++;
+                }
+            }
+
+            for (uint32_t i = 0; i < static_cast<uint32_t>(component_counts.size()); i++)
+            {
+                ComponentPool& pool = m_component_pools[i];
+                if (component_counts[i] != 0)
+                {
+                    pool.Reserve(pool.GetCount() + component_counts[i] * count);
+                }
+            }
+
+            m_entities.reserve(m_entities.size() + entity_count);
+            m_entity_slots.reserve(m_entity_slots.size() + entity_count);
+            m_entity_slot_by_id.reserve(m_entity_slot_by_id.size() + entity_count);
+            roots.reserve(count);
+
+            lock_guard<mutex> lock(m_mutex_changes);
+            m_entities_changed.reserve(m_entities_changed.size() + entity_count);
+        }
+
+        // Clone, the entities are registered only once they are complete, so that each one is reported as changed once
+        vector<Entity*> clones(nodes.size());
+        for (uint32_t instance = 0; instance < count; instance++)
+        {
+            for (uint32_t i = 0; i < static_cast<uint32_t>(nodes.size()); i++)
+            {
+                Entity* original            = nodes[i].entity;
+                shared_ptr<Entity>& clone   = m_entities.emplace_back(make_shared<Entity>(m_context));
+
+                clone->SetName(original->GetName());
+                clone->SetActive(original->IsActive());
+                clone->SetHierarchyVisibility(original->IsVisibleInHierarchy());
+
+                for (const auto& component : original->GetAllComponents())
+                {
+                    clone->AddComponent(component->GetType())->CopyAttributes(component.get());
+                }
+
+                if (nodes[i].parent != no_parent)
+                {
+                    clones[nodes[i].parent]->GetTransform()->AttachChild(clone->GetTransform());
+                }
+                else
+                {
+                    if (transforms)
+                    {
+                        Vector3 scale;
+                        Quaternion rotation;
+                        Vector3 position;
+                        transforms[instance].Decompose(scale, rotation, position);
+
+                        Transform* transform = clone->GetTransform();
+                        transform->SetPositionLocal(position);
+                        transform->SetRotationLocal(rotation);
+                        transform->SetScaleLocal(scale);
+                    }
+
+                    roots.emplace_back(clone);
+                }
+
+                EntityRegister(clone);
+                clones[i] = clone.get();
+            }
+        }
+
+        TransformHierarchyChanged();
+
+        return roots;
+    }
+
     bool World::EntityExists(const shared_ptr<Entity>& entity)
     {
         if (!entity)
@@ -303,7 +909,7 @@ namespace Spartan
         // Mark for destruction but don't delete now
         // as the Renderer might still be using it.
         entity->MarkForDestruction();
-        m_is_dirty = true;
+        m_destruction_pending = true;
     }
 
     vector<shared_ptr<Entity>> World::EntityGetRoots()
@@ -322,11 +928,9 @@ namespace Spartan
 
     const shared_ptr<Entity>& World::EntityGetByName(const string& name)
     {
-        for (const auto& entity : m_entities)
-        {
-            if (entity->GetName() == name)
-                return entity;
-        }
+        const auto it = m_entity_ids_by_name.find(name);
+        if (it != m_entity_ids_by_name.end() && !it->second.empty())
+            return EntityGetById(it->second.front());
 
         static shared_ptr<Entity> empty;
         return empty;
@@ -334,45 +938,310 @@ namespace Spartan
 
     const shared_ptr<Entity>& World::EntityGetById(const uint32_t id)
     {
+        const auto it = m_entity_slot_by_id.find(id);
+        if (it != m_entity_slot_by_id.end())
+            return m_entity_slots[it->second].entity;
+
+        static shared_ptr<Entity> empty;
+        return empty;
+    }
+
+    const shared_ptr<Entity>& World::EntityGetByHandle(const EntityHandle& handle)
+    {
+        if (handle.IsValid() && handle.index < m_entity_slots.size() && m_entity_slots[handle.index].generation == handle.generation)
+            return m_entity_slots[handle.index].entity;
+
+        static shared_ptr<Entity> empty;
+        return empty;
+    }
+
+    // Removes all entities pending destruction, along with their descendants, in a single pass
+    void World::EntitiesDestroyPending()
+    {
+        SCOPED_TIME_BLOCK(m_profiler);
+
+        // Mark the descendants of pending entities, each entity is pushed at most once
+        vector<Transform*> stack;
         for (const auto& entity : m_entities)
         {
-            if (entity->GetId() == id)
-                return entity;
+            if (entity->IsPendingDestruction())
+            {
+                stack.emplace_back(entity->GetTransform());
+            }
         }
 
-        static shared_ptr<Entity> empty;
-        return empty;
+        while (!stack.empty())
+        {
+            Transform* transform = stack.back();
+            stack.pop_back();
+
+            for (Transform* child : transform->GetChildren())
+            {
+                if (!child->GetEntity()->IsPendingDestruction())
+                {
+                    child->GetEntity()->MarkForDestruction();
+                    stack.emplace_back(child);
+                }
+            }
+        }
+
+        // Compact the entities (preserving their order) and unregister the removed ones
+        vector<shared_ptr<Entity>> entities_removed;
+        unordered_set<Transform*> parents;
+        uint32_t count = 0;
+        for (uint32_t i = 0; i < static_cast<uint32_t>(m_entities.size()); i++)
+        {
+            shared_ptr<Entity>& entity = m_entities[i];
+
+            if (entity->IsPendingDestruction())
+            {
+                // Surviving parents have to forget about this entity
+                Transform* parent = entity->GetTransform()->GetParent();
+                if (parent && !parent->GetEntity()->IsPendingDestruction())
+                {
+                    parents.emplace(parent);
+                }
+
+                EntityUnregister(entity.get());
+                entities_removed.emplace_back(move(entity));
+            }
+            else
+            {
+                if (i != count)
+                {
+                    m_entities[count] = move(entity);
+                }
+                count++;
+            }
+        }
+        m_entities.resize(count);
+
+        for (Transform* parent : parents)
+        {
+            parent->RemoveChildrenPendingDestruction();
+        }
+
+        // Let the renderer know, in bulk
+        {
+            lock_guard<mutex> lock(m_mutex_changes);
+
+            for (const auto& entity : entities_removed)
+            {
+                m_entities_changed.erase(entity.get());
+                m_entities_removed.emplace_back(entity.get());
+            }
+        }
+
+        // The entities (and their components, which remove themselves from physics) are destroyed here.
+        // TODO: Physics is still told one body at a time. Bullet 2.89 has no bulk removal, each body walks the
+        // whole overlapping pair cache (cleanProxyFromPairs() and destroyProxy()) and the non-static body list.
+        // Removing many bodies at once needs a pass over the pair cache which drops all of their pairs together.
+        entities_removed.clear();
+    }
+
+    void World::EntityRegister(const shared_ptr<Entity>& entity)
+    {
+        // Already registered
+        if (entity->GetHandle().IsValid())
+            return;
+
+        // Ids are unique within the world (the lookup by id holds one entity per id), a duplicate gets a new one
+        if (m_entity_slot_by_id.find(entity->GetId()) != m_entity_slot_by_id.end())
+        {
+            LOG_WARNING("Id %d is already used by another entity, \"%s\" gets a new one.", entity->GetId(), entity->GetName().c_str());
+            entity->SetId(Spartan_Object::GenerateId());
+        }
+
+        uint32_t index = static_cast<uint32_t>(m_entity_slots.size());
+        if (!m_entity_slots_free.empty())
+        {
+            index = m_entity_slots_free.back();
+            m_entity_slots_free.pop_back();
+        }
+        else
+        {
+            m_entity_slots.emplace_back();
+        }
+
+        EntitySlot& slot    = m_entity_slots[index];
+        slot.entity         = entity;
+        entity->SetHandle({ index, slot.generation });
+
+        m_entity_slot_by_id[entity->GetId()] = index;
+        m_entity_ids_by_name[entity->GetName()].emplace_back(entity->GetId());
+
+        // Components are ticked (and seen by the renderer) only from here on, entities can be built on other threads until now
+        for (const auto& component : entity->GetAllComponents())
+        {
+            ComponentAdded(component.get());
+        }
+
+        EntityChanged(entity.get());
+    }
+
+    void World::EntityUnregister(Entity* entity)
+    {
+        const EntityHandle handle = entity->GetHandle();
+        if (!handle.IsValid())
+            return;
+
+        const auto it = m_entity_slot_by_id.find(entity->GetId());
+        if (it != m_entity_slot_by_id.end() && it->second == handle.index)
+        {
+            m_entity_slot_by_id.erase(it);
+        }
+
+        EntityNameIndexRemove(entity->GetName(), entity->GetId());
+
+        for (const auto& component : entity->GetAllComponents())
+        {
+            ComponentRemoved(component.get());
+        }
+
+        // Invalidate any handles to the entity, and make the slot available
+        EntitySlot& slot = m_entity_slots[handle.index];
+        slot.generation++;
+        m_entity_slots_free.emplace_back(handle.index);
+        entity->SetHandle(EntityHandle());
+        slot.entity = nullptr;
+    }
+
+    void World::EntityUnregisterAll()
+    {
+        for (uint32_t i = 0; i < static_cast<uint32_t>(m_entity_slots.size()); i++)
+        {
+            EntitySlot& slot = m_entity_slots[i];
+            if (!slot.entity)
+                continue;
+
+            for (const auto& component : slot.entity->GetAllComponents())
+            {
+                GetComponentPool(component->GetType()).Remove(component.get());
+
+                if (component->GetType() == ComponentType::Renderable)
+                {
+                    static_cast<Renderable*>(component.get())->SetTreeProxy(AabbTree::null_node);
+                }
+            }
+
+            slot.generation++;
+            slot.entity->SetHandle(EntityHandle());
+            slot.entity = nullptr;
+            m_entity_slots_free.emplace_back(i);
+        }
+
+        m_entity_slot_by_id.clear();
+        m_entity_ids_by_name.clear();
+        m_renderables_tree.Clear();
+
+        // The renderer clears everything on unload
+        lock_guard<mutex> lock(m_mutex_changes);
+        m_entities_changed.clear();
+        m_entities_removed.clear();
+    }
+
+    void World::EntityChanged(Entity* entity)
+    {
+        entity->MakeDirty();
+
+        lock_guard<mutex> lock(m_mutex_changes);
+        m_entities_changed.emplace(entity);
     }
 
-    // Removes an entity and all of it's children
-    void World::_EntityRemove(const std::shared_ptr<Entity>& entity)
+    void World::ComponentAdded(IComponent* component)
     {
-        // Remove any descendants
-        auto children = entity->GetTransform()->GetChildren();
-        for (const auto& child : children)
+        GetComponentPool(component->GetType()).Add(component);
+
+        if (component->GetType() == ComponentType::Renderable)
         {
-            EntityRemove(child->GetEntity()->GetPtrShared());
+            Renderable* renderable = static_cast<Renderable*>(component);
+            renderable->SetTreeProxy(m_renderables_tree.Insert(GetRenderableBounds(renderable), renderable));
         }
+    }
+
+    void World::ComponentRemoved(IComponent* component)
+    {
+        GetComponentPool(component->GetType()).Remove(component);
 
-        // Keep a reference to it's parent (in case it has one)
-        auto parent = entity->GetTransform()->GetParent();
+        if (component->GetType() == ComponentType::Renderable)
+        {
+            Renderable* renderable = static_cast<Renderable*>(component);
+            if (renderable->GetTreeProxy() != AabbTree::null_node)
+            {
+                m_renderables_tree.Remove(renderable->GetTreeProxy());
+                renderable->SetTreeProxy(AabbTree::null_node);
+            }
+        }
+    }
+
+    void World::OnRenderableBoundsChanged(Renderable* renderable)
+    {
+        if (renderable->GetTreeProxy() != AabbTree::null_node)
+        {
+            m_renderables_tree.Update(renderable->GetTreeProxy(), GetRenderableBounds(renderable));
+        }
+    }
+
+    void World::OnRenderableMaterialChanged(Renderable* renderable)
+    {
+        Entity* entity = renderable->GetEntity();
+        if (entity && entity->GetHandle().IsValid())
+        {
+            EntityChanged(entity);
+        }
+    }
+
+    void World::OnMaterialTransparencyChanged(const Material* material)
+    {
+        View<Renderable>().Each([this, material](Renderable* renderable)
+        {
+            if (renderable->GetMaterial() == material)
+            {
+                OnRenderableMaterialChanged(renderable);
+            }
+        });
+    }
+
+    void World::OnEntityIdChanged(Entity* entity, const uint32_t id_previous)
+    {
+        const uint32_t index = entity->GetHandle().index;
+
+        const auto it = m_entity_slot_by_id.find(id_previous);
+        if (it != m_entity_slot_by_id.end() && it->second == index)
+        {
+            m_entity_slot_by_id.erase(it);
+        }
+        m_entity_slot_by_id[entity->GetId()] = index;
+
+        EntityNameIndexRemove(entity->GetName(), id_previous);
+        m_entity_ids_by_name[entity->GetName()].emplace_back(entity->GetId());
+    }
+
+    void World::OnEntityRenamed(Entity* entity, const string& name_previous)
+    {
+        EntityNameIndexRemove(name_previous, entity->GetId());
+        m_entity_ids_by_name[entity->GetName()].emplace_back(entity->GetId());
+    }
+
+    void World::EntityNameIndexRemove(const string& name, const uint32_t id)
+    {
+        const auto it = m_entity_ids_by_name.find(name);
+        if (it == m_entity_ids_by_name.end())
+            return;
 
-        // Remove this entity
-        for (auto it = m_entities.begin(); it < m_entities.end();)
+        vector<uint32_t>& ids = it->second;
+        for (auto it_id = ids.begin(); it_id != ids.end(); it_id++)
         {
-            const auto temp = *it;
-            if (temp->GetId() == entity->GetId())
+            if (*it_id == id)
             {
-                it = m_entities.erase(it);
+                ids.erase(it_id);
                 break;
             }
-            ++it;
         }
 
-        // If there was a parent, update it
-        if (parent)
+        if (ids.empty())
         {
-            parent->AcquireChildren();
+            m_entity_ids_by_name.erase(it);
         }
     }
 
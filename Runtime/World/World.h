@@ -25,16 +25,101 @@ CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
 #include <vector>
 #include <memory>
 #include <string>
+#include <array>
+#include <unordered_map>
+#include <unordered_set>
+#include <mutex>
+#include <atomic>
+#include "Entity.h"
+#include "ComponentPool.h"
+#include "../Math/Matrix.h"
+#include "../Math/AabbTree.h"
 #include "../Core/ISubsystem.h"
+#include "../Core/EventSystem.h"
 #include "../Core/Spartan_Definitions.h"
+#include "../Threading/Threading.h"
+#include "../Threading/Async.h"
 //======================================
 
 namespace Spartan
 {
     class Entity;
+    class IResource;
     class Light;
+    class Material;
+    class Renderable;
     class Input;
     class Profiler;
+    class Threading;
+    class Transform;
+    class WorldPartition;
+
+    // Iterates the components of type T whose entities also have all the Others components, e.g.
+    // world->View<Renderable, Light>().Each([](Renderable* renderable, Light* light) { ... });
+    template <class T, class... Others>
+    class ComponentView
+    {
+    public:
+        ComponentView(const ComponentPool& pool) : m_pool(pool) {}
+
+        template <typename Function>
+        void Each(Function&& function) const
+        {
+            for (IComponent* component : m_pool.GetAll())
+            {
+                if constexpr (sizeof...(Others) == 0)
+                {
+                    function(static_cast<T*>(component));
+                }
+                else
+                {
+                    Entity* entity = component->GetEntity();
+                    if ((entity->HasComponent<Others>() && ...))
+                    {
+                        function(static_cast<T*>(component), entity->GetComponent<Others>()...);
+                    }
+                }
+            }
+        }
+
+        // An upper bound, as the Others components aren't taken into account
+        uint32_t GetCount() const { return m_pool.GetCount(); }
+
+    private:
+        const ComponentPool& m_pool;
+    };
+
+    // The payload of EventType::WorldResolved, what changed since the last time the world resolved
+    struct WorldResolveDelta
+    {
+        bool full = false;              // everything has to be re-acquired (e.g. after loading), the lists below are empty
+        std::vector<Entity*> changed;   // added, or their components or active state changed
+        std::vector<Entity*> removed;   // already destroyed, so they can only be compared, never dereferenced
+    };
+
+    // What a save writes, it's taken between two ticks and it's immutable, so the file can be written on another thread
+    struct WorldSnapshot
+    {
+        struct Root
+        {
+            uint32_t id             = 0;
+            uint32_t component_mask = 0; // the component types of the root and it's descendants
+            std::shared_ptr<const std::string> data;
+        };
+
+        // Written along with the world, subsystems add them when the world is saved (e.g. the resources)
+        struct File
+        {
+            std::string file_path;
+            std::string data;
+            std::shared_ptr<IResource> resource; // if it's a resource, the revision in data is saved once the file is written
+            uint32_t resource_revision = 0;
+        };
+
+        std::string file_path;
+        std::vector<Root> roots;
+        std::vector<File> files;
+    };
 
     enum class WorldState
     {
@@ -56,10 +141,17 @@ namespace Spartan
         //===================================
         
         void Unload();
+        // The world is saved in the background, false means that the save couldn't be requested.
+        // Whether the file was written is the data of EventType::WorldSaved.
         bool SaveToFile(const std::string& filePath);
+        // Saves the world and moves it's roots into cells next to the file, they are streamed from then on (see WorldPartition)
+        bool SaveToFilePartitioned(const std::string& file_path, float cell_size);
+        // Blocks until the world is loaded, LoadFromFileAsync() loads it in the background
         bool LoadFromFile(const std::string& file_path);
+        Async<bool> LoadFromFileAsync(std::string file_path);
         const auto& GetName() const { return m_name; }
         void MakeDirty() { m_is_dirty = true; }
+        WorldPartition* GetPartition() const { return m_partition.get(); }
 
         //= Entities ===========================================================================
         std::shared_ptr<Entity>& EntityCreate(bool is_active = true);
@@ -69,12 +161,65 @@ namespace Spartan
         std::vector<std::shared_ptr<Entity>> EntityGetRoots();
         const std::shared_ptr<Entity>& EntityGetByName(const std::string& name);
         const std::shared_ptr<Entity>& EntityGetById(uint32_t id);
+        const std::shared_ptr<Entity>& EntityGetByHandle(const EntityHandle& handle); // empty if the handle is stale
         const auto& EntityGetAll() const    { return m_entities; }
+        std::vector<std::shared_ptr<Entity>> Instantiate(Entity* prefab, uint32_t count, const Math::Matrix* transforms = nullptr);
         auto EntityGetCount() const         { return static_cast<uint32_t>(m_entities.size()); }
         //======================================================================================
 
+        //= Components =============================================================================================================
+        template <class T, class... Others>
+        ComponentView<T, Others...> View() const                                { return ComponentView<T, Others...>(GetComponentPool(IComponent::TypeToEnum<T>())); }
+        ComponentPool& GetComponentPool(const ComponentType type)               { return m_component_pools[static_cast<uint32_t>(type)]; }
+        const ComponentPool& GetComponentPool(const ComponentType type) const   { return m_component_pools[static_cast<uint32_t>(type)]; }
+        //===========================================================================================================================
+
+        //= Spatial queries ========================================================================================================
+        // Call function(Renderable*) for every registered renderable whose bounds overlap the shape, active or not
+        template <typename Function>
+        void QueryRenderables(const Math::BoundingBox& box, Function&& function) const                                      { m_renderables_tree.Query(box, RenderableCallback(function)); }
+        template <typename Function>
+        void QueryRenderables(const Math::Vector3& center, const float radius, Function&& function) const                   { m_renderables_tree.Query(center, radius, RenderableCallback(function)); }
+        template <typename Function>
+        void QueryRenderables(const Math::Frustum& frustum, const bool ignore_near_plane, Function&& function) const        { m_renderables_tree.Query(frustum, ignore_near_plane, RenderableCallback(function)); }
+        template <typename Function>
+        void QueryRenderables(const Math::Ray& ray, Function&& function) const                                              { m_renderables_tree.Query(ray, RenderableCallback(function)); }
+        const Math::AabbTree& GetRenderablesTree() const { return m_renderables_tree; }
+
+        // Called when the geometry of a renderable changes, moving transforms are picked up by the world
+        void OnRenderableBoundsChanged(Renderable* renderable);
+        // Called when a renderable's material changes, or when a material switches between opaque and transparent,
+        // so that the renderer moves the renderables to the right list
+        void OnRenderableMaterialChanged(Renderable* renderable);
+        void OnMaterialTransparencyChanged(const Material* material);
+        //===========================================================================================================================
+
+        // Called when a transform is added, removed or re-parented
+        void TransformHierarchyChanged() { m_transforms_ordered_dirty = true; }
+
     private:
-        void _EntityRemove(const std::shared_ptr<Entity>& entity);
+        void TickPhases(float delta_time);
+        void TickComponents(ComponentType type, bool chunked, float delta_time);
+        void EntitiesDestroyPending();
+        void TransformsUpdate();
+        void SaveSnapshot();
+        bool SaveSnapshotToFile(const WorldSnapshot& snapshot);
+
+        //= ENTITY LOOKUP ============================================================
+        friend class Entity;
+        void EntityRegister(const std::shared_ptr<Entity>& entity);
+        void EntityUnregister(Entity* entity);
+        void EntityUnregisterAll();
+        void OnEntityIdChanged(Entity* entity, uint32_t id_previous);
+        void OnEntityRenamed(Entity* entity, const std::string& name_previous);
+        void EntityNameIndexRemove(const std::string& name, uint32_t id);
+        void EntityChanged(Entity* entity);
+        void ComponentAdded(IComponent* component);
+        void ComponentRemoved(IComponent* component);
+        //============================================================================
+
+        template <typename Function>
+        static auto RenderableCallback(Function& function) { return [&function](void* user_data) { function(static_cast<Renderable*>(user_data)); }; }
 
         //= COMMON ENTITY CREATION ========================
         std::shared_ptr<Entity>& CreateEnvironment();
@@ -85,10 +230,57 @@ namespace Spartan
         std::string m_name;
         bool m_was_in_editor_mode   = false;
         bool m_is_dirty             = true;
+        bool m_destruction_pending  = false;
         WorldState m_state          = WorldState::Ticking;
         Input* m_input              = nullptr;
         Profiler* m_profiler        = nullptr;
+        Threading* m_threading      = nullptr;
+        std::unique_ptr<WorldPartition> m_partition;
+
+        // Events
+        EventHandle m_event_world_resolve;
+        EventHandle m_event_world_stop;
+        EventHandle m_event_world_start;
 
         std::vector<std::shared_ptr<Entity>> m_entities;
+
+        // Entity lookup, a slot is re-used with a new generation once it's entity is removed
+        struct EntitySlot
+        {
+            std::shared_ptr<Entity> entity;
+            uint32_t generation = 0;
+        };
+        std::vector<EntitySlot> m_entity_slots;
+        std::vector<uint32_t> m_entity_slots_free;
+        std::unordered_map<uint32_t, uint32_t> m_entity_slot_by_id;
+        std::unordered_map<std::string, std::vector<uint32_t>> m_entity_ids_by_name;
+
+        // Changes since the last resolve, entities can change from any thread (e.g. while loading)
+        std::unordered_set<Entity*> m_entities_changed;
+        std::vector<Entity*> m_entities_removed;
+        std::mutex m_mutex_changes;
+
+        // All the transforms, parents before children, rebuilt when the hierarchy changes
+        std::vector<Transform*> m_transforms_ordered;
+        std::atomic<bool> m_transforms_ordered_dirty = true;
+
+        // Scratch space for the per frame transform update, kept around so that it doesn't allocate every frame
+        std::vector<Transform*> m_transforms_dirty;
+        std::vector<Math::Vector3> m_transforms_positions;
+        std::vector<Math::Quaternion> m_transforms_rotations;
+        std::vector<Math::Vector3> m_transforms_scales;
+        std::vector<Math::Matrix> m_transforms_matrices;
+
+        std::array<ComponentPool, static_cast<uint32_t>(ComponentType::Unknown)> m_component_pools;
+
+        // The bounds of all the registered renderables, for culling and picking
+        Math::AabbTree m_renderables_tree;
+
+        // Saving, roots that haven't changed since the last save re-use what it serialized
+        std::string m_save_file_path;
+        float m_save_cell_size = 0.0f; // partitions the world before saving it, if it's not zero
+        std::unordered_map<uint32_t, WorldSnapshot::Root> m_roots_saved;
+        TaskHandle m_save_task;
+        std::mutex m_mutex_save;
     };
 }
@@ -0,0 +1,174 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ==========================
+#include "Spartan.h"
+#include "WorldFile.h"
+#include "Entity.h"
+#include "Components/Transform.h"
+#include "../IO/FileStream.h"
+#include "../Resource/ProgressReport.h"
+//=====================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Spartan
+{
+    namespace WorldFile
+    {
+        uint32_t GetComponentMask(const Entity* entity)
+        {
+            uint32_t mask = 0;
+            for (const auto& component : entity->GetAllComponents())
+            {
+                mask |= 1u << static_cast<uint32_t>(component->GetType());
+            }
+
+            return mask;
+        }
+
+        WorldSnapshot::Root SerializeRoot(Entity* root)
+        {
+            FileStream stream("", FileStream_Memory);
+            root->Serialize(&stream);
+
+            WorldSnapshot::Root saved;
+            saved.id                = root->GetId();
+            saved.data              = make_shared<const string>(stream.GetMemory());
+            saved.component_mask    = GetComponentMask(root);
+            root->ClearDirty();
+
+            vector<Transform*> descendants;
+            root->GetTransform()->GetDescendants(&descendants);
+            for (Transform* descendant : descendants)
+            {
+                saved.component_mask |= GetComponentMask(descendant->GetEntity());
+                descendant->GetEntity()->ClearDirty();
+            }
+
+            return saved;
+        }
+
+        bool Write(const WorldSnapshot& snapshot, const bool report_progress)
+        {
+            const auto root_count = static_cast<uint32_t>(snapshot.roots.size());
+
+            // The chunks follow the header and the contents
+            vector<Chunk> chunks(root_count);
+            uint64_t offset = header_size + contents_entry_size * root_count;
+            for (uint32_t i = 0; i < root_count; i++)
+            {
+                const WorldSnapshot::Root& root = snapshot.roots[i];
+
+                chunks[i].id                = root.id;
+                chunks[i].offset            = offset;
+                chunks[i].size              = root.data->size();
+                chunks[i].component_mask    = root.component_mask;
+                offset                      += chunks[i].size;
+            }
+
+            const string file_path_temp = snapshot.file_path + ".tmp";
+            {
+                FileStream file(file_path_temp, FileStream_Write);
+                if (!file.IsOpen())
+                    return false;
+
+                // Header
+                file.Write(magic);
+                file.Write(version);
+                file.Write(root_count);
+
+                // Contents
+                for (const Chunk& chunk : chunks)
+                {
+                    file.Write(chunk.id);
+                    file.Write(chunk.offset);
+                    file.Write(chunk.size);
+                    file.Write(chunk.component_mask);
+                }
+
+                // Chunks
+                for (const WorldSnapshot::Root& root : snapshot.roots)
+                {
+                    file.WriteRaw(root.data->data(), root.data->size());
+
+                    if (report_progress)
+                    {
+                        ProgressReport::Get().IncrementJobsDone(g_progress_world);
+                    }
+                }
+            }
+
+            if (!FileSystem::Rename(file_path_temp, snapshot.file_path))
+            {
+                LOG_ERROR("Failed to replace %s", snapshot.file_path.c_str());
+                return false;
+            }
+
+            return true;
+        }
+
+        bool ReadHeader(FileStream* file, uint32_t* version, uint32_t* root_count)
+        {
+            *root_count = file->ReadAs<uint32_t>();
+            if (*root_count != magic)
+            {
+                *version = 0;
+                return false;
+            }
+
+            *version    = file->ReadAs<uint32_t>();
+            *root_count = file->ReadAs<uint32_t>();
+            return true;
+        }
+
+        void ReadContents(FileStream* file, vector<Chunk>& chunks)
+        {
+            for (Chunk& chunk : chunks)
+            {
+                file->Read(&chunk.id);
+                file->Read(&chunk.offset);
+                file->Read(&chunk.size);
+                file->Read(&chunk.component_mask);
+            }
+        }
+
+        void ReadRoot(Context* context, FileStream* stream, const uint32_t id, vector<shared_ptr<Entity>>* entities)
+        {
+            Entity* root = entities->emplace_back(make_shared<Entity>(context)).get();
+            root->SetId(id);
+            root->Deserialize(stream, nullptr, entities);
+        }
+
+        void ReadRootFinish(const vector<shared_ptr<Entity>>& entities)
+        {
+            for (const shared_ptr<Entity>& entity : entities)
+            {
+                for (const auto& component : entity->GetAllComponents())
+                {
+                    component->OnDeserialized();
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,87 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES =====
+#include <vector>
+#include <memory>
+#include <string>
+#include "World.h"
+//================
+
+namespace Spartan
+{
+    class Entity;
+    class Context;
+    class FileStream;
+
+    // World file layout:
+    // header:      magic, version, root count
+    // contents:    for every root, it's id, the byte offset and size of it's chunk and the component types in it
+    // chunks:      every root and it's descendants, as written by Entity::Serialize()
+    // Older files start with the root count (no magic) followed by the root ids and the roots, they are loaded sequentially.
+    // The world partition writes it's cells in the same layout.
+    namespace WorldFile
+    {
+        constexpr uint32_t magic                = 0x44575053; // "SPWD"
+        constexpr uint32_t version              = 1;
+        constexpr uint64_t header_size          = sizeof(uint32_t) * 3;
+        constexpr uint64_t contents_entry_size  = sizeof(uint32_t) * 2 + sizeof(uint64_t) * 2;
+
+        struct Chunk
+        {
+            uint32_t id             = 0;
+            uint64_t offset         = 0;
+            uint64_t size           = 0;
+            uint32_t component_mask = 0;
+        };
+
+        // Component types which only touch their own entity and thread safe subsystems (like the resource cache) when they
+        // are deserialized. Chunks with anything else (physics, audio, scripts, etc) have to be loaded on the main thread.
+        // Lights are loaded on the main thread too, they create their shadow maps and mark the world dirty.
+        constexpr uint32_t components_parallel_load =
+            (1u << static_cast<uint32_t>(ComponentType::Transform))     |
+            (1u << static_cast<uint32_t>(ComponentType::Renderable))    |
+            (1u << static_cast<uint32_t>(ComponentType::Camera));
+
+        inline bool IsParallelLoadable(const Chunk& chunk) { return (chunk.component_mask & ~components_parallel_load) == 0; }
+
+        // The component types of an entity, as a mask of 1 << ComponentType
+        uint32_t GetComponentMask(const Entity* entity);
+
+        // Serializes a root and it's descendants into memory, they are no longer dirty afterwards
+        WorldSnapshot::Root SerializeRoot(Entity* root);
+
+        // Writes to a temporary file and swaps it in, so that the file is never left partially written
+        bool Write(const WorldSnapshot& snapshot, bool report_progress);
+
+        // Returns false for older files, in which case only the root count is read
+        bool ReadHeader(FileStream* file, uint32_t* version, uint32_t* root_count);
+        void ReadContents(FileStream* file, std::vector<Chunk>& chunks);
+
+        // Reads a root and it's descendants without adding them to the world, so it can run on any thread (see IsParallelLoadable())
+        void ReadRoot(Context* context, FileStream* stream, uint32_t id, std::vector<std::shared_ptr<Entity>>* entities);
+
+        // Does what ReadRoot() deferred (see IComponent::OnDeserialized()), on the main thread and before the entities are added to the world
+        void ReadRootFinish(const std::vector<std::shared_ptr<Entity>>& entities);
+    }
+}
@@ -0,0 +1,584 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ========================
+#include "Spartan.h"
+#include "WorldPartition.h"
+#include "WorldFile.h"
+#include "Entity.h"
+#include "Components/Transform.h"
+#include "Components/Camera.h"
+#include "Components/Light.h"
+#include "Components/Environment.h"
+#include "Components/AudioListener.h"
+#include "../IO/FileStream.h"
+#include "../Rendering/Renderer.h"
+#include "../Threading/Threading.h"
+//===================================
+
+//= NAMESPACES ================
+using namespace std;
+using namespace Spartan::Math;
+//=============================
+
+namespace Spartan
+{
+    namespace
+    {
+        // Index layout: magic, version, cell size, cell count, and for every cell it's coordinates and it's size in bytes
+        constexpr uint32_t index_magic      = 0x50575053; // "SPWP"
+        constexpr uint32_t index_version    = 1;
+        const char* index_file_name         = "cells.index";
+
+        // Roots which are needed no matter where the camera is
+        bool IsResident(Entity* root)
+        {
+            vector<Transform*> transforms = { root->GetTransform() };
+            root->GetTransform()->GetDescendants(&transforms);
+
+            for (Transform* transform : transforms)
+            {
+                Entity* entity = transform->GetEntity();
+                if (entity->HasComponent<Camera>() || entity->HasComponent<Environment>() || entity->HasComponent<AudioListener>())
+                    return true;
+
+                Light* light = entity->GetComponent<Light>();
+                if (light && light->GetLightType() == LightType::Directional)
+                    return true;
+            }
+
+            return false;
+        }
+
+        bool IsDirty(Entity* root)
+        {
+            if (root->IsDirty())
+                return true;
+
+            vector<Transform*> descendants;
+            root->GetTransform()->GetDescendants(&descendants);
+            for (Transform* descendant : descendants)
+            {
+                if (descendant->GetEntity()->IsDirty())
+                    return true;
+            }
+
+            return false;
+        }
+
+        uint64_t GetFileSize(const WorldSnapshot& snapshot)
+        {
+            uint64_t size = WorldFile::header_size + WorldFile::contents_entry_size * snapshot.roots.size();
+            for (const WorldSnapshot::Root& root : snapshot.roots)
+            {
+                size += root.data->size();
+            }
+
+            return size;
+        }
+    }
+
+    struct WorldPartition::CellLoad
+    {
+        Context* context = nullptr;
+        string file_path;
+        vector<WorldFile::Chunk> chunks;
+        vector<vector<shared_ptr<Entity>>> roots;  // one per chunk, the chunks which have to be read on the main thread are empty
+        unique_ptr<FileStream> stream;              // the file, in memory
+        bool succeeded = false;
+    };
+
+    WorldPartition::WorldPartition(Context* context, World* world)
+    {
+        m_context   = context;
+        m_world     = world;
+        m_renderer  = context->GetSubsystem<Renderer>();
+        m_threading = context->GetSubsystem<Threading>();
+    }
+
+    WorldPartition::~WorldPartition()
+    {
+        WaitForTasks();
+    }
+
+    bool WorldPartition::Build(const string& world_file_path, const float cell_size)
+    {
+        if (IsEnabled())
+        {
+            LOG_ERROR("The world is already partitioned.");
+            return false;
+        }
+
+        if (cell_size <= 0.0f)
+        {
+            LOG_ERROR_INVALID_PARAMETER();
+            return false;
+        }
+
+        const string directory = GetDirectory(world_file_path);
+        if (!FileSystem::Exists(directory) && !FileSystem::CreateDirectory_(directory))
+        {
+            LOG_ERROR("Failed to create %s", directory.c_str());
+            return false;
+        }
+
+        const Stopwatch timer;
+        m_directory = directory;
+        m_cell_size = cell_size;
+
+        // Group the roots by the cell they are in
+        vector<vector<shared_ptr<Entity>>> cell_roots;
+        unordered_map<uint64_t, uint32_t> cell_indices;
+        uint32_t root_count = 0;
+        for (const shared_ptr<Entity>& root : m_world->EntityGetRoots())
+        {
+            if (root->IsPendingDestruction() || IsResident(root.get()))
+                continue;
+
+            const Vector3 position  = root->GetTransform()->GetPosition();
+            const int32_t x         = static_cast<int32_t>(floor(position.x / cell_size));
+            const int32_t z         = static_cast<int32_t>(floor(position.z / cell_size));
+            const uint64_t key      = (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(z);
+
+            const auto it = cell_indices.emplace(key, static_cast<uint32_t>(m_cells.size())).first;
+            if (it->second == m_cells.size())
+            {
+                Cell& cell  = m_cells.emplace_back();
+                cell.x      = x;
+                cell.z      = z;
+                cell_roots.emplace_back();
+            }
+
+            cell_roots[it->second].emplace_back(root);
+            root_count++;
+        }
+
+        // Write the cells, nothing is removed from the world unless all of them are written
+        for (uint32_t i = 0; i < static_cast<uint32_t>(m_cells.size()); i++)
+        {
+            WorldSnapshot snapshot;
+            snapshot.file_path = GetCellFilePath(m_cells[i]);
+            for (const shared_ptr<Entity>& root : cell_roots[i])
+            {
+                snapshot.roots.emplace_back(WorldFile::SerializeRoot(root.get()));
+            }
+
+            if (!WorldFile::Write(snapshot, false))
+            {
+                LOG_ERROR("Failed to write %s", snapshot.file_path.c_str());
+                m_cells.clear();
+                return false;
+            }
+
+            m_cells[i].size = GetFileSize(snapshot);
+        }
+
+        if (!WriteIndex())
+        {
+            m_cells.clear();
+            return false;
+        }
+
+        // The cells near the camera will be streamed back in
+        for (const vector<shared_ptr<Entity>>& roots : cell_roots)
+        {
+            for (const shared_ptr<Entity>& root : roots)
+            {
+                m_world->EntityRemove(root);
+            }
+        }
+
+        LOG_INFO("Partitioned %d roots into %d cells in %.2f ms", root_count, static_cast<uint32_t>(m_cells.size()), timer.GetElapsedTimeMs());
+
+        return true;
+    }
+
+    bool WorldPartition::Open(const string& directory)
+    {
+        Close();
+
+        const string file_path = directory + index_file_name;
+        if (!FileSystem::Exists(file_path))
+            return false;
+
+        FileStream file(file_path, FileStream_Read);
+        if (!file.IsOpen())
+            return false;
+
+        if (file.ReadAs<uint32_t>() != index_magic)
+        {
+            LOG_ERROR("%s is not a world partition index.", file_path.c_str());
+            return false;
+        }
+
+        const uint32_t version = file.ReadAs<uint32_t>();
+        if (version > index_version)
+        {
+            LOG_ERROR("%s is of version %d, the latest supported version is %d.", file_path.c_str(), version, index_version);
+            return false;
+        }
+
+        file.Read(&m_cell_size);
+        m_cells.resize(file.ReadAs<uint32_t>());
+        for (Cell& cell : m_cells)
+        {
+            file.Read(&cell.x);
+            file.Read(&cell.z);
+            file.Read(&cell.size);
+        }
+        m_directory = directory;
+
+        LOG_INFO("Streaming %d cells from %s", static_cast<uint32_t>(m_cells.size()), directory.c_str());
+
+        return true;
+    }
+
+    void WorldPartition::Close()
+    {
+        WaitForTasks();
+
+        m_cells.clear();
+        m_roots_streamed.clear();
+        m_directory.clear();
+    }
+
+    void WorldPartition::Save(const string& world_file_path)
+    {
+        if (!IsEnabled())
+            return;
+
+        // Saving the world somewhere else, the cells go along
+        const string directory = GetDirectory(world_file_path);
+        if (directory != m_directory)
+        {
+            WaitForTasks();
+
+            if (!FileSystem::Exists(directory))
+            {
+                FileSystem::CreateDirectory_(directory);
+            }
+
+            for (const Cell& cell : m_cells)
+            {
+                const string file_path = GetCellFilePath(cell);
+                FileSystem::CopyFileFromTo(file_path, directory + FileSystem::GetFileNameFromFilePath(file_path));
+            }
+
+            m_directory = directory;
+        }
+
+        for (Cell& cell : m_cells)
+        {
+            if (cell.state == CellState::Loaded && IsCellDirty(cell))
+            {
+                CellSave(cell);
+            }
+        }
+
+        WriteIndex();
+    }
+
+    void WorldPartition::Tick()
+    {
+        if (!IsEnabled())
+            return;
+
+        const shared_ptr<Camera>& camera = m_renderer->GetCamera();
+        if (!camera)
+            return;
+
+        const Vector3 position      = camera->GetTransform()->GetPosition();
+        const float unload_radius   = m_load_radius + m_hysteresis;
+        const bool save             = !m_context->m_engine->EngineMode_IsSet(Engine_Game); // changes made while playing are discarded
+
+        vector<pair<float, Cell*>> cells_to_load;
+        for (Cell& cell : m_cells)
+        {
+            const float distance = GetDistance(cell, position);
+
+            if (cell.state == CellState::Loading && cell.task.IsDone())
+            {
+                // Out of range by the time it was read, it's entities were never added to the world so they can just be dropped
+                if (distance > unload_radius)
+                {
+                    cell.load   = nullptr;
+                    cell.state  = CellState::Unloaded;
+                }
+                else
+                {
+                    CellLoadFinish(cell);
+                }
+            }
+
+            if (cell.state == CellState::Loaded && distance > unload_radius)
+            {
+                CellUnload(cell, save);
+            }
+            else if (cell.state == CellState::Unloaded && distance <= m_load_radius && cell.task.IsDone())
+            {
+                cells_to_load.emplace_back(distance, &cell);
+            }
+        }
+
+        // Nearest first, for as long as the budget allows
+        sort(cells_to_load.begin(), cells_to_load.end(), [](const pair<float, Cell*>& a, const pair<float, Cell*>& b) { return a.first < b.first; });
+        uint64_t bytes = 0;
+        for (const pair<float, Cell*>& cell : cells_to_load)
+        {
+            if (bytes != 0 && bytes + cell.second->size > m_io_budget)
+                break;
+
+            CellLoadStart(*cell.second);
+            bytes += cell.second->size;
+        }
+    }
+
+    string WorldPartition::GetDirectory(const string& world_file_path)
+    {
+        return FileSystem::GetFilePathWithoutExtension(world_file_path) + "_cells/";
+    }
+
+    void WorldPartition::CellRead(CellLoad& load)
+    {
+        FileStream file(load.file_path, FileStream_Read);
+        if (!file.IsOpen())
+            return;
+
+        uint32_t version    = 0;
+        uint32_t root_count = 0;
+        if (!WorldFile::ReadHeader(&file, &version, &root_count) || version > WorldFile::version)
+        {
+            LOG_ERROR("%s is not a supported cell.", load.file_path.c_str());
+            return;
+        }
+
+        load.chunks.resize(root_count);
+        load.roots.resize(root_count);
+        WorldFile::ReadContents(&file, load.chunks);
+
+        // Read the whole file with a single request
+        const uint64_t size = load.chunks.empty() ? file.GetPosition() : load.chunks.back().offset + load.chunks.back().size;
+        string data(size, '\0');
+        file.SetPosition(0);
+        file.ReadRaw(data.data(), size);
+        file.Close();
+
+        load.stream = make_unique<FileStream>("", FileStream_Memory | FileStream_Read);
+        load.stream->SetMemory(move(data));
+
+        // The entities aren't in the world yet, so nothing else is touching them. Chunks with lights are left for the main thread, they
+        // create GPU resources (see WorldFile::components_parallel_load), and so is the rest of the loading (see IComponent::OnDeserialized()).
+        for (uint32_t i = 0; i < root_count; i++)
+        {
+            const WorldFile::Chunk& chunk = load.chunks[i];
+            if (!WorldFile::IsParallelLoadable(chunk))
+                continue;
+
+            load.stream->SetPosition(chunk.offset);
+            WorldFile::ReadRoot(load.context, load.stream.get(), chunk.id, &load.roots[i]);
+
+            if (load.stream->GetPosition() != chunk.offset + chunk.size)
+            {
+                LOG_ERROR("%s: the chunk of entity %d has an unexpected size.", load.file_path.c_str(), chunk.id);
+            }
+        }
+
+        load.succeeded = true;
+    }
+
+    float WorldPartition::GetDistance(const Cell& cell, const Vector3& position) const
+    {
+        // To the closest point of the cell, on the xz plane
+        const float min_x   = cell.x * m_cell_size;
+        const float min_z   = cell.z * m_cell_size;
+        const float dx      = Helper::Max(Helper::Max(min_x - position.x, position.x - (min_x + m_cell_size)), 0.0f);
+        const float dz      = Helper::Max(Helper::Max(min_z - position.z, position.z - (min_z + m_cell_size)), 0.0f);
+
+        return Helper::Sqrt(dx * dx + dz * dz);
+    }
+
+    string WorldPartition::GetCellFilePath(const Cell& cell) const
+    {
+        return m_directory + "cell_" + to_string(cell.x) + "_" + to_string(cell.z) + EXTENSION_WORLD;
+    }
+
+    void WorldPartition::CellLoadStart(Cell& cell)
+    {
+        auto load       = make_shared<CellLoad>();
+        load->context   = m_context;
+        load->file_path = GetCellFilePath(cell);
+
+        cell.load   = load;
+        cell.state  = CellState::Loading;
+        cell.task   = m_threading->AddTaskIo([load]() { CellRead(*load); }, TaskPriority::Background);
+    }
+
+    void WorldPartition::CellLoadFinish(Cell& cell)
+    {
+        const shared_ptr<CellLoad> load = move(cell.load);
+        if (!load->succeeded)
+        {
+            LOG_ERROR("Failed to load %s, it won't be streamed.", load->file_path.c_str());
+            cell.state = CellState::Failed;
+            return;
+        }
+
+        // Chunks with components that register with subsystems which aren't thread safe (physics, audio, etc), or
+        // that create GPU resources (lights and their shadow maps), they are read now that the cell is committed
+        for (uint32_t i = 0; i < static_cast<uint32_t>(load->chunks.size()); i++)
+        {
+            const WorldFile::Chunk& chunk = load->chunks[i];
+            if (WorldFile::IsParallelLoadable(chunk))
+                continue;
+
+            load->stream->SetPosition(chunk.offset);
+            WorldFile::ReadRoot(m_context, load->stream.get(), chunk.id, &load->roots[i]);
+        }
+
+        // Add them to the world, they match the file so they aren't dirty
+        for (const vector<shared_ptr<Entity>>& entities : load->roots)
+        {
+            if (entities.empty())
+                continue;
+
+            WorldFile::ReadRootFinish(entities);
+            for (const shared_ptr<Entity>& entity : entities)
+            {
+                m_world->EntityAdd(entity);
+                entity->ClearDirty();
+            }
+
+            cell.roots.emplace_back(entities.front()->GetId());
+            m_roots_streamed.emplace(entities.front()->GetId());
+        }
+
+        // The entities were created before they were in the world, so the hierarchy could have been flattened without them
+        m_world->TransformHierarchyChanged();
+
+        cell.state = CellState::Loaded;
+    }
+
+    void WorldPartition::CellUnload(Cell& cell, const bool save)
+    {
+        if (save && IsCellDirty(cell))
+        {
+            CellSave(cell);
+        }
+
+        for (const uint32_t id : cell.roots)
+        {
+            // Roots which were re-parented belong to another hierarchy now
+            const shared_ptr<Entity>& root = m_world->EntityGetById(id);
+            if (root && root->GetTransform()->IsRoot())
+            {
+                m_world->EntityRemove(root);
+            }
+
+            m_roots_streamed.erase(id);
+        }
+
+        cell.roots.clear();
+        cell.state = CellState::Unloaded;
+    }
+
+    void WorldPartition::CellSave(Cell& cell)
+    {
+        auto snapshot       = make_shared<WorldSnapshot>();
+        snapshot->file_path = GetCellFilePath(cell);
+
+        // Roots which were removed or re-parented are no longer part of the cell
+        vector<uint32_t> roots;
+        for (const uint32_t id : cell.roots)
+        {
+            const shared_ptr<Entity>& root = m_world->EntityGetById(id);
+            if (!root || root->IsPendingDestruction() || !root->GetTransform()->IsRoot())
+            {
+                m_roots_streamed.erase(id);
+                continue;
+            }
+
+            snapshot->roots.emplace_back(WorldFile::SerializeRoot(root.get()));
+            roots.emplace_back(id);
+        }
+        cell.roots.swap(roots);
+        cell.size = GetFileSize(*snapshot);
+
+        // One write at a time, and the cell can't be read again before it's written
+        m_threading->Wait(cell.task);
+        cell.task = m_threading->AddTaskIo([snapshot]()
+        {
+            if (!WorldFile::Write(*snapshot, false))
+            {
+                LOG_ERROR("Failed to write %s", snapshot->file_path.c_str());
+            }
+        });
+    }
+
+    bool WorldPartition::IsCellDirty(const Cell& cell)
+    {
+        for (const uint32_t id : cell.roots)
+        {
+            const shared_ptr<Entity>& root = m_world->EntityGetById(id);
+            if (!root || root->IsPendingDestruction() || !root->GetTransform()->IsRoot() || IsDirty(root.get()))
+                return true;
+        }
+
+        return false;
+    }
+
+    bool WorldPartition::WriteIndex()
+    {
+        const string file_path      = m_directory + index_file_name;
+        const string file_path_temp = file_path + ".tmp";
+        {
+            FileStream file(file_path_temp, FileStream_Write);
+            if (!file.IsOpen())
+                return false;
+
+            file.Write(index_magic);
+            file.Write(index_version);
+            file.Write(m_cell_size);
+            file.Write(static_cast<uint32_t>(m_cells.size()));
+            for (const Cell& cell : m_cells)
+            {
+                file.Write(cell.x);
+                file.Write(cell.z);
+                file.Write(cell.size);
+            }
+        }
+
+        if (!FileSystem::Rename(file_path_temp, file_path))
+        {
+            LOG_ERROR("Failed to replace %s", file_path.c_str());
+            return false;
+        }
+
+        return true;
+    }
+
+    void WorldPartition::WaitForTasks()
+    {
+        for (const Cell& cell : m_cells)
+        {
+            m_threading->Wait(cell.task);
+        }
+    }
+}
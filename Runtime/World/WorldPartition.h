@@ -0,0 +1,131 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+//= INCLUDES ===============
+#include <vector>
+#include <memory>
+#include <string>
+#include <unordered_set>
+#include "World.h"
+#include "../Math/Vector3.h"
+//==========================
+
+namespace Spartan
+{
+    class Context;
+    class Renderer;
+    class Threading;
+
+    // Splits the world into a grid of cells on the xz plane, each one stored in it's own file (in the world file layout).
+    // Cells are read on the I/O threads as the camera approaches them and removed as it moves away, so only the
+    // neighbourhood of the camera is resident, ticked and rendered. Roots that are needed everywhere stay in the world file.
+    class SPARTAN_CLASS WorldPartition
+    {
+    public:
+        WorldPartition(Context* context, World* world);
+        ~WorldPartition();
+
+        // Moves the roots of the world into cells, a root belongs to the cell it's position is in. The cells are written next
+        // to the world file (see GetDirectory()), the world saves it afterwards, see World::SaveToFilePartitioned().
+        // Roots with a camera, an environment, an audio listener or a directional light (anywhere in their hierarchy) are kept.
+        bool Build(const std::string& world_file_path, float cell_size);
+
+        // Starts streaming the cells in directory, false if it doesn't contain a partition
+        bool Open(const std::string& directory);
+
+        // Stops streaming and forgets about the cells, the world calls it when it unloads
+        void Close();
+
+        // Writes the loaded cells which changed, and moves the cells along if the world is saved somewhere else
+        void Save(const std::string& world_file_path);
+
+        // Called by the world before it ticks it's components, it adds the cells which finished loading and starts new ones
+        void Tick();
+
+        // Streamed roots are saved to their cells, the world file doesn't include them
+        bool IsStreamed(const Entity* root) const { return m_roots_streamed.count(root->GetId()) != 0; }
+        bool IsEnabled() const { return !m_cells.empty(); }
+
+        //= SETTINGS ===============================================================================================================
+        // Cells within the load radius (from the camera) are loaded, and they are unloaded once they are further than
+        // the load radius plus the hysteresis, so that moving along a cell boundary doesn't load and unload the same cells.
+        void SetLoadRadius(const float radius)              { m_load_radius = radius; }
+        void SetHysteresis(const float distance)            { m_hysteresis = distance; }
+        // The bytes of cells which can start loading in one frame, the nearest cell starts even if it's larger than that
+        void SetIoBudget(const uint64_t bytes_per_frame)    { m_io_budget = bytes_per_frame; }
+        auto GetLoadRadius() const                          { return m_load_radius; }
+        auto GetHysteresis() const                          { return m_hysteresis; }
+        auto GetIoBudget() const                            { return m_io_budget; }
+        auto GetCellSize() const                            { return m_cell_size; }
+        //==========================================================================================================================
+
+        // Where the cells of a world file are
+        static std::string GetDirectory(const std::string& world_file_path);
+
+    private:
+        enum class CellState
+        {
+            Unloaded,
+            Loading,
+            Loaded,
+            Failed
+        };
+
+        // What the I/O thread read, it's handed over to the main thread once the task is done
+        struct CellLoad;
+
+        struct Cell
+        {
+            int32_t x           = 0;
+            int32_t z           = 0;
+            uint64_t size       = 0; // in bytes, on disk
+            CellState state     = CellState::Unloaded;
+            TaskHandle task;         // loading or saving, one at a time
+            std::shared_ptr<CellLoad> load;
+            std::vector<uint32_t> roots; // the ids of the roots, while loaded
+        };
+
+        static void CellRead(CellLoad& load);
+        float GetDistance(const Cell& cell, const Math::Vector3& position) const;
+        std::string GetCellFilePath(const Cell& cell) const;
+        void CellLoadStart(Cell& cell);
+        void CellLoadFinish(Cell& cell);
+        void CellUnload(Cell& cell, bool save);
+        void CellSave(Cell& cell);
+        bool IsCellDirty(const Cell& cell);
+        bool WriteIndex();
+        void WaitForTasks();
+
+        std::vector<Cell> m_cells;
+        std::unordered_set<uint32_t> m_roots_streamed;
+        std::string m_directory;
+        float m_cell_size       = 64.0f;
+        float m_load_radius     = 128.0f;
+        float m_hysteresis      = 32.0f;
+        uint64_t m_io_budget    = 4 * 1024 * 1024;
+        Context* m_context      = nullptr;
+        World* m_world          = nullptr;
+        Renderer* m_renderer    = nullptr;
+        Threading* m_threading  = nullptr;
+    };
+}
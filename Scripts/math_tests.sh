@@ -0,0 +1,32 @@
+#!/bin/sh
+# Builds the math tests twice, with the scalar and with the SSE math backend, and runs both.
+# Both builds have to pass the same tolerances, so that they can't drift apart.
+# Usage: Scripts/math_tests.sh [--benchmark]    (CXX picks the compiler, default c++)
+
+set -e
+cd "$(dirname "$0")/.."
+
+CXX=${CXX:-c++}
+OUTPUT_DIR="Binaries/MathTests"
+SOURCES="Tests/Math/*.cpp
+Runtime/Math/Matrix.cpp
+Runtime/Math/Quaternion.cpp
+Runtime/Math/Vector2.cpp
+Runtime/Math/Vector3.cpp
+Runtime/Math/Vector4.cpp
+Runtime/Math/Plane.cpp
+Runtime/Math/BoundingBox.cpp
+Runtime/Math/Frustum.cpp
+Runtime/Math/Ray.cpp
+Runtime/Math/AabbTree.cpp"
+
+mkdir -p "$OUTPUT_DIR"
+
+echo "Building the scalar math tests..."
+$CXX -std=c++20 -O2 -ITests/Math $SOURCES -o "$OUTPUT_DIR/MathTests_scalar"
+echo "Building the SSE math tests..."
+$CXX -std=c++20 -O2 -ITests/Math -DSPARTAN_MATH_SIMD $SOURCES -o "$OUTPUT_DIR/MathTests_simd"
+
+"$OUTPUT_DIR/MathTests_scalar" "$@"
+echo
+"$OUTPUT_DIR/MathTests_simd" "$@"
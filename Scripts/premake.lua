@@ -20,10 +20,14 @@
 SOLUTION_NAME				= "Spartan"
 EDITOR_NAME					= "Editor"
 RUNTIME_NAME				= "Runtime"
+MATH_TESTS_NAME				= "MathTests"
+THREADING_TESTS_NAME		= "ThreadingTests"
 TARGET_NAME					= "Spartan" -- Name of executable
 DEBUG_FORMAT				= "c7"
 EDITOR_DIR					= "../" .. EDITOR_NAME
 RUNTIME_DIR					= "../" .. RUNTIME_NAME
+MATH_TESTS_DIR				= "../Tests/Math"
+THREADING_TESTS_DIR			= "../Tests/Threading"
 IGNORE_FILES				= {}
 ADDITIONAL_INCLUDES			= {}
 ADDITIONAL_LIBRARIES		= {}
@@ -34,6 +38,13 @@ TARGET_DIR_RELEASE  		= "../Binaries/Release"
 TARGET_DIR_DEBUG    		= "../Binaries/Debug"
 API_GRAPHICS				= _ARGS[1]
 
+-- Optional SSE implementation of the hot paths in Runtime/Math
+newoption
+{
+	trigger		= "math-simd",
+	description	= "Use SSE in the math library (defines SPARTAN_MATH_SIMD)"
+}
+
 -- Compute graphics api specific variables
 if API_GRAPHICS == "d3d11" then
 	API_GRAPHICS	= "API_GRAPHICS_D3D11"
@@ -67,7 +78,8 @@ end
 solution (SOLUTION_NAME)
 	location ".."
 	systemversion "latest"
-	cppdialect "C++17"
+	cppdialect "C++latest"
+	buildoptions { "/permissive" } -- C++latest implies /permissive-, which the code base doesn't build with yet
 	language "C++"
 	platforms "x64"
 	configurations { "Release", "Debug" }
@@ -79,6 +91,10 @@ solution (SOLUTION_NAME)
 		"SPARTAN_RUNTIME_SHARED=0"
 	}
 	
+	if _OPTIONS["math-simd"] then
+		defines { "SPARTAN_MATH_SIMD" }
+	end
+	
 	filter { "platforms:x64" }
 		system "Windows"
 		architecture "x64"
@@ -198,6 +214,75 @@ project (EDITOR_NAME)
 		debugdir (TARGET_DIR_DEBUG)
 		debugformat (DEBUG_FORMAT)		
 				
+	-- "Release"
+	filter "configurations:Release"
+		targetdir (TARGET_DIR_RELEASE)
+		debugdir (TARGET_DIR_RELEASE)
+
+-- Math tests ----------------------------------------------------------------------------------------------
+-- Tolerance tests and benchmarks of Runtime/Math, generate with and without --math-simd to test both backends
+project (MATH_TESTS_NAME)
+	location (MATH_TESTS_DIR)
+	objdir (INTERMEDIATE_DIR)
+	kind "ConsoleApp"
+	staticruntime "On"
+	
+	-- Files
+	files
+	{
+		MATH_TESTS_DIR .. "/**.h",
+		MATH_TESTS_DIR .. "/**.cpp",
+		RUNTIME_DIR .. "/Math/Matrix.cpp",
+		RUNTIME_DIR .. "/Math/Quaternion.cpp",
+		RUNTIME_DIR .. "/Math/Vector2.cpp",
+		RUNTIME_DIR .. "/Math/Vector3.cpp",
+		RUNTIME_DIR .. "/Math/Vector4.cpp",
+		RUNTIME_DIR .. "/Math/Plane.cpp",
+		RUNTIME_DIR .. "/Math/BoundingBox.cpp",
+		RUNTIME_DIR .. "/Math/Frustum.cpp",
+		RUNTIME_DIR .. "/Math/Ray.cpp",
+		RUNTIME_DIR .. "/Math/AabbTree.cpp"
+	}
+	
+	-- Includes (the tests have their own Spartan.h, so that the math sources build without the rest of the engine)
+	includedirs { MATH_TESTS_DIR }
+	
+	-- "Debug"
+	filter "configurations:Debug"
+		targetdir (TARGET_DIR_DEBUG)
+		debugdir (TARGET_DIR_DEBUG)
+		debugformat (DEBUG_FORMAT)
+		
+	-- "Release"
+	filter "configurations:Release"
+		targetdir (TARGET_DIR_RELEASE)
+		debugdir (TARGET_DIR_RELEASE)
+
+-- Threading tests -----------------------------------------------------------------------------------------
+-- Tests of the job system and a benchmark against the locked queue it replaced, run with --benchmark
+project (THREADING_TESTS_NAME)
+	location (THREADING_TESTS_DIR)
+	objdir (INTERMEDIATE_DIR)
+	kind "ConsoleApp"
+	staticruntime "On"
+	
+	-- Files
+	files
+	{
+		THREADING_TESTS_DIR .. "/**.h",
+		THREADING_TESTS_DIR .. "/**.cpp",
+		RUNTIME_DIR .. "/Threading/Threading.cpp"
+	}
+	
+	-- Includes (the tests have their own Spartan.h, so that the threading sources build without the rest of the engine)
+	includedirs { THREADING_TESTS_DIR }
+	
+	-- "Debug"
+	filter "configurations:Debug"
+		targetdir (TARGET_DIR_DEBUG)
+		debugdir (TARGET_DIR_DEBUG)
+		debugformat (DEBUG_FORMAT)
+		
 	-- "Release"
 	filter "configurations:Release"
 		targetdir (TARGET_DIR_RELEASE)
@@ -0,0 +1,19 @@
+#!/bin/sh
+# Builds the job system on it's own and runs it's tests. --benchmark also times it against the old locked queue,
+# and times loading files with coroutines against loading them one after the other.
+# Usage: Scripts/threading_tests.sh [--benchmark]    (CXX picks the compiler, default c++)
+
+set -e
+cd "$(dirname "$0")/.."
+
+CXX=${CXX:-c++}
+OUTPUT_DIR="Binaries/ThreadingTests"
+SOURCES="Tests/Threading/*.cpp
+Runtime/Threading/Threading.cpp"
+
+mkdir -p "$OUTPUT_DIR"
+
+echo "Building the threading tests..."
+$CXX -std=c++20 -O2 -pthread -ITests/Threading $SOURCES -o "$OUTPUT_DIR/ThreadingTests"
+
+"$OUTPUT_DIR/ThreadingTests" "$@"
@@ -0,0 +1,63 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ===========
+#include "Spartan.h"
+#include "Tests.h"
+#include <cstring>
+#include <cstdlib>
+//======================
+
+//= NAMESPACES ==========
+using namespace std;
+using namespace Spartan;
+//=======================
+
+// Usage: MathTests [--benchmark] [--seed <seed>]
+// Build it with and without --math-simd, both builds have to pass the same tolerances.
+int main(int argc, char** argv)
+{
+    bool benchmark  = false;
+    uint32_t seed   = 1;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--benchmark") == 0)
+        {
+            benchmark = true;
+        }
+        else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc)
+        {
+            seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+        }
+    }
+
+    printf("Math backend: %s\n", Tests::GetMathBackendName());
+
+    if (!Tests::RunMathTests(seed))
+        return 1;
+
+    if (benchmark)
+    {
+        Tests::RunMathBenchmarks();
+    }
+
+    return 0;
+}
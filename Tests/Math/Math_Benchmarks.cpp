@@ -0,0 +1,303 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ===========
+#include "Spartan.h"
+#include "Tests.h"
+#include <chrono>
+#include <random>
+#include <vector>
+//======================
+
+//= NAMESPACES ===============
+using namespace std;
+using namespace Spartan::Math;
+//============================
+
+namespace Spartan::Tests
+{
+    namespace
+    {
+        // Keeps the optimizer from removing work whose result is never read
+        volatile float g_sink = 0.0f;
+
+        // Runs the function until enough time has passed, prints the best time per item out of a few runs
+        template <typename Function>
+        void Benchmark(const char* name, const uint32_t items_per_run, Function&& function)
+        {
+            using clock = chrono::high_resolution_clock;
+
+            double best_ns = numeric_limits<double>::max();
+            for (uint32_t run = 0; run < 5; run++)
+            {
+                uint32_t repetitions = 0;
+                const auto start     = clock::now();
+                auto elapsed         = clock::duration::zero();
+                while (elapsed < chrono::milliseconds(50))
+                {
+                    function();
+                    repetitions++;
+                    elapsed = clock::now() - start;
+                }
+
+                const double ns = chrono::duration<double, nano>(elapsed).count() / (static_cast<double>(repetitions) * items_per_run);
+                best_ns         = min(best_ns, ns);
+            }
+
+            printf("%-40s %8.2f ns\n", name, best_ns);
+        }
+
+        // For the slow ones, the best time of a few runs in milliseconds
+        template <typename Function>
+        double TimeMs(Function&& function)
+        {
+            double best_ms = numeric_limits<double>::max();
+            for (uint32_t run = 0; run < 3; run++)
+            {
+                const auto start = chrono::high_resolution_clock::now();
+                function();
+                best_ms = min(best_ms, chrono::duration<double, milli>(chrono::high_resolution_clock::now() - start).count());
+            }
+            return best_ms;
+        }
+
+        // The tree at different scales, next to testing every box (which is what culling and picking did before it)
+        void BenchmarkAabbTree()
+        {
+            printf("\nAabbTree scaling (%s, best of 3 runs):\n", GetMathBackendName());
+            printf("%-10s %14s %14s %16s %16s %16s %16s\n", "objects", "insert (ns)", "update (ns)", "frustum (us)", "every box (us)", "ray (us)", "every box (us)");
+
+            mt19937 engine(1);
+            for (const uint32_t count : { 1000u, 10000u, 100000u, 1000000u })
+            {
+                // The same density at every scale, so that a view sees a similar part of the world
+                const float spread = 10.0f * cbrt(static_cast<float>(count));
+                uniform_real_distribution<float> position(-spread, spread);
+                uniform_real_distribution<float> size(0.5f, 2.0f);
+
+                vector<BoundingBox> boxes(count);
+                vector<BoundingBox> boxes_moved(count);
+                for (uint32_t i = 0; i < count; i++)
+                {
+                    const Vector3 center = Vector3(position(engine), position(engine), position(engine));
+                    const Vector3 extent = Vector3(size(engine), size(engine), size(engine));
+                    boxes[i]             = BoundingBox(center - extent, center + extent);
+
+                    // Half of them move within their enlarged box, the other half move far enough to be re-inserted
+                    const Vector3 offset = i % 2 == 0 ? Vector3(0.01f) : Vector3(5.0f, 0.0f, 0.0f);
+                    boxes_moved[i]       = BoundingBox(boxes[i].GetMin() + offset, boxes[i].GetMax() + offset);
+                }
+
+                AabbTree tree;
+                vector<uint32_t> proxies(count);
+                const double insert_ms = TimeMs([&]()
+                {
+                    tree.Clear();
+                    for (uint32_t i = 0; i < count; i++)
+                    {
+                        proxies[i] = tree.Insert(boxes[i], &boxes[i]);
+                    }
+                });
+
+                const double update_ms = TimeMs([&]()
+                {
+                    for (uint32_t i = 0; i < count; i++)
+                    {
+                        tree.Update(proxies[i], boxes_moved[i]);
+                    }
+                    for (uint32_t i = 0; i < count; i++)
+                    {
+                        tree.Update(proxies[i], boxes[i]);
+                    }
+                });
+
+                // A camera in the middle of the world, seeing a quarter of it's width
+                const float far_plane   = spread * 0.5f;
+                const Matrix view       = Matrix::CreateLookAtLH(Vector3::Zero, Vector3::Forward, Vector3::Up);
+                const Matrix projection = Matrix::CreatePerspectiveFieldOfViewLH(1.0f, 1.77f, 0.3f, far_plane);
+                const Frustum frustum(view, projection, far_plane);
+
+                uint32_t visible = 0;
+                const double frustum_ms = TimeMs([&]() { visible = 0; tree.Query(frustum, false, [&visible](void*) { visible++; }); });
+                const double frustum_brute_ms = TimeMs([&]()
+                {
+                    uint32_t visible_brute = 0;
+                    for (const BoundingBox& box : boxes)
+                    {
+                        visible_brute += frustum.IsVisible(box.GetCenter(), box.GetExtents());
+                    }
+                    g_sink = static_cast<float>(visible_brute);
+                });
+
+                // A picking ray, from the camera into the world
+                const Ray ray(Vector3::Zero, Vector3(spread, spread * 0.1f, spread));
+                uint32_t hits = 0;
+                const double ray_ms = TimeMs([&]() { hits = 0; tree.Query(ray, [&hits](void*) { hits++; }); });
+                const double ray_brute_ms = TimeMs([&]()
+                {
+                    uint32_t hits_brute = 0;
+                    for (const BoundingBox& box : boxes)
+                    {
+                        hits_brute += ray.HitDistance(box) != Helper::INFINITY_;
+                    }
+                    g_sink = static_cast<float>(hits_brute);
+                });
+
+                printf("%-10u %14.1f %14.1f %16.1f %16.1f %16.1f %16.1f\n", count,
+                    insert_ms * 1e6 / count, update_ms * 1e6 / (2.0 * count), frustum_ms * 1e3, frustum_brute_ms * 1e3, ray_ms * 1e3, ray_brute_ms * 1e3);
+                g_sink = static_cast<float>(visible + hits);
+            }
+        }
+    }
+
+    void RunMathBenchmarks()
+    {
+        printf("\nBenchmarks (%s, time per item):\n", GetMathBackendName());
+
+        const uint32_t count = 4096;
+        mt19937 engine(1);
+        uniform_real_distribution<float> distribution(-10.0f, 10.0f);
+        const auto random_vector = [&]() { return Vector3(distribution(engine), distribution(engine), distribution(engine)); };
+
+        vector<Vector3> translations(count);
+        vector<Quaternion> rotations(count);
+        vector<Vector3> scales(count);
+        vector<Vector3> centers(count);
+        vector<Vector3> extents(count);
+        vector<Matrix> matrices(count);
+        vector<Matrix> out(count);
+        vector<float> centers_soa[3];
+        vector<float> extents_soa[3];
+        for (uint32_t i = 0; i < count; i++)
+        {
+            translations[i] = random_vector();
+            rotations[i]    = Quaternion::FromEulerAngles(random_vector() * 18.0f);
+            scales[i]       = Vector3(1.0f) + random_vector().Abs() * 0.1f;
+            centers[i]      = random_vector() * 10.0f;
+            extents[i]      = random_vector().Abs();
+            matrices[i]     = Matrix(translations[i], rotations[i], scales[i]);
+
+            for (uint32_t k = 0; k < 3; k++)
+            {
+                centers_soa[k].emplace_back((&centers[i].x)[k]);
+                extents_soa[k].emplace_back((&extents[i].x)[k]);
+            }
+        }
+
+        const Matrix view           = Matrix::CreateLookAtLH(Vector3(0.0f, 10.0f, -50.0f), Vector3::Zero, Vector3::Up);
+        const Matrix projection     = Matrix::CreatePerspectiveFieldOfViewLH(1.0f, 1.77f, 0.3f, 500.0f);
+        const Matrix view_projection = view * projection;
+        const Frustum frustum(view, projection, 500.0f);
+
+        Benchmark("Matrix * Matrix", count, [&]()
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                out[i] = matrices[i] * view_projection;
+            }
+            g_sink = out[count - 1].m00;
+        });
+
+        Benchmark("Matrix::MultiplyBatch", count, [&]()
+        {
+            Matrix::MultiplyBatch(matrices.data(), view_projection, out.data(), count);
+            g_sink = out[count - 1].m00;
+        });
+
+        Benchmark("Matrix(translation, rotation, scale)", count, [&]()
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                out[i] = Matrix(translations[i], rotations[i], scales[i]);
+            }
+            g_sink = out[count - 1].m00;
+        });
+
+        Benchmark("Matrix::ComposeBatch", count, [&]()
+        {
+            Matrix::ComposeBatch(translations.data(), rotations.data(), scales.data(), out.data(), count);
+            g_sink = out[count - 1].m00;
+        });
+
+        Benchmark("Matrix::Invert", count, [&]()
+        {
+            for (uint32_t i = 0; i < count; i++)
+            {
+                out[i] = Matrix::Invert(matrices[i]);
+            }
+            g_sink = out[count - 1].m00;
+        });
+
+        Benchmark("Quaternion * Vector3", count, [&]()
+        {
+            float sum = 0.0f;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                sum += (rotations[i] * centers[i]).x;
+            }
+            g_sink = sum;
+        });
+
+        Benchmark("BoundingBox::Transform", count, [&]()
+        {
+            float sum = 0.0f;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                sum += BoundingBox(centers[i] - extents[i], centers[i] + extents[i]).Transform(matrices[i]).GetMin().x;
+            }
+            g_sink = sum;
+        });
+
+        Benchmark("Frustum::CheckCube", count, [&]()
+        {
+            uint32_t visible = 0;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                visible += frustum.CheckCube(centers[i], extents[i]) != Outside;
+            }
+            g_sink = static_cast<float>(visible);
+        });
+
+        Benchmark("Frustum::IsVisible", count, [&]()
+        {
+            uint32_t visible = 0;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                visible += frustum.IsVisible(centers[i], extents[i]);
+            }
+            g_sink = static_cast<float>(visible);
+        });
+
+        Benchmark("Frustum::IsVisible (64 boxes at a time)", count, [&]()
+        {
+            uint64_t visible = 0;
+            for (uint32_t i = 0; i < count; i += 64)
+            {
+                const float* const center[3] = { centers_soa[0].data() + i, centers_soa[1].data() + i, centers_soa[2].data() + i };
+                const float* const extent[3] = { extents_soa[0].data() + i, extents_soa[1].data() + i, extents_soa[2].data() + i };
+                visible ^= frustum.IsVisible(center, extent, 64);
+            }
+            g_sink = static_cast<float>(visible);
+        });
+
+        BenchmarkAabbTree();
+    }
+}
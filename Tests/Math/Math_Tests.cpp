@@ -0,0 +1,687 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ===========
+#include "Spartan.h"
+#include "Tests.h"
+#include <cmath>
+#include <cfloat>
+#include <functional>
+#include <random>
+#include <vector>
+//======================
+
+//= NAMESPACES ===============
+using namespace std;
+using namespace Spartan::Math;
+//============================
+
+namespace Spartan::Tests
+{
+    namespace
+    {
+        // Errors are measured in units of FLT_EPSILON, relative to the magnitude of the terms which produced the value.
+        // That's the error a float computation is expected to have, regardless of how the terms are grouped or vectorized.
+        class Tolerance
+        {
+        public:
+            Tolerance(const char* name, const double tolerance_ulps)
+            {
+                m_name              = name;
+                m_tolerance_ulps    = tolerance_ulps;
+            }
+
+            void Check(const double value, const double reference, const double magnitude)
+            {
+                const double error = fabs(value - reference) / (max(magnitude, static_cast<double>(FLT_MIN)) * FLT_EPSILON);
+                m_error_max_ulps   = max(m_error_max_ulps, isfinite(value) ? error : numeric_limits<double>::infinity());
+            }
+
+            // Prints the result and returns true if it's within tolerance
+            bool Report() const
+            {
+                const bool passed = m_error_max_ulps <= m_tolerance_ulps;
+                printf("%s %-40s max error %8.3f ulps, tolerance %6.1f ulps\n", passed ? "[PASS]" : "[FAIL]", m_name, m_error_max_ulps, m_tolerance_ulps);
+                return passed;
+            }
+
+        private:
+            const char* m_name          = nullptr;
+            double m_tolerance_ulps     = 0.0;
+            double m_error_max_ulps     = 0.0;
+        };
+
+        struct Matrix64
+        {
+            Matrix64() = default;
+            Matrix64(const Matrix& matrix)
+            {
+                m[0][0] = matrix.m00; m[0][1] = matrix.m01; m[0][2] = matrix.m02; m[0][3] = matrix.m03;
+                m[1][0] = matrix.m10; m[1][1] = matrix.m11; m[1][2] = matrix.m12; m[1][3] = matrix.m13;
+                m[2][0] = matrix.m20; m[2][1] = matrix.m21; m[2][2] = matrix.m22; m[2][3] = matrix.m23;
+                m[3][0] = matrix.m30; m[3][1] = matrix.m31; m[3][2] = matrix.m32; m[3][3] = matrix.m33;
+            }
+
+            Matrix64 operator*(const Matrix64& rhs) const
+            {
+                Matrix64 result;
+                for (uint32_t r = 0; r < 4; r++)
+                {
+                    for (uint32_t c = 0; c < 4; c++)
+                    {
+                        result.m[r][c] = m[r][0] * rhs.m[0][c] + m[r][1] * rhs.m[1][c] + m[r][2] * rhs.m[2][c] + m[r][3] * rhs.m[3][c];
+                    }
+                }
+                return result;
+            }
+
+            // Gauss-Jordan with partial pivoting
+            Matrix64 Inverted() const
+            {
+                Matrix64 a = *this;
+                Matrix64 result;
+                for (uint32_t i = 0; i < 4; i++)
+                {
+                    result.m[i][i] = 1.0;
+                }
+
+                for (uint32_t c = 0; c < 4; c++)
+                {
+                    uint32_t pivot = c;
+                    for (uint32_t r = c + 1; r < 4; r++)
+                    {
+                        if (fabs(a.m[r][c]) > fabs(a.m[pivot][c]))
+                        {
+                            pivot = r;
+                        }
+                    }
+                    swap(a.m[c], a.m[pivot]);
+                    swap(result.m[c], result.m[pivot]);
+
+                    const double scale = 1.0 / a.m[c][c];
+                    for (uint32_t k = 0; k < 4; k++)
+                    {
+                        a.m[c][k]      *= scale;
+                        result.m[c][k] *= scale;
+                    }
+
+                    for (uint32_t r = 0; r < 4; r++)
+                    {
+                        if (r == c)
+                            continue;
+
+                        const double factor = a.m[r][c];
+                        for (uint32_t k = 0; k < 4; k++)
+                        {
+                            a.m[r][k]      -= factor * a.m[c][k];
+                            result.m[r][k] -= factor * result.m[c][k];
+                        }
+                    }
+                }
+
+                return result;
+            }
+
+            // The largest absolute row sum
+            double Norm() const
+            {
+                double norm = 0.0;
+                for (const auto& row : m)
+                {
+                    norm = max(norm, fabs(row[0]) + fabs(row[1]) + fabs(row[2]) + fabs(row[3]));
+                }
+                return norm;
+            }
+
+            double m[4][4] = {};
+        };
+
+        // Same as Matrix(translation, rotation, scale), in double precision
+        Matrix64 Compose64(const Vector3& t, const Quaternion& q, const Vector3& s)
+        {
+            const double x = q.x, y = q.y, z = q.z, w = q.w;
+
+            Matrix64 result;
+            result.m[0][0] = s.x * (1.0 - 2.0 * (y * y + z * z)); result.m[0][1] = s.x * 2.0 * (x * y + z * w);         result.m[0][2] = s.x * 2.0 * (z * x - y * w);
+            result.m[1][0] = s.y * 2.0 * (x * y - z * w);         result.m[1][1] = s.y * (1.0 - 2.0 * (z * z + x * x)); result.m[1][2] = s.y * 2.0 * (y * z + x * w);
+            result.m[2][0] = s.z * 2.0 * (z * x + y * w);         result.m[2][1] = s.z * 2.0 * (y * z - x * w);         result.m[2][2] = s.z * (1.0 - 2.0 * (y * y + x * x));
+            result.m[3][0] = t.x;                                 result.m[3][1] = t.y;                                 result.m[3][2] = t.z;
+            result.m[3][3] = 1.0;
+            return result;
+        }
+
+        class Random
+        {
+        public:
+            Random(const uint32_t seed) : m_engine(seed) {}
+
+            float Float(const float min, const float max) { return uniform_real_distribution<float>(min, max)(m_engine); }
+            Vector3 Vector(const float min, const float max) { return Vector3(Float(min, max), Float(min, max), Float(min, max)); }
+
+            Quaternion Rotation()
+            {
+                normal_distribution<float> normal;
+                Quaternion q(normal(m_engine), normal(m_engine), normal(m_engine), normal(m_engine));
+                q.Normalize();
+                return q;
+            }
+
+            Matrix Trs()
+            {
+                const Vector3 scale = Vector(0.5f, 2.0f);
+                return Matrix(Vector(-100.0f, 100.0f), Rotation(), scale);
+            }
+
+            Matrix Any()
+            {
+                Matrix matrix;
+                float* data = &matrix.m00;
+                for (uint32_t i = 0; i < 16; i++)
+                {
+                    data[i] = Float(-10.0f, 10.0f);
+                }
+                return matrix;
+            }
+
+        private:
+            mt19937 m_engine;
+        };
+
+        constexpr uint32_t iterations = 100000;
+
+        bool TestMultiply(Random& random)
+        {
+            Tolerance tolerance_single("Matrix * Matrix", 4.0);
+            Tolerance tolerance_batch("Matrix::MultiplyBatch", 4.0);
+
+            const uint32_t batch_size = 61; // not a multiple of any lane count, so the tails run too
+            vector<Matrix> lhs(batch_size);
+            vector<Matrix> out(batch_size);
+            for (uint32_t i = 0; i < iterations / batch_size; i++)
+            {
+                const Matrix rhs = random.Any();
+                for (Matrix& matrix : lhs)
+                {
+                    matrix = random.Any();
+                }
+                Matrix::MultiplyBatch(lhs.data(), rhs, out.data(), batch_size);
+
+                const Matrix64 b(rhs);
+                for (uint32_t j = 0; j < batch_size; j++)
+                {
+                    const Matrix64 a(lhs[j]);
+                    const Matrix64 single(lhs[j] * rhs);
+                    const Matrix64 batch(out[j]);
+
+                    for (uint32_t r = 0; r < 4; r++)
+                    {
+                        for (uint32_t c = 0; c < 4; c++)
+                        {
+                            double reference = 0.0;
+                            double magnitude = 0.0;
+                            for (uint32_t k = 0; k < 4; k++)
+                            {
+                                reference += a.m[r][k] * b.m[k][c];
+                                magnitude += fabs(a.m[r][k] * b.m[k][c]);
+                            }
+
+                            tolerance_single.Check(single.m[r][c], reference, magnitude);
+                            tolerance_batch.Check(batch.m[r][c], reference, magnitude);
+                        }
+                    }
+                }
+            }
+
+            const bool passed_single = tolerance_single.Report();
+            const bool passed_batch  = tolerance_batch.Report();
+            return passed_single && passed_batch;
+        }
+
+        bool TestCompose(Random& random)
+        {
+            Tolerance tolerance_single("Matrix(translation, rotation, scale)", 8.0);
+            Tolerance tolerance_batch("Matrix::ComposeBatch", 8.0);
+            Tolerance tolerance_equal("Matrix::ComposeBatch vs Matrix(t, r, s)", 0.0); // the same terms, so it's exact
+
+            const uint32_t batch_size = 61;
+            vector<Vector3> translations(batch_size);
+            vector<Quaternion> rotations(batch_size);
+            vector<Vector3> scales(batch_size);
+            vector<Matrix> out(batch_size);
+            for (uint32_t i = 0; i < iterations / batch_size; i++)
+            {
+                for (uint32_t j = 0; j < batch_size; j++)
+                {
+                    translations[j] = random.Vector(-100.0f, 100.0f);
+                    rotations[j]    = random.Rotation();
+                    scales[j]       = random.Vector(-2.0f, 2.0f);
+                }
+                Matrix::ComposeBatch(translations.data(), rotations.data(), scales.data(), out.data(), batch_size);
+
+                for (uint32_t j = 0; j < batch_size; j++)
+                {
+                    const Matrix64 reference = Compose64(translations[j], rotations[j], scales[j]);
+                    const Matrix64 single(Matrix(translations[j], rotations[j], scales[j]));
+                    const Matrix64 batch(out[j]);
+                    const float scale[4] = { scales[j].x, scales[j].y, scales[j].z, 1.0f };
+
+                    for (uint32_t r = 0; r < 4; r++)
+                    {
+                        for (uint32_t c = 0; c < 4; c++)
+                        {
+                            // The rotation part is at most one, scaled by the row's scale
+                            const double magnitude = r < 3 ? fabs(scale[r]) : max(fabs(reference.m[r][c]), 1.0);
+                            tolerance_single.Check(single.m[r][c], reference.m[r][c], magnitude);
+                            tolerance_batch.Check(batch.m[r][c], reference.m[r][c], magnitude);
+                            tolerance_equal.Check(batch.m[r][c], single.m[r][c], magnitude);
+                        }
+                    }
+                }
+            }
+
+            const bool passed_single = tolerance_single.Report();
+            const bool passed_batch  = tolerance_batch.Report();
+            const bool passed_equal  = tolerance_equal.Report();
+            return passed_single && passed_batch && passed_equal;
+        }
+
+        bool TestInvert(Random& random)
+        {
+            // The error of an inverse grows with the condition of the matrix, which is large for projections. So the affine
+            // inverses are compared to the reference, and for all of them M * M^-1 has to be the identity, relative to |M| |M^-1|.
+            Tolerance tolerance_affine("Matrix::Invert (affine)", 8.0);
+            Tolerance tolerance_residual_affine("Matrix::Invert (affine, M * M^-1)", 4.0);
+            Tolerance tolerance_residual_projection("Matrix::Invert (projection, M * M^-1)", 4.0);
+
+            for (uint32_t i = 0; i < iterations; i++)
+            {
+                const bool projection = i & 1;
+                Matrix matrix = random.Trs();
+                if (projection)
+                {
+                    matrix = matrix * Matrix::CreatePerspectiveFieldOfViewLH(random.Float(0.5f, 2.0f), random.Float(0.5f, 2.0f), random.Float(0.1f, 1.0f), random.Float(100.0f, 1000.0f));
+                }
+
+                const Matrix64 matrix_64(matrix);
+                const Matrix64 inverse(Matrix::Invert(matrix));
+                const Matrix64 residual     = matrix_64 * inverse;
+                const double magnitude      = matrix_64.Norm() * inverse.Norm();
+
+                Tolerance& tolerance_residual = projection ? tolerance_residual_projection : tolerance_residual_affine;
+                for (uint32_t r = 0; r < 4; r++)
+                {
+                    for (uint32_t c = 0; c < 4; c++)
+                    {
+                        tolerance_residual.Check(residual.m[r][c], r == c ? 1.0 : 0.0, magnitude);
+                    }
+                }
+
+                if (!projection)
+                {
+                    const Matrix64 reference = matrix_64.Inverted();
+                    for (uint32_t r = 0; r < 4; r++)
+                    {
+                        for (uint32_t c = 0; c < 4; c++)
+                        {
+                            tolerance_affine.Check(inverse.m[r][c], reference.m[r][c], reference.Norm());
+                        }
+                    }
+                }
+            }
+
+            const bool passed_affine               = tolerance_affine.Report();
+            const bool passed_residual_affine      = tolerance_residual_affine.Report();
+            const bool passed_residual_projection  = tolerance_residual_projection.Report();
+            return passed_affine && passed_residual_affine && passed_residual_projection;
+        }
+
+        bool TestRotate(Random& random)
+        {
+            Tolerance tolerance("Quaternion * Vector3", 8.0);
+
+            for (uint32_t i = 0; i < iterations; i++)
+            {
+                const Quaternion q = random.Rotation();
+                const Vector3 v    = random.Vector(-100.0f, 100.0f);
+                const Vector3 result = q * v;
+
+                // v + 2w(q x v) + 2q x (q x v)
+                const double qx = q.x, qy = q.y, qz = q.z, qw = q.w;
+                const double vx = v.x, vy = v.y, vz = v.z;
+                const double c1x = qy * vz - qz * vy, c1y = qz * vx - qx * vz, c1z = qx * vy - qy * vx;
+                const double c2x = qy * c1z - qz * c1y, c2y = qz * c1x - qx * c1z, c2z = qx * c1y - qy * c1x;
+                const double magnitude = sqrt(vx * vx + vy * vy + vz * vz);
+
+                tolerance.Check(result.x, vx + 2.0 * (qw * c1x + c2x), magnitude);
+                tolerance.Check(result.y, vy + 2.0 * (qw * c1y + c2y), magnitude);
+                tolerance.Check(result.z, vz + 2.0 * (qw * c1z + c2z), magnitude);
+            }
+
+            return tolerance.Report();
+        }
+
+        bool TestBoundingBoxTransform(Random& random)
+        {
+            Tolerance tolerance("BoundingBox::Transform", 8.0);
+
+            for (uint32_t i = 0; i < iterations; i++)
+            {
+                const Vector3 center        = random.Vector(-100.0f, 100.0f);
+                const Vector3 extent        = random.Vector(0.0f, 50.0f);
+                const BoundingBox box       = BoundingBox(center - extent, center + extent);
+                const Matrix transform      = random.Trs();
+                const BoundingBox result    = box.Transform(transform);
+
+                const Matrix64 m(transform);
+                const Vector3& box_min  = box.GetMin();
+                const Vector3& box_max  = box.GetMax();
+                const double c[3]       = { (0.5 * box_min.x + 0.5 * box_max.x), (0.5 * box_min.y + 0.5 * box_max.y), (0.5 * box_min.z + 0.5 * box_max.z) };
+                const double e[3]       = { (0.5 * box_max.x - 0.5 * box_min.x), (0.5 * box_max.y - 0.5 * box_min.y), (0.5 * box_max.z - 0.5 * box_min.z) };
+                const float min[3]      = { result.GetMin().x, result.GetMin().y, result.GetMin().z };
+                const float max[3]      = { result.GetMax().x, result.GetMax().y, result.GetMax().z };
+                for (uint32_t j = 0; j < 3; j++)
+                {
+                    double center_new   = m.m[3][j];
+                    double extent_new   = 0.0;
+                    double magnitude    = fabs(m.m[3][j]);
+                    for (uint32_t k = 0; k < 3; k++)
+                    {
+                        center_new += c[k] * m.m[k][j];
+                        extent_new += e[k] * fabs(m.m[k][j]);
+                        magnitude  += fabs(c[k] * m.m[k][j]) + e[k] * fabs(m.m[k][j]);
+                    }
+
+                    tolerance.Check(min[j], center_new - extent_new, magnitude);
+                    tolerance.Check(max[j], center_new + extent_new, magnitude);
+                }
+            }
+
+            return tolerance.Report();
+        }
+
+        bool TestFrustum(Random& random)
+        {
+            // Visibility is a yes or no answer, so boxes which touch a plane (within float error) are skipped,
+            // either answer is right for them. Everything else has to match the reference exactly.
+            uint32_t mismatches_single  = 0;
+            uint32_t mismatches_batch   = 0;
+            uint32_t mismatches_cube    = 0;
+            uint32_t boxes_tested       = 0;
+
+            const uint32_t frustum_count = 200;
+            const uint32_t box_count     = 64 * 8;
+            for (uint32_t f = 0; f < frustum_count; f++)
+            {
+                const Vector3 eye       = random.Vector(-50.0f, 50.0f);
+                const Vector3 target    = eye + random.Vector(-10.0f, 10.0f);
+                const float far_plane   = random.Float(100.0f, 1000.0f);
+                const Matrix view       = Matrix::CreateLookAtLH(eye, target, Vector3::Up);
+                const Matrix projection = Matrix::CreatePerspectiveFieldOfViewLH(random.Float(0.5f, 2.0f), random.Float(0.5f, 2.0f), random.Float(0.1f, 1.0f), far_plane);
+                const Frustum frustum(view, projection, far_plane);
+
+                // The planes, the same way the frustum computes them
+                double planes[6][4];
+                {
+                    const double z_min  = -static_cast<double>(projection.m32) / projection.m22;
+                    const double r      = far_plane / (far_plane - z_min);
+                    Matrix64 projection_updated(projection);
+                    projection_updated.m[2][2] = r;
+                    projection_updated.m[3][2] = -r * z_min;
+                    const Matrix64 vp = Matrix64(view) * projection_updated;
+
+                    const int column[6] = { 2, 2, 0, 0, 1, 1 };
+                    const double sign[6] = { 1.0, -1.0, 1.0, -1.0, -1.0, 1.0 };
+                    for (uint32_t p = 0; p < 6; p++)
+                    {
+                        for (uint32_t k = 0; k < 4; k++)
+                        {
+                            planes[p][k] = vp.m[k][3] + sign[p] * vp.m[k][column[p]];
+                        }
+                        const double length = sqrt(planes[p][0] * planes[p][0] + planes[p][1] * planes[p][1] + planes[p][2] * planes[p][2]);
+                        for (double& value : planes[p])
+                        {
+                            value /= length;
+                        }
+                    }
+                }
+
+                vector<float> centers[3];
+                vector<float> extents[3];
+                for (uint32_t k = 0; k < 3; k++)
+                {
+                    centers[k].resize(box_count);
+                    extents[k].resize(box_count);
+                }
+                for (uint32_t i = 0; i < box_count; i++)
+                {
+                    const Vector3 center = eye + random.Vector(-far_plane, far_plane) * 0.5f;
+                    const Vector3 extent = random.Vector(0.1f, 50.0f);
+                    centers[0][i] = center.x; centers[1][i] = center.y; centers[2][i] = center.z;
+                    extents[0][i] = extent.x; extents[1][i] = extent.y; extents[2][i] = extent.z;
+                }
+
+                for (uint32_t ignore_near_plane = 0; ignore_near_plane < 2; ignore_near_plane++)
+                {
+                    for (uint32_t first = 0; first < box_count; first += 64)
+                    {
+                        const float* const center_soa[3] = { centers[0].data() + first, centers[1].data() + first, centers[2].data() + first };
+                        const float* const extent_soa[3] = { extents[0].data() + first, extents[1].data() + first, extents[2].data() + first };
+                        const uint64_t visible_batch = frustum.IsVisible(center_soa, extent_soa, 64, ignore_near_plane != 0);
+
+                        for (uint32_t i = first; i < first + 64; i++)
+                        {
+                            const Vector3 center(centers[0][i], centers[1][i], centers[2][i]);
+                            const Vector3 extent(extents[0][i], extents[1][i], extents[2][i]);
+
+                            bool outside        = false;
+                            bool intersects     = false;
+                            bool outside_far    = false;
+                            bool intersects_far = false;
+                            bool borderline     = false;
+                            for (uint32_t p = 0; p < 6; p++)
+                            {
+                                const double d          = center.x * planes[p][0] + center.y * planes[p][1] + center.z * planes[p][2] + planes[p][3];
+                                const double r          = extent.x * fabs(planes[p][0]) + extent.y * fabs(planes[p][1]) + extent.z * fabs(planes[p][2]);
+                                const double magnitude  = fabs(center.x * planes[p][0]) + fabs(center.y * planes[p][1]) + fabs(center.z * planes[p][2]) + fabs(planes[p][3]) + r;
+                                const double margin     = 1e-4 * magnitude; // the planes themselves are computed in float
+
+                                borderline      = borderline || fabs(d + r) < margin || fabs(d - r) < margin;
+                                outside         = outside || d + r < 0.0;
+                                intersects      = intersects || d - r < 0.0;
+                                outside_far     = outside_far || (p != 0 && d + r < 0.0);
+                                intersects_far  = intersects_far || (p != 0 && d - r < 0.0);
+                            }
+
+                            if (borderline)
+                                continue;
+
+                            const bool visible = !(ignore_near_plane ? outside_far : outside);
+                            mismatches_single += frustum.IsVisible(center, extent, ignore_near_plane != 0) != visible;
+                            mismatches_batch  += ((visible_batch >> (i - first)) & 1) != static_cast<uint64_t>(visible);
+                            boxes_tested++;
+
+                            const Intersection expected = ignore_near_plane ?
+                                (outside_far ? Outside : (intersects_far ? Intersects : Inside)) :
+                                (outside ? Outside : (intersects ? Intersects : Inside));
+                            mismatches_cube += frustum.CheckCube(center, extent, ignore_near_plane != 0) != expected;
+                        }
+                    }
+                }
+            }
+
+            const bool passed = mismatches_single == 0 && mismatches_batch == 0 && mismatches_cube == 0;
+            printf("%s %-40s %u mismatches single, %u batch, %u CheckCube, out of %u boxes\n", passed ? "[PASS]" : "[FAIL]", "Frustum::IsVisible/CheckCube", mismatches_single, mismatches_batch, mismatches_cube, boxes_tested);
+            return passed;
+        }
+
+        // What the tree's queries have to return, the objects whose box passes the query's own test
+        template <typename Test>
+        uint32_t AabbTreeMismatches(const AabbTree& tree, const vector<BoundingBox>& boxes, const vector<bool>& alive, Test&& test, const function<void(vector<uint32_t>&)>& query)
+        {
+            vector<uint32_t> hits(boxes.size(), 0);
+            query(hits);
+
+            uint32_t mismatches = 0;
+            for (uint32_t i = 0; i < boxes.size(); i++)
+            {
+                // Reported exactly once if it passes, never if it doesn't (or if it was removed)
+                const uint32_t expected = alive[i] && test(boxes[i]) ? 1 : 0;
+                mismatches += hits[i] != expected;
+            }
+            return mismatches;
+        }
+
+        bool TestAabbTree(Random& random)
+        {
+            AabbTree tree;
+            vector<BoundingBox> boxes;
+            vector<uint32_t> proxies;
+            vector<bool> alive;
+
+            auto random_box = [&random](const float spread)
+            {
+                const Vector3 center = random.Vector(-spread, spread);
+                const Vector3 extent = random.Vector(0.1f, 5.0f);
+                return BoundingBox(center - extent, center + extent);
+            };
+
+            auto insert = [&](const BoundingBox& box)
+            {
+                const uint32_t index = static_cast<uint32_t>(boxes.size());
+                boxes.emplace_back(box);
+                alive.emplace_back(true);
+                proxies.emplace_back(tree.Insert(box, reinterpret_cast<void*>(static_cast<uintptr_t>(index))));
+            };
+
+            // Every query shape against every object, after each change to the tree
+            uint32_t mismatches = 0;
+            uint32_t queries    = 0;
+            auto validate = [&]()
+            {
+                uint32_t alive_count = 0;
+                for (const bool is_alive : alive)
+                {
+                    alive_count += is_alive;
+                }
+                mismatches += tree.GetCount() != alive_count;
+
+                for (uint32_t q = 0; q < 20; q++)
+                {
+                    auto count_hits = [](vector<uint32_t>& hits) { return [&hits](void* user_data) { hits[reinterpret_cast<uintptr_t>(user_data)]++; }; };
+
+                    const BoundingBox box = random_box(200.0f);
+                    mismatches += AabbTreeMismatches(tree, boxes, alive,
+                        [&box](const BoundingBox& object) { return box.IsInside(object) != Outside; },
+                        [&](vector<uint32_t>& hits) { tree.Query(box, count_hits(hits)); });
+
+                    const Vector3 center = random.Vector(-200.0f, 200.0f);
+                    const float radius   = random.Float(1.0f, 50.0f);
+                    mismatches += AabbTreeMismatches(tree, boxes, alive,
+                        [&center, radius](const BoundingBox& object)
+                        {
+                            const Vector3 closest = Vector3
+                            (
+                                Helper::Clamp(center.x, object.GetMin().x, object.GetMax().x),
+                                Helper::Clamp(center.y, object.GetMin().y, object.GetMax().y),
+                                Helper::Clamp(center.z, object.GetMin().z, object.GetMax().z)
+                            );
+                            return (closest - center).LengthSquared() <= radius * radius;
+                        },
+                        [&](vector<uint32_t>& hits) { tree.Query(center, radius, count_hits(hits)); });
+
+                    const Vector3 eye               = random.Vector(-200.0f, 200.0f);
+                    const float far_plane           = random.Float(50.0f, 400.0f);
+                    const Matrix view               = Matrix::CreateLookAtLH(eye, eye + random.Vector(-10.0f, 10.0f), Vector3::Up);
+                    const Matrix projection         = Matrix::CreatePerspectiveFieldOfViewLH(random.Float(0.5f, 2.0f), random.Float(0.5f, 2.0f), 0.3f, far_plane);
+                    const Frustum frustum(view, projection, far_plane);
+                    const bool ignore_near_plane    = q % 2 == 1;
+                    mismatches += AabbTreeMismatches(tree, boxes, alive,
+                        [&frustum, ignore_near_plane](const BoundingBox& object) { return frustum.IsVisible(object.GetCenter(), object.GetExtents(), ignore_near_plane); },
+                        [&](vector<uint32_t>& hits) { tree.Query(frustum, ignore_near_plane, count_hits(hits)); });
+
+                    const Ray ray(random.Vector(-200.0f, 200.0f), random.Vector(-200.0f, 200.0f));
+                    mismatches += AabbTreeMismatches(tree, boxes, alive,
+                        [&ray](const BoundingBox& object) { return ray.HitDistance(object) != Helper::INFINITY_; },
+                        [&](vector<uint32_t>& hits) { tree.Query(ray, count_hits(hits)); });
+
+                    queries += 4;
+                }
+            };
+
+            // Insert
+            for (uint32_t i = 0; i < 2000; i++)
+            {
+                insert(random_box(200.0f));
+            }
+            validate();
+
+            // Move, a bit (most stay within their enlarged box) and a lot (they have to be re-inserted)
+            for (uint32_t i = 0; i < boxes.size(); i++)
+            {
+                const Vector3 offset = i % 2 == 0 ? random.Vector(-0.05f, 0.05f) : random.Vector(-100.0f, 100.0f);
+                boxes[i] = BoundingBox(boxes[i].GetMin() + offset, boxes[i].GetMax() + offset);
+                tree.Update(proxies[i], boxes[i]);
+            }
+            validate();
+
+            // Remove every third one, then insert more so that the freed nodes are re-used
+            for (uint32_t i = 0; i < boxes.size(); i += 3)
+            {
+                tree.Remove(proxies[i]);
+                alive[i] = false;
+            }
+            validate();
+
+            for (uint32_t i = 0; i < 1000; i++)
+            {
+                insert(random_box(300.0f));
+            }
+            validate();
+
+            // A balanced tree of n leaves is about log2(n) high
+            const bool balanced = tree.GetHeight() <= 4 * static_cast<uint32_t>(ceil(log2(static_cast<double>(tree.GetCount()))));
+
+            tree.Clear();
+            const bool cleared = tree.GetCount() == 0 && tree.GetHeight() == 0;
+
+            const bool passed = mismatches == 0 && balanced && cleared;
+            printf("%s %-40s %u mismatches in %u queries, height %s, clear %s\n", passed ? "[PASS]" : "[FAIL]", "AabbTree vs brute force", mismatches, queries, balanced ? "ok" : "too high", cleared ? "ok" : "failed");
+            return passed;
+        }
+    }
+
+    bool RunMathTests(const uint32_t seed)
+    {
+        Random random(seed);
+
+        bool passed = true;
+        passed = TestMultiply(random) && passed;
+        passed = TestCompose(random) && passed;
+        passed = TestInvert(random) && passed;
+        passed = TestRotate(random) && passed;
+        passed = TestBoundingBoxTransform(random) && passed;
+        passed = TestFrustum(random) && passed;
+        passed = TestAabbTree(random) && passed;
+
+        printf(passed ? "All math tests passed\n" : "Some math tests failed\n");
+        return passed;
+    }
+}
@@ -0,0 +1,58 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+// Stands in for Runtime/Core/Spartan.h, so that the math sources build without the rest of the engine
+
+//= STD ==================
+#include <string>
+#include <algorithm>
+#include <limits>
+#include <cstdio>
+#include <cstdint>
+#include <assert.h>
+//========================
+
+//= RUNTIME =====================================
+#include "../../Runtime/Math/MathHelper.h"
+#include "../../Runtime/Math/Vector2.h"
+#include "../../Runtime/Math/Vector3.h"
+#include "../../Runtime/Math/Vector4.h"
+#include "../../Runtime/Math/Quaternion.h"
+#include "../../Runtime/Math/Matrix.h"
+#include "../../Runtime/Math/Plane.h"
+#include "../../Runtime/Math/BoundingBox.h"
+#include "../../Runtime/Math/Frustum.h"
+#include "../../Runtime/Math/Ray.h"
+#include "../../Runtime/Math/AabbTree.h"
+//===============================================
+
+#define SPARTAN_ASSERT(expression) assert(expression)
+
+// The ToString() functions use the MSVC only sprintf_s
+#if !defined(_MSC_VER)
+template <size_t size, typename... Args>
+int sprintf_s(char (&buffer)[size], const char* format, Args... args)
+{
+    return snprintf(buffer, size, format, args...);
+}
+#endif
@@ -0,0 +1,63 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES ======
+#include "Spartan.h"
+#include <cstdarg>
+//=================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+// Stands in for Runtime/Logging/Log.cpp, warnings and errors go straight to the console
+
+namespace Spartan
+{
+    namespace
+    {
+        void Print(const char* prefix, const char* text, va_list args)
+        {
+            printf("%s", prefix);
+            vprintf(text, args);
+            printf("\n");
+        }
+    }
+
+    // Dropped, so that the pools created by every test don't clutter the results
+    void Log::WriteFInfo(const string text, ...) {}
+
+    void Log::WriteFWarning(const string text, ...)
+    {
+        va_list args;
+        va_start(args, text);
+        Print("Warning: ", text.c_str(), args);
+        va_end(args);
+    }
+
+    void Log::WriteFError(const string text, ...)
+    {
+        va_list args;
+        va_start(args, text);
+        Print("Error: ", text.c_str(), args);
+        va_end(args);
+    }
+}
@@ -0,0 +1,58 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+#pragma once
+
+// Stands in for Runtime/Core/Spartan.h, so that the threading sources build without the rest of the engine
+
+//= STD ==================
+#include <string>
+#include <fstream>
+#include <algorithm>
+#include <limits>
+#include <cstdio>
+#include <cstdint>
+#include <assert.h>
+//========================
+
+// Log.h only declares it as a friend, which MSVC accepts as a declaration
+namespace Spartan { class ILogger; }
+
+//= RUNTIME ==============================
+#include "../../Runtime/Math/MathHelper.h"
+#include "../../Runtime/Logging/Log.h"
+//========================================
+
+#define SPARTAN_ASSERT(expression) assert(expression)
+
+// The LOG_* macros rely on MSVC dropping the trailing comma when there are no arguments
+#if !defined(_MSC_VER)
+#undef LOG_INFO
+#undef LOG_WARNING
+#undef LOG_ERROR
+#define LOG_INFO(text, ...)     { Spartan::Log::WriteFInfo(std::string(__FUNCTION__)    + ": " + std::string(text) __VA_OPT__(,) __VA_ARGS__); }
+#define LOG_WARNING(text, ...)  { Spartan::Log::WriteFWarning(std::string(__FUNCTION__) + ": " + std::string(text) __VA_OPT__(,) __VA_ARGS__); }
+#define LOG_ERROR(text, ...)    { Spartan::Log::WriteFError(std::string(__FUNCTION__)   + ": " + std::string(text) __VA_OPT__(,) __VA_ARGS__); }
+#endif
+
+//= RUNTIME ==================================
+#include "../../Runtime/Threading/Threading.h"
+//============================================
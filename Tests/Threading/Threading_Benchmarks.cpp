@@ -0,0 +1,308 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =================================
+#include "Spartan.h"
+#include "Tests.h"
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <vector>
+#include "../../Runtime/Threading/Async.h"
+//============================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Spartan::Tests
+{
+    namespace
+    {
+        const uint32_t task_count = 100000;
+
+        // The job system before the work-stealing queues, one locked deque of heap allocated functions
+        class LockedQueuePool
+        {
+        public:
+            LockedQueuePool(const uint32_t thread_count)
+            {
+                for (uint32_t i = 0; i < thread_count; i++)
+                {
+                    m_threads.emplace_back(&LockedQueuePool::ThreadLoop, this);
+                }
+            }
+
+            ~LockedQueuePool()
+            {
+                {
+                    lock_guard<mutex> lock(m_mutex);
+                    m_stopping = true;
+                }
+                m_condition_var.notify_all();
+
+                for (thread& thread : m_threads)
+                {
+                    thread.join();
+                }
+            }
+
+            template <typename Function>
+            void AddTask(Function&& function)
+            {
+                m_pending.fetch_add(1, memory_order_relaxed);
+                {
+                    lock_guard<mutex> lock(m_mutex);
+                    m_tasks.push_back(make_shared<std::function<void()>>(forward<Function>(function)));
+                }
+                m_condition_var.notify_one();
+            }
+
+            void Wait()
+            {
+                while (m_pending.load(memory_order_acquire) != 0)
+                {
+                    this_thread::yield();
+                }
+            }
+
+        private:
+            void ThreadLoop()
+            {
+                while (true)
+                {
+                    shared_ptr<std::function<void()>> task;
+                    {
+                        unique_lock<mutex> lock(m_mutex);
+                        m_condition_var.wait(lock, [this] { return !m_tasks.empty() || m_stopping; });
+                        if (m_tasks.empty())
+                            return;
+
+                        task = m_tasks.front();
+                        m_tasks.pop_front();
+                    }
+
+                    (*task)();
+                    m_pending.fetch_sub(1, memory_order_release);
+                }
+            }
+
+            vector<thread> m_threads;
+            deque<shared_ptr<std::function<void()>>> m_tasks;
+            mutex m_mutex;
+            condition_variable m_condition_var;
+            atomic<uint32_t> m_pending = 0;
+            bool m_stopping = false;
+        };
+
+        // Stands in for a small job, a few hundred nanoseconds of arithmetic
+        void Work(atomic<uint64_t>& sink)
+        {
+            uint64_t value = 0;
+            for (uint32_t i = 0; i < 256; i++)
+            {
+                value = value * 6364136223846793005ull + 1442695040888963407ull;
+            }
+            sink.fetch_add(value & 1, memory_order_relaxed);
+        }
+
+        // Best of a few runs, in nanoseconds per task
+        template <typename Function>
+        double Time(Function&& function)
+        {
+            double best = numeric_limits<double>::max();
+            for (uint32_t run = 0; run < 5; run++)
+            {
+                const auto start = chrono::high_resolution_clock::now();
+                function();
+                const auto end = chrono::high_resolution_clock::now();
+                best = Math::Helper::Min(best, chrono::duration<double, nano>(end - start).count() / task_count);
+            }
+            return best;
+        }
+
+        // A file load, waiting on the disk and then decoding what was read
+        const uint32_t file_count           = 200;
+        const auto file_read_latency        = chrono::microseconds(500);
+        const uint32_t file_decode_work     = 512;
+
+        void ReadFile()
+        {
+            this_thread::sleep_for(file_read_latency);
+        }
+
+        void DecodeFile(atomic<uint64_t>& sink)
+        {
+            for (uint32_t i = 0; i < file_decode_work; i++)
+            {
+                Work(sink);
+            }
+        }
+
+        Async<void> LoadFile(Threading* threading, atomic<uint64_t>& sink)
+        {
+            co_await ScheduleOn(threading, ThreadPool::Io);
+            ReadFile();
+            co_await ScheduleOn(threading, ThreadPool::Compute);
+            DecodeFile(sink);
+        }
+
+        Async<void> LoadFiles(Threading* threading, atomic<uint64_t>& sink)
+        {
+            vector<Async<void>> loads;
+            for (uint32_t i = 0; i < file_count; i++)
+            {
+                loads.emplace_back(LoadFile(threading, sink));
+            }
+            co_await WhenAll(move(loads));
+        }
+
+        // Wall time in milliseconds, best of a few runs
+        template <typename Function>
+        double TimeLoad(Function&& function)
+        {
+            double best = numeric_limits<double>::max();
+            for (uint32_t run = 0; run < 3; run++)
+            {
+                const auto start = chrono::high_resolution_clock::now();
+                function();
+                const auto end = chrono::high_resolution_clock::now();
+                best = Math::Helper::Min(best, chrono::duration<double, milli>(end - start).count());
+            }
+            return best;
+        }
+
+        void RunLoadingBenchmark()
+        {
+            // At least one compute thread, so that the tasks don't run inline
+            Threading threading(nullptr, Math::Helper::Max(thread::hardware_concurrency(), 2u) - 1);
+            atomic<uint64_t> sink = 0;
+
+            // How the resource cache and the world used to load, one file after the other
+            const double blocking = TimeLoad([&sink]()
+            {
+                for (uint32_t i = 0; i < file_count; i++)
+                {
+                    ReadFile();
+                    DecodeFile(sink);
+                }
+            });
+
+            // A task per file, the compute threads sit idle while the disk is read
+            const double tasks = TimeLoad([&threading, &sink]()
+            {
+                for (uint32_t i = 0; i < file_count; i++)
+                {
+                    threading.AddTask([&sink]() { ReadFile(); DecodeFile(sink); });
+                }
+                threading.Flush();
+            });
+
+            // A coroutine per file, reads wait on the I/O threads and decodes run on the compute threads
+            const double async = TimeLoad([&threading, &sink]() { LoadFiles(&threading, sink).Get(); });
+
+            printf("\n%u files taking %lld us to read and %u tasks worth of work to decode, %u compute and %u I/O threads, best of 3 runs, milliseconds (lower is better)\n",
+                file_count, static_cast<long long>(file_read_latency.count()), file_decode_work, threading.GetThreadCount(), threading.GetThreadCountIo());
+            printf("%-8s %14s %14s %14s\n", "", "blocking", "AddTask", "Async");
+            printf("%-8s %14.1f %14.1f %14.1f\n", "load", blocking, tasks, async);
+        }
+    }
+
+    void RunThreadingBenchmarks()
+    {
+        const uint32_t hardware_threads = Math::Helper::Max(thread::hardware_concurrency(), 2u);
+        vector<uint32_t> thread_counts = { 1, 2, 4, 8 };
+        thread_counts.erase(remove_if(thread_counts.begin(), thread_counts.end(), [hardware_threads](const uint32_t count) { return count > hardware_threads - 1; }), thread_counts.end());
+        if (find(thread_counts.begin(), thread_counts.end(), hardware_threads - 1) == thread_counts.end())
+        {
+            thread_counts.emplace_back(hardware_threads - 1);
+        }
+
+        printf("\n%u tasks, best of 5 runs, nanoseconds per task (lower is better)\n", task_count);
+        printf("%-8s %14s %14s %14s %14s\n", "threads", "locked queue", "AddTask", "AddTask nested", "ParallelFor");
+
+        atomic<uint64_t> sink = 0;
+        for (const uint32_t thread_count : thread_counts)
+        {
+            // The old pool, every submit and every pop goes through the same lock
+            double locked_queue = 0.0;
+            {
+                LockedQueuePool pool(thread_count);
+                locked_queue = Time([&pool, &sink]()
+                {
+                    for (uint32_t i = 0; i < task_count; i++)
+                    {
+                        pool.AddTask([&sink]() { Work(sink); });
+                    }
+                    pool.Wait();
+                });
+            }
+
+            Threading threading(nullptr, thread_count);
+
+            // Submitted from the main thread, the tasks go through the injection queue
+            const double add_task = Time([&threading, &sink]()
+            {
+                for (uint32_t i = 0; i < task_count; i++)
+                {
+                    threading.AddTask([&sink]() { Work(sink); });
+                }
+                threading.Flush();
+            });
+
+            // Submitted from a worker, the tasks go to it's own deque and get stolen from there
+            const double add_task_nested = Time([&threading, &sink]()
+            {
+                threading.AddTask([&threading, &sink]()
+                {
+                    vector<TaskHandle> handles;
+                    handles.reserve(task_count);
+                    for (uint32_t i = 0; i < task_count; i++)
+                    {
+                        handles.emplace_back(threading.AddTask([&sink]() { Work(sink); }));
+                    }
+
+                    for (const TaskHandle& handle : handles)
+                    {
+                        threading.Wait(handle);
+                    }
+                });
+                threading.Flush();
+            });
+
+            // One iteration per task, chunked by the default grain size
+            const double parallel_for = Time([&threading, &sink]()
+            {
+                threading.ParallelFor(task_count, [&sink](const uint32_t start, const uint32_t end)
+                {
+                    for (uint32_t i = start; i < end; i++)
+                    {
+                        Work(sink);
+                    }
+                });
+            });
+
+            printf("%-8u %14.1f %14.1f %14.1f %14.1f\n", thread_count, locked_queue, add_task, add_task_nested, parallel_for);
+        }
+
+        RunLoadingBenchmark();
+    }
+}
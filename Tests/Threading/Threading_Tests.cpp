@@ -0,0 +1,244 @@
+/*
+Copyright(c) 2016-2020 Panos Karabelas
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and / or sell
+copies of the Software, and to permit persons to whom the Software is furnished
+to do so, subject to the following conditions :
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.IN NO EVENT SHALL THE AUTHORS OR
+COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+*/
+
+//= INCLUDES =================================
+#include "Spartan.h"
+#include "Tests.h"
+#include <cstdlib>
+#include <vector>
+#include "../../Runtime/Threading/Async.h"
+//============================================
+
+//= NAMESPACES =====
+using namespace std;
+//==================
+
+namespace Spartan::Tests
+{
+    namespace
+    {
+        // Enough threads to interleave, even on machines with fewer cores
+        const uint32_t thread_count = 4;
+
+        // A deadlocked pool can't be shut down, so a test which times out ends the process
+        void WaitOrExit(const vector<TaskHandle>& handles, const char* name)
+        {
+            const auto deadline = chrono::steady_clock::now() + chrono::seconds(30);
+            for (const TaskHandle& handle : handles)
+            {
+                while (!handle.IsDone())
+                {
+                    if (chrono::steady_clock::now() > deadline)
+                    {
+                        printf("[FAIL] %-40s timed out, the pool is deadlocked\n", name);
+                        fflush(stdout);
+                        _Exit(1);
+                    }
+
+                    this_thread::yield();
+                }
+            }
+        }
+
+        bool TestTasks()
+        {
+            Threading threading(nullptr, thread_count);
+
+            // More than fit in a queue's task slots, so submitting has to wait for slots to be recycled
+            const uint32_t count = 20000;
+            atomic<uint32_t> executed = 0;
+            vector<TaskHandle> handles;
+            handles.reserve(count);
+            for (uint32_t i = 0; i < count; i++)
+            {
+                const TaskPriority priority = static_cast<TaskPriority>(i % static_cast<uint32_t>(TaskPriority::Count));
+                handles.emplace_back(threading.AddTask([&executed]() { executed.fetch_add(1, memory_order_relaxed); }, priority));
+            }
+            WaitOrExit(handles, "AddTask");
+
+            const bool passed = executed == count;
+            printf("%s %-40s %u of %u tasks executed\n", passed ? "[PASS]" : "[FAIL]", "AddTask", executed.load(), count);
+            return passed;
+        }
+
+        bool TestParallelFor()
+        {
+            Threading threading(nullptr, thread_count);
+
+            uint32_t loops      = 0;
+            uint32_t failures   = 0;
+            for (const uint32_t range : { 1u, 7u, 64u, 1000u, 100003u })
+            {
+                for (const uint32_t grain_size : { 0u, 1u, 13u, 4096u })
+                {
+                    vector<atomic<uint32_t>> hits(range);
+                    threading.ParallelFor(range, [&hits](const uint32_t start, const uint32_t end)
+                    {
+                        for (uint32_t i = start; i < end; i++)
+                        {
+                            hits[i].fetch_add(1, memory_order_relaxed);
+                        }
+                    }, grain_size);
+
+                    // Every iteration exactly once
+                    failures += any_of(hits.begin(), hits.end(), [](const atomic<uint32_t>& hit) { return hit.load() != 1; });
+                    loops++;
+                }
+            }
+
+            const bool passed = failures == 0;
+            printf("%s %-40s %u of %u loops covered their range exactly once\n", passed ? "[PASS]" : "[FAIL]", "ParallelFor", loops - failures, loops);
+            return passed;
+        }
+
+        bool TestNestedWait()
+        {
+            Threading threading(nullptr, thread_count);
+
+            // Tasks which wait on their own tasks, the workers have to help or they would all end up waiting
+            const uint32_t parent_count = 64;
+            const uint32_t child_count  = 16;
+            atomic<uint32_t> executed   = 0;
+            vector<TaskHandle> parents;
+            for (uint32_t i = 0; i < parent_count; i++)
+            {
+                parents.emplace_back(threading.AddTask([&threading, &executed]()
+                {
+                    TaskHandle children[child_count];
+                    for (TaskHandle& child : children)
+                    {
+                        child = threading.AddTask([&executed]() { executed.fetch_add(1, memory_order_relaxed); });
+                    }
+
+                    for (const TaskHandle& child : children)
+                    {
+                        threading.Wait(child);
+                    }
+                }));
+            }
+            WaitOrExit(parents, "Wait (compute tasks)");
+
+            const bool passed = executed == parent_count * child_count;
+            printf("%s %-40s %u of %u tasks executed\n", passed ? "[PASS]" : "[FAIL]", "Wait (compute tasks)", executed.load(), parent_count * child_count);
+            return passed;
+        }
+
+        bool TestNestedWaitIo()
+        {
+            Threading threading(nullptr, thread_count);
+
+            // More parents than I/O threads, so every I/O thread ends up waiting while children are still queued
+            const uint32_t parent_count = threading.GetThreadCountIo() * 4;
+            const uint32_t child_count  = 8;
+            atomic<uint32_t> executed   = 0;
+            vector<TaskHandle> parents;
+            for (uint32_t i = 0; i < parent_count; i++)
+            {
+                parents.emplace_back(threading.AddTaskIo([&threading, &executed]()
+                {
+                    TaskHandle children[child_count];
+                    for (TaskHandle& child : children)
+                    {
+                        child = threading.AddTaskIo([&executed]() { executed.fetch_add(1, memory_order_relaxed); });
+                    }
+
+                    for (const TaskHandle& child : children)
+                    {
+                        threading.Wait(child);
+                    }
+                }));
+            }
+            WaitOrExit(parents, "Wait (I/O tasks)");
+
+            const bool passed = executed == parent_count * child_count;
+            printf("%s %-40s %u of %u tasks executed\n", passed ? "[PASS]" : "[FAIL]", "Wait (I/O tasks)", executed.load(), parent_count * child_count);
+            return passed;
+        }
+
+        Async<uint32_t> Square(Threading* threading, const uint32_t value)
+        {
+            // Hop through both pools, the way a load reads on one and decodes on the other
+            co_await ScheduleOn(threading, ThreadPool::Io);
+            const uint32_t read = value;
+            co_await ScheduleOn(threading, ThreadPool::Compute);
+            co_return read * read;
+        }
+
+        Async<uint32_t> SumOfSquares(Threading* threading, const uint32_t count)
+        {
+            vector<Async<uint32_t>> squares;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                squares.emplace_back(Square(threading, i));
+            }
+
+            uint32_t sum = 0;
+            for (const uint32_t square : co_await WhenAll(move(squares)))
+            {
+                sum += square;
+            }
+            co_return sum;
+        }
+
+        bool TestAsync()
+        {
+            Threading threading(nullptr, thread_count);
+
+            // Get() from a thread which isn't part of either pool, WhenAll() from a coroutine
+            const uint32_t count    = 256;
+            const uint32_t expected = (count - 1) * count * (2 * count - 1) / 6;
+            uint32_t failures       = 0;
+            for (uint32_t run = 0; run < 100; run++)
+            {
+                failures += SumOfSquares(&threading, count).Get() != expected;
+            }
+
+            // Dropping an Async detaches it, it still has to run to completion
+            atomic<uint32_t> executed = 0;
+            for (uint32_t i = 0; i < count; i++)
+            {
+                [](Threading* threading, atomic<uint32_t>& executed) -> Async<void>
+                {
+                    co_await ScheduleOn(threading, ThreadPool::Io);
+                    executed.fetch_add(1, memory_order_relaxed);
+                }(&threading, executed);
+            }
+            threading.Flush();
+
+            const bool passed = failures == 0 && executed == count;
+            printf("%s %-40s %u of 100 sums correct, %u of %u detached coroutines finished\n", passed ? "[PASS]" : "[FAIL]", "Async", 100 - failures, executed.load(), count);
+            return passed;
+        }
+    }
+
+    bool RunThreadingTests()
+    {
+        bool passed = true;
+        passed = TestTasks() && passed;
+        passed = TestParallelFor() && passed;
+        passed = TestNestedWait() && passed;
+        passed = TestNestedWaitIo() && passed;
+        passed = TestAsync() && passed;
+
+        printf(passed ? "All threading tests passed\n" : "Some threading tests failed\n");
+        return passed;
+    }
+}